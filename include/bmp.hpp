@@ -25,6 +25,7 @@
 #define BMP_HPP
 
 #include <pixels/pixel.hpp>
+#include <pixels/pixelbuffer.hpp>
 #include <params/bmpparams.hpp>
 
 #include <cstddef>
@@ -34,6 +35,8 @@
 
 namespace bmp {
 
+class BmpPyramid;
+
 typedef struct Header {
   uint16_t bmpId;
   uint32_t fileSize;
@@ -51,6 +54,8 @@ typedef struct Header {
   uint32_t printSizeH;
   uint32_t paletteSize;
   uint32_t importantColors;
+  //Rows are stored top to bottom (negative height); height is always positive
+  bool topDown = false;
 } Header;
 
 class Bmp {
@@ -60,32 +65,59 @@ public:
   Bmp(size_t width, size_t height);
   Bmp(const Bmp& bmp);
   Bmp(Bmp* bmp);
-  ~Bmp();
+  virtual ~Bmp();
+  Bmp& operator=(const Bmp& bmp);
   //En/Decoding
-  bool decodeBmp(uint8_t* bmpData, size_t dataSize);
-  uint8_t* encodeBmp(size_t& dataSize);
+  virtual bool decodeBmp(uint8_t* bmpData, size_t dataSize);
+  virtual bool decodeRegion(uint8_t* bmpData, size_t dataSize, size_t xOffset, size_t yOffset, size_t width, size_t height);
+  bool decodeScaled(uint8_t* bmpData, size_t dataSize, size_t width, size_t height);
+  bool decodeScaled(uint8_t* bmpData, size_t dataSize, ScaleFactor factor);
+  virtual uint8_t* encodeBmp(size_t& dataSize);
+  static bool decodeHeader(const uint8_t* bmpData, size_t dataSize, bmp::Header& header);
+  static void encodeHeader(const bmp::Header& header, uint8_t* bmpData);
   //I/O
-  bool readBmp(const std::string& bmpFile);
-  bool writeBmp(const std::string& bmpFile);
+  virtual bool readBmp(const std::string& bmpFile);
+  bool readRegion(const std::string& bmpFile, size_t xOffset, size_t yOffset, size_t width, size_t height);
+  bool readScaled(const std::string& bmpFile, size_t width, size_t height);
+  bool readScaled(const std::string& bmpFile, ScaleFactor factor);
+  virtual bool writeBmp(const std::string& bmpFile);
   //Image operations
-  bool rotate(int degrees);
+  virtual bool rotate(int degrees);
   bool flipVertical();
   bool flipHorizontal();
-  bool resizeArea(size_t width, size_t height, size_t xOffset = 0, size_t yOffset = 0);
-  bool resizeImage(size_t width, size_t height);
+  virtual bool resizeArea(size_t width, size_t height, size_t xOffset = 0, size_t yOffset = 0);
+  virtual bool resizeCanvas(size_t width, size_t height, long long xOffset, long long yOffset);
+  virtual bool resizeImage(size_t width, size_t height);
+  virtual bool resizeImage(size_t width, size_t height, Filter filter);
+  virtual bool buildPyramid(size_t levels, BmpPyramid& pyramid);
   //Getters
   size_t getWidth();
   size_t getHeight();
   uint16_t getBitsPerPixel();
+  //Orientation
+  void setTopDown(bool topDown);
+  bool isTopDown();
+  //Threading
+  void setThreads(size_t threads);
+  size_t getThreads();
 
 protected:
-  bool flip(FlipType flipType);
-  bool scaleArea(size_t width, size_t height, size_t xOffset = 0, size_t yOffset = 0);
-  bool enlargeArea(size_t width, size_t height, std::function<void (Pixel*&)> initializePixel, size_t xOffset = 0, size_t yOffset = 0);
+  void copyBmp(const Bmp& bmp);
+  bool readFile(const std::string& bmpFile, bool sequential, const std::function<bool(uint8_t*, size_t)>& decode);
+  virtual bool decodeDownscaled(uint8_t* bmpData, size_t dataSize, size_t width, size_t height);
+  bool hasRaster(size_t dataSize);
+  virtual bool flip(FlipType flipType);
+  size_t getEncodedSize();
+  void encodeHeader(uint8_t* bmpData);
+  virtual bool scaleArea(size_t width, size_t height, size_t xOffset = 0, size_t yOffset = 0);
+  virtual bool enlargeArea(size_t width, size_t height, const uint8_t* fillPixel, size_t xOffset = 0, size_t yOffset = 0);
+  virtual bool copyArea(size_t width, size_t height, long long xOffset, long long yOffset, const uint8_t* fillPixel);
   int roundToMultiple(int toRound, int multiple);
+  void forEachBand(size_t rows, size_t rowSize, const std::function<void(size_t, size_t)>& task);
   bmp::Header* header;
   uint8_t* dibData;
-  std::vector<bmp::Pixel*> pixelArray;
+  bmp::PixelBuffer pixelBuffer;
+  size_t threads;
 
 };
 
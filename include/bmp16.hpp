@@ -25,12 +25,12 @@
 #define BMP16_HPP
 
 #include <pixels/wordpixel.hpp>
-#include <bmp.hpp>
+#include <bmpimage.hpp>
 
 namespace bmp
 {
 
-class Bmp16 : public Bmp {
+class Bmp16 : public BmpImage<WordFormat> {
 
 public:
   Bmp16();
@@ -38,19 +38,12 @@ public:
   Bmp16(const Bmp16& bmp);
   Bmp16(Bmp16* bmp);
   ~Bmp16();
-  //En/Decoding
-  bool decodeBmp(uint8_t* bmpData, size_t dataSize);
-  uint8_t* encodeBmp(size_t& dataSize);
-  //I/O
-  bool readBmp(const std::string& bmpFile);
-  bool writeBmp(const std::string& bmpFile);
+  Bmp16& operator=(const Bmp16& bmp);
   //Image operations
-  bool resizeArea(size_t width, size_t height, size_t xOffset = 0, size_t yOffset = 0);
-  bool resizeImage(size_t width, size_t height);
+  using BmpImage<WordFormat>::resizeImage;
+  bool resizeImage(size_t width, size_t height, Filter filter);
   bool setPixelAt(size_t row, size_t column, uint16_t value);
   bool setPixelAt(size_t index, uint16_t value);
-  bmp::WordPixel* getPixelAt(size_t row, size_t column);
-  bmp::WordPixel* getPixelAt(size_t index);
 
 };
 
@@ -25,11 +25,15 @@
 #define BMP24_HPP
 
 #include <pixels/rgbpixel.hpp>
-#include <bmp.hpp>
+#include <bmpimage.hpp>
+
+#include <vector>
 
 namespace bmp {
 
-class Bmp24 : public Bmp {
+class Bmp8;
+
+class Bmp24 : public BmpImage<RGBFormat> {
 
 public:
   Bmp24();
@@ -37,22 +41,15 @@ public:
   Bmp24(const Bmp24& bmp);
   Bmp24(Bmp24* bmp);
   ~Bmp24();
-  //En/Decoding
-  bool decodeBmp(uint8_t* bmpData, size_t dataSize);
-  uint8_t* encodeBmp(size_t& dataSize);
-  //I/O
-  bool readBmp(const std::string& bmpFile);
-  bool writeBmp(const std::string& bmpFile);
+  Bmp24& operator=(const Bmp24& bmp);
   //Image operations
   bool setPixelAt(size_t row, size_t column, uint8_t red, uint8_t green, uint8_t blue);
   bool setPixelAt(size_t index, uint8_t red, uint8_t green, uint8_t blue);
-  bmp::RGBPixel* getPixelAt(size_t row, size_t column);
-  bmp::RGBPixel* getPixelAt(size_t index);
-  bool toGreyScale(int greyLevels = 255);
+  bool toGreyScale(int greyLevels = 255, GreyWeights weights = GreyWeights::AVERAGE);
+  Bmp8* toGreyBmp8(int greyLevels = 255, GreyWeights weights = GreyWeights::AVERAGE);
   bool toSepiaTone();
   bool invert();
-  bool resizeArea(size_t width, size_t height, size_t xOffset = 0, size_t yOffset = 0);
-  bool resizeImage(size_t width, size_t height);
+  bool resizeMany(const std::vector<ImageSize>& sizes, std::vector<Bmp24>& resized, Filter filter = Filter::BILINEAR);
 
 };
 
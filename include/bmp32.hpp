@@ -25,11 +25,15 @@
 #define BMP32_HPP
 
 #include <pixels/rgbapixel.hpp>
-#include <bmp.hpp>
+#include <bmpimage.hpp>
+
+#include <vector>
 
 namespace bmp {
 
-class Bmp32 : public Bmp {
+class Bmp8;
+
+class Bmp32 : public BmpImage<RGBAFormat> {
 
 public:
   Bmp32();
@@ -37,22 +41,25 @@ public:
   Bmp32(const Bmp32& bmp);
   Bmp32(Bmp32* bmp);
   ~Bmp32();
+  Bmp32& operator=(const Bmp32& bmp);
   //En/Decoding
   bool decodeBmp(uint8_t* bmpData, size_t dataSize);
-  uint8_t* encodeBmp(size_t& dataSize);
-  //I/O
-  bool readBmp(const std::string& bmpFile);
-  bool writeBmp(const std::string& bmpFile);
+  bool decodeRegion(uint8_t* bmpData, size_t dataSize, size_t xOffset, size_t yOffset, size_t width, size_t height);
   //Image operations
   bool setPixelAt(size_t row, size_t column, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha);
   bool setPixelAt(size_t index, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha);
-  bmp::RGBAPixel* getPixelAt(size_t row, size_t column);
-  bmp::RGBAPixel* getPixelAt(size_t index);
-  bool toGreyScale(int greyLevels = 255);
+  bool toGreyScale(int greyLevels = 255, GreyWeights weights = GreyWeights::AVERAGE);
+  Bmp8* toGreyBmp8(int greyLevels = 255, GreyWeights weights = GreyWeights::AVERAGE);
   bool toSepiaTone();
   bool invert();
-  bool resizeArea(size_t width, size_t height, size_t xOffset = 0, size_t yOffset = 0);
-  bool resizeImage(size_t width, size_t height);
+  bool resizeMany(const std::vector<ImageSize>& sizes, std::vector<Bmp32>& resized, Filter filter = Filter::BILINEAR);
+
+protected:
+  bool decodeDownscaled(uint8_t* bmpData, size_t dataSize, size_t width, size_t height);
+
+private:
+  bool decodeBitfields();
+  bool readMasks(uint32_t masks[4]);
 
 };
 
@@ -25,12 +25,19 @@
 #define BMP8_HPP
 
 #include <pixels/bytepixel.hpp>
-#include <bmp.hpp>
+#include <pixels/rgbapixel.hpp>
+#include <params/bmpparams.hpp>
+#include <bmpimage.hpp>
+
+#include <vector>
 
 namespace bmp
 {
 
-class Bmp8 : public Bmp {
+class Bmp24;
+class Bmp32;
+
+class Bmp8 : public BmpImage<ByteFormat> {
 
 public:
   Bmp8();
@@ -38,19 +45,49 @@ public:
   Bmp8(const Bmp8& bmp);
   Bmp8(Bmp8* bmp);
   ~Bmp8();
+  Bmp8& operator=(const Bmp8& bmp);
   //En/Decoding
   bool decodeBmp(uint8_t* bmpData, size_t dataSize);
+  bool decodeRegion(uint8_t* bmpData, size_t dataSize, size_t xOffset, size_t yOffset, size_t width, size_t height);
   uint8_t* encodeBmp(size_t& dataSize);
   //I/O
-  bool readBmp(const std::string& bmpFile);
   bool writeBmp(const std::string& bmpFile);
+  void setCompression(Compression compression);
+  Compression getCompression();
   //Image operations
-  bool resizeArea(size_t width, size_t height, size_t xOffset = 0, size_t yOffset = 0);
-  bool resizeImage(size_t width, size_t height);
+  using BmpImage<ByteFormat>::resizeImage;
+  bool resizeImage(size_t width, size_t height, Filter filter);
+  bool buildPyramid(size_t levels, BmpPyramid& pyramid);
   bool setPixelAt(size_t row, size_t column, uint8_t value);
   bool setPixelAt(size_t index, uint8_t value);
-  bmp::BytePixel* getPixelAt(size_t row, size_t column);
-  bmp::BytePixel* getPixelAt(size_t index);
+  bool getColorAt(size_t row, size_t column, RGBAPixel& color);
+  uint8_t* getIndexRow(size_t row);
+  //Palette
+  RGBAPixel* getPalette();
+  size_t getPaletteSize();
+  bool setPalette(const std::vector<RGBAPixel>& palette);
+  bool remapIndexes(const std::vector<uint8_t>& indexMap);
+  bool swapPaletteEntries(uint8_t first, uint8_t second);
+  bool mergePaletteEntries(uint8_t source, uint8_t target);
+  //Palette color operations
+  bool toGreyScale(int greyLevels = 255, GreyWeights weights = GreyWeights::AVERAGE);
+  bool toSepiaTone();
+  bool invert();
+  bool applyGamma(double gamma);
+  //Conversion
+  Bmp24* toBmp24();
+  Bmp32* toBmp32();
+
+protected:
+  bool decodeDownscaled(uint8_t* bmpData, size_t dataSize, size_t width, size_t height);
+
+private:
+  bool hasGreyPalette();
+  void getPaletteTable(uint8_t* table);
+  RGBAPixel* getEditablePalette();
+  bool decodeRle(const uint8_t* rleData, size_t rleSize, bool fourBits);
+  bool decodeFourBits(const uint8_t* rasterData, size_t rasterSize);
+  Compression compression;
 
 };
 
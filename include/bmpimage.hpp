@@ -0,0 +1,76 @@
+/**
+ *   libBMpp - bmpimage.hpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#ifndef BMPIMAGE_HPP
+#define BMPIMAGE_HPP
+
+#include <pixels/pixelformat.hpp>
+#include <bmp.hpp>
+
+namespace bmp {
+
+/**
+ * BmpImage implements the pixel kernels (decoding, encoding, area and image resizing)
+ * once for every pixel format; Format is one of the traits in pixels/pixelformat.hpp.
+ * It is instantiated for ByteFormat, WordFormat, RGBFormat and RGBAFormat only.
+**/
+
+template <typename Format>
+class BmpImage : public Bmp {
+
+public:
+  typedef typename Format::PixelType PixelType;
+  typedef typename Format::ChannelType ChannelType;
+  BmpImage();
+  BmpImage(size_t width, size_t height, const PixelType& defaultPixel);
+  BmpImage(const BmpImage& bmp);
+  BmpImage(BmpImage* bmp);
+  virtual ~BmpImage();
+  BmpImage& operator=(const BmpImage& bmp);
+  //En/Decoding
+  virtual bool decodeBmp(uint8_t* bmpData, size_t dataSize);
+  virtual bool decodeRegion(uint8_t* bmpData, size_t dataSize, size_t xOffset, size_t yOffset, size_t width, size_t height);
+  virtual uint8_t* encodeBmp(size_t& dataSize);
+  //Image operations
+  virtual bool resizeCanvas(size_t width, size_t height, long long xOffset, long long yOffset);
+  bool resizeCanvas(size_t width, size_t height, long long xOffset, long long yOffset, const PixelType& fillPixel);
+  virtual bool resizeImage(size_t width, size_t height);
+  virtual bool resizeImage(size_t width, size_t height, Filter filter);
+  virtual bool buildPyramid(size_t levels, BmpPyramid& pyramid);
+  PixelType* getPixelAt(size_t row, size_t column);
+  PixelType* getPixelAt(size_t index);
+
+protected:
+  virtual bool decodeDownscaled(uint8_t* bmpData, size_t dataSize, size_t width, size_t height);
+  bool downscaleBuffer(size_t width, size_t height, bool average = true);
+  bool downscaleRaster(const uint8_t* raster, size_t rowSize, bool topDown, size_t width, size_t height, bool average = true);
+  bool buildLevels(size_t levels, BmpPyramid& pyramid, bool average);
+  bool resizeNearest(size_t width, size_t height);
+  bool resampleBuffers(PixelBuffer& source, size_t channels, const std::vector<ImageSize>& sizes, const std::vector<PixelBuffer*>& buffers, Filter filter);
+  bool resizeInto(const std::vector<ImageSize>& sizes, const std::vector<BmpImage*>& resized, Filter filter);
+
+};
+
+} // namespace bmp
+
+#endif
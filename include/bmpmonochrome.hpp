@@ -21,12 +21,20 @@
  * SOFTWARE.
 **/
 
+#ifndef BMPMONOCHROME_HPP
+#define BMPMONOCHROME_HPP
+
 #include <pixels/bwpixel.hpp>
 #include <bmp.hpp>
 
 namespace bmp
 {
 
+/**
+ * Bmpmonochrome stores pixels packed 8 per byte (most significant bit first), as in the BMP raster;
+ * bits after the last pixel of a row are always 0
+**/
+
 class Bmpmonochrome : public Bmp {
 
 public:
@@ -35,20 +43,28 @@ public:
   Bmpmonochrome(const Bmpmonochrome& bmp);
   Bmpmonochrome(Bmpmonochrome* bmp);
   ~Bmpmonochrome();
+  Bmpmonochrome& operator=(const Bmpmonochrome& bmp);
   //En/Decoding
   bool decodeBmp(uint8_t* bmpData, size_t dataSize);
+  bool decodeRegion(uint8_t* bmpData, size_t dataSize, size_t xOffset, size_t yOffset, size_t width, size_t height);
   uint8_t* encodeBmp(size_t& dataSize);
-  //I/O
-  bool readBmp(const std::string& bmpFile);
-  bool writeBmp(const std::string& bmpFile);
   //Image operations
-  bool resizeArea(size_t width, size_t height, size_t xOffset = 0, size_t yOffset = 0);
+  bool rotate(int degrees);
+  bool resizeCanvas(size_t width, size_t height, long long xOffset, long long yOffset);
   bool resizeImage(size_t width, size_t height);
+  bool resizeImage(size_t width, size_t height, Filter filter);
   bool setPixelAt(size_t row, size_t column, uint8_t value);
-  bool setPixelAt(size_t, uint8_t value);
-  bmp::BWPixel* getPixelAt(size_t row, size_t column);
-  bmp::BWPixel* getPixelAt(size_t index);
+  bool setPixelAt(size_t index, uint8_t value);
+  bool getPixelAt(size_t row, size_t column, bmp::BWPixel& pixel);
+  bool getPixelAt(size_t index, bmp::BWPixel& pixel);
+
+protected:
+  bool decodeDownscaled(uint8_t* bmpData, size_t dataSize, size_t width, size_t height);
+  bool flip(FlipType flipType);
+  bool copyArea(size_t width, size_t height, long long xOffset, long long yOffset, const uint8_t* fillPixel);
 
 };
 
 } // namespace bmp
+
+#endif
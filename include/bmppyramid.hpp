@@ -0,0 +1,68 @@
+/**
+ *   libBMpp - bmppyramid.hpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#ifndef BMPPYRAMID_HPP
+#define BMPPYRAMID_HPP
+
+#include <bmpview.hpp>
+
+#include <cinttypes>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace bmp {
+
+template <typename Format>
+class BmpImage;
+
+/**
+ * BmpPyramid holds the levels built by Bmp::buildPyramid: level 0 is the image, each next level is the previous one halved.
+ * Every level is an encoded, uncompressed bitmap (header and raster); all the levels are stored in a single allocation.
+ * Pyramids are built for 8, 16, 24 and 32 bits bitmaps only (Bmpmonochrome::buildPyramid returns false).
+**/
+
+class BmpPyramid {
+
+public:
+  BmpPyramid();
+  ~BmpPyramid();
+  size_t getLevels();
+  const uint8_t* getLevel(size_t level, size_t& dataSize);
+  BmpView getView(size_t level);
+  bool writeLevel(size_t level, const std::string& bmpFile);
+
+private:
+  template <typename Format>
+  friend class BmpImage;
+  BmpPyramid(const BmpPyramid&);
+  BmpPyramid& operator=(const BmpPyramid&);
+  uint8_t* allocate(const std::vector<size_t>& levelSizes);
+  uint8_t* data;
+  std::vector<size_t> offsets;
+
+};
+
+} // namespace bmp
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ *   libBMpp - bmprowreader.hpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#ifndef BMPROWREADER_HPP
+#define BMPROWREADER_HPP
+
+#include <bmp.hpp>
+#include <params/bmpparams.hpp>
+#include <pixels/rgbapixel.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace bmp {
+
+/**
+ * BmpRowReader reads an uncompressed (BI_RGB) 1, 8, 16, 24 or 32 bits bitmap file one row (or a band of rows)
+ * at a time into a buffer owned by the caller; memory usage doesn't depend on the image height.
+ * Rows are returned without padding, TOP_DOWN or BOTTOM_UP; reading in the file order never seeks.
+ * The color table of 1 and 8 bits bitmaps is read when the file is opened.
+**/
+
+class BmpRowReader {
+
+public:
+  BmpRowReader();
+  ~BmpRowReader();
+  //I/O
+  bool open(const std::string& bmpFile, RowOrder rowOrder = RowOrder::TOP_DOWN);
+  bool open(int fd, RowOrder rowOrder = RowOrder::TOP_DOWN);
+  void close();
+  bool readRow(uint8_t* row);
+  size_t readRows(uint8_t* rows, size_t rowCount);
+  bool seekRow(size_t row);
+  //Getters
+  size_t getWidth();
+  size_t getHeight();
+  uint16_t getBitsPerPixel();
+  size_t getRowSize();
+  size_t getCurrentRow();
+  const bmp::Header& getHeader();
+  const std::vector<RGBAPixel>& getPalette();
+
+private:
+  BmpRowReader(const BmpRowReader&);
+  BmpRowReader& operator=(const BmpRowReader&);
+  bool openFile(FILE* bmpFile, RowOrder rowOrder);
+  bool readAt(size_t position, uint8_t* buffer, size_t size);
+  bool readPalette();
+  size_t getFileRow(size_t row);
+  bmp::Header header;
+  FILE* file;
+  RowOrder order;
+  size_t rowSize;
+  size_t stride;
+  size_t currentRow;
+  size_t filePosition;
+  std::vector<RGBAPixel> palette;
+
+};
+
+} // namespace bmp
+
+#endif
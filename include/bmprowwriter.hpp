@@ -0,0 +1,78 @@
+/**
+ *   libBMpp - bmprowwriter.hpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#ifndef BMPROWWRITER_HPP
+#define BMPROWWRITER_HPP
+
+#include <bmp.hpp>
+#include <params/bmpparams.hpp>
+#include <pixels/rgbapixel.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace bmp {
+
+/**
+ * BmpRowWriter writes an uncompressed (BI_RGB) 1, 8, 16, 24 or 32 bits bitmap file one row (or a band of rows) at a time.
+ * The header (and the color table of 1 and 8 bits bitmaps) is written when the file is opened; rows are provided without padding,
+ * TOP_DOWN or in file order (BOTTOM_UP).
+ * Memory usage doesn't depend on the image size.
+**/
+
+class BmpRowWriter {
+
+public:
+  BmpRowWriter();
+  ~BmpRowWriter();
+  //I/O
+  bool open(const std::string& bmpFile, size_t width, size_t height, uint16_t bitsPerPixel, RowOrder rowOrder = RowOrder::TOP_DOWN, const std::vector<RGBAPixel>& palette = std::vector<RGBAPixel>());
+  bool writeRow(const uint8_t* row);
+  size_t writeRows(const uint8_t* rows, size_t rowCount);
+  bool close();
+  //Getters
+  size_t getWidth();
+  size_t getHeight();
+  uint16_t getBitsPerPixel();
+  size_t getRowSize();
+  size_t getCurrentRow();
+
+private:
+  BmpRowWriter(const BmpRowWriter&);
+  BmpRowWriter& operator=(const BmpRowWriter&);
+  bool writeAt(size_t position, const uint8_t* buffer, size_t size);
+  bmp::Header header;
+  FILE* file;
+  RowOrder order;
+  size_t rowSize;
+  size_t stride;
+  size_t currentRow;
+  size_t filePosition;
+  bool failed;
+
+};
+
+} // namespace bmp
+
+#endif
@@ -0,0 +1,136 @@
+/**
+ *   libBMpp - bmpview.hpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#ifndef BMPVIEW_HPP
+#define BMPVIEW_HPP
+
+#include <bmp.hpp>
+#include <pixels/rgbpixel.hpp>
+#include <pixels/rgbapixel.hpp>
+
+namespace bmp {
+
+/**
+ * BmpView is a read-only view over an encoded, uncompressed (BI_RGB) 8, 16, 24 or 32 bits bitmap.
+ * Only the header is decoded: rows and pixels are returned as pointers into the caller's buffer,
+ * which must outlive the view. Nothing is allocated or copied.
+**/
+
+class BmpView {
+
+public:
+  BmpView();
+  BmpView(const uint8_t* bmpData, size_t dataSize);
+  bool setData(const uint8_t* bmpData, size_t dataSize);
+  bool isValid();
+  //Getters
+  size_t getWidth();
+  size_t getHeight();
+  uint16_t getBitsPerPixel();
+  size_t getStride();
+  const uint8_t* getRow(size_t row);
+  const uint8_t* getPixelAt(size_t row, size_t column);
+  const RGBPixel* getRGBPixelAt(size_t row, size_t column);
+  const RGBAPixel* getRGBAPixelAt(size_t row, size_t column);
+
+private:
+  bmp::Header header;
+  const uint8_t* raster;
+  size_t stride;
+
+};
+
+/**
+ * @function isValid
+ * @description returns whether the view points to a valid bitmap
+ * @returns bool
+**/
+
+inline bool BmpView::isValid() {
+  return raster != nullptr;
+}
+
+/**
+ * @function getRow
+ * @description returns pointer to the first pixel of the provided row (top to bottom); nullptr if out of range
+ * @param size_t
+ * @returns const uint8_t*
+**/
+
+inline const uint8_t* BmpView::getRow(size_t row) {
+  if (raster == nullptr || row >= header.height) {
+    return nullptr;
+  }
+  //Rows are stored bottom to top, unless the bitmap is top-down
+  return raster + (header.topDown ? row : header.height - 1 - row) * stride;
+}
+
+/**
+ * @function getPixelAt
+ * @description returns pointer to the bytes of the pixel in the provided position; nullptr if out of range
+ * @param size_t
+ * @param size_t
+ * @returns const uint8_t*
+**/
+
+inline const uint8_t* BmpView::getPixelAt(size_t row, size_t column) {
+  const uint8_t* rowData = getRow(row);
+  if (rowData == nullptr || column >= header.width) {
+    return nullptr;
+  }
+  return rowData + column * (header.bitsPerPixel / 8);
+}
+
+/**
+ * @function getRGBPixelAt
+ * @description returns pixel in the provided position of a 24 bits bitmap; nullptr if out of range or if the bitmap is not 24 bits
+ * @param size_t
+ * @param size_t
+ * @returns const RGBPixel*
+**/
+
+inline const RGBPixel* BmpView::getRGBPixelAt(size_t row, size_t column) {
+  if (header.bitsPerPixel != 24) {
+    return nullptr;
+  }
+  return reinterpret_cast<const RGBPixel*>(getPixelAt(row, column));
+}
+
+/**
+ * @function getRGBAPixelAt
+ * @description returns pixel in the provided position of a 32 bits bitmap; nullptr if out of range or if the bitmap is not 32 bits
+ * @param size_t
+ * @param size_t
+ * @returns const RGBAPixel*
+**/
+
+inline const RGBAPixel* BmpView::getRGBAPixelAt(size_t row, size_t column) {
+  if (header.bitsPerPixel != 32) {
+    return nullptr;
+  }
+  return reinterpret_cast<const RGBAPixel*>(getPixelAt(row, column));
+}
+
+} // namespace bmp
+
+#endif
@@ -24,6 +24,8 @@
 #ifndef BMPPARAMS_HPP
 #define BMPPARAMS_HPP
 
+#include <cstddef>
+
 namespace bmp {
   
 enum class FlipType {
@@ -32,6 +34,41 @@ enum class FlipType {
   OUT_OF_RANGE
 };
 
+enum class Compression {
+  NONE,
+  RLE8,
+  AUTO
+};
+
+enum class RowOrder {
+  BOTTOM_UP,
+  TOP_DOWN
+};
+
+enum class ScaleFactor {
+  HALF = 2,
+  QUARTER = 4,
+  EIGHTH = 8
+};
+
+enum class Filter {
+  BOX,
+  BILINEAR,
+  BICUBIC,
+  LANCZOS3
+};
+
+enum class GreyWeights {
+  AVERAGE,
+  BT601,
+  BT709
+};
+
+typedef struct ImageSize {
+  size_t width;
+  size_t height;
+} ImageSize;
+
 }
 
 #endif
@@ -27,6 +27,7 @@
 #include <bmp.hpp>
 
 #include <functional>
+#include <string>
 
 namespace bmp {
 
@@ -36,6 +37,16 @@ public:
   BmpParser();
   //Decoding
   Bmp* getBmp(uint8_t* bmpData, size_t dataSize, size_t& bitsPerPixel);
+  Bmp* getRegion(uint8_t* bmpData, size_t dataSize, size_t xOffset, size_t yOffset, size_t width, size_t height, size_t& bitsPerPixel);
+  Bmp* getRegion(const std::string& bmpFile, size_t xOffset, size_t yOffset, size_t width, size_t height, size_t& bitsPerPixel);
+  Bmp* getScaled(uint8_t* bmpData, size_t dataSize, size_t width, size_t height, size_t& bitsPerPixel);
+  Bmp* getScaled(const std::string& bmpFile, size_t width, size_t height, size_t& bitsPerPixel);
+  //Probing
+  bool probe(const uint8_t* bmpData, size_t dataSize, bmp::Header& header);
+  bool probe(const std::string& bmpFile, bmp::Header& header);
+
+private:
+  static Bmp* newBmp(size_t bitsPerPixel);
 
 };
 
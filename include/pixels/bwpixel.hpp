@@ -33,13 +33,35 @@ class BWPixel : public Pixel {
 public:
   BWPixel(uint8_t value);
   void setPixel(uint8_t value);
-  uint8_t getValue();
+  uint8_t getValue() const;
 
 private:
   uint8_t value;
 
 };
 
+/**
+ * @function setPixel
+ * @description: Set pixel RGB value
+ * @param uint8_t
+ * @param uint8_t
+ * @param uint8_t
+**/
+
+inline void BWPixel::setPixel(uint8_t value) {
+  this->value = value > 0 ? 1 : 0;
+}
+
+/**
+ * @function getValue
+ * @description returns color (1:0) value
+ * @returns uint8_t
+**/
+
+inline uint8_t BWPixel::getValue() const {
+  return value;
+}
+
 } // namespace bmp
 
 #endif
@@ -33,13 +33,33 @@ class BytePixel : public Pixel {
 public:
   BytePixel(uint8_t value);
   void setPixel(uint8_t value);
-  uint8_t getValue();
+  uint8_t getValue() const;
 
 private:
   uint8_t value;
 
 };
 
+/**
+ * @function setPixel
+ * @description: Set pixel value
+ * @param uint8_t
+**/
+
+inline void BytePixel::setPixel(uint8_t value) {
+  this->value = value;
+}
+
+/**
+ * @function getValue
+ * @description returns pixel value
+ * @returns uint8_t
+**/
+
+inline uint8_t BytePixel::getValue() const {
+  return value;
+}
+
 } // namespace bmp
 
 #endif
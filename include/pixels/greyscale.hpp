@@ -0,0 +1,64 @@
+/**
+ *   libBMpp - greyscale.hpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#ifndef GREYSCALE_HPP
+#define GREYSCALE_HPP
+
+#include <params/bmpparams.hpp>
+
+#include <cinttypes>
+#include <cstddef>
+
+namespace bmp {
+
+/**
+ * GreyScale converts rows of 24 or 32 bits pixels (blue, green, red[, alpha]) to grey. Grey is the weighted sum of the channels,
+ * with fixed point weights (plain average, BT.601 or BT.709 luma); greyLevels reduces it to fewer levels with a 256 entries table.
+ * Rows are weighed with SSE2 when enabled at build time.
+**/
+
+class GreyScale {
+
+public:
+  GreyScale(GreyWeights weights = GreyWeights::AVERAGE, int greyLevels = 255);
+  uint8_t getGrey(uint8_t red, uint8_t green, uint8_t blue) const;
+  void toGrey(const uint8_t* src, uint8_t* grey, size_t width, size_t channels) const;
+  void toGreyRow24(uint8_t* row, size_t width) const;
+  void toGreyRow32(uint8_t* row, size_t width) const;
+
+private:
+  void weighRow(const uint8_t* src, uint8_t* grey, size_t width, size_t channels) const;
+  int16_t blueWeight;
+  int16_t greenWeight;
+  int16_t redWeight;
+  int32_t bias;
+  bool quantized;
+  uint8_t levels[256];
+  //Grey levels as palette entries (blue, green, red, reserved), to expand 24 bits rows
+  uint8_t palette[1024];
+
+};
+
+} // namespace bmp
+
+#endif
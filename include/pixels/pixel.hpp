@@ -28,9 +28,13 @@
 
 namespace bmp {
 
+/**
+ * Pixel is the common base of every pixel type. It is empty and not polymorphic,
+ * so that a pixel has exactly the size and the layout it has in a BMP row
+ * and can be addressed directly inside a PixelBuffer.
+**/
+
 class Pixel {
-public:
-  virtual ~Pixel() = default;
 
 };
 
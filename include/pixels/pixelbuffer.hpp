@@ -0,0 +1,77 @@
+/**
+ *   libBMpp - pixelbuffer.hpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#ifndef PIXELBUFFER_HPP
+#define PIXELBUFFER_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+namespace bmp {
+
+/**
+ * PixelBuffer is the contiguous raster storage shared by every Bmp type.
+ * The whole image is a single allocation; rows are laid out as BMP rows
+ * (bottom to top, padded to a multiple of 4 bytes), so row 0 is the bottom row.
+**/
+
+class PixelBuffer {
+
+public:
+  PixelBuffer();
+  PixelBuffer(size_t width, size_t height, uint16_t bitsPerPixel);
+  PixelBuffer(const PixelBuffer& buffer);
+  ~PixelBuffer();
+  PixelBuffer& operator=(const PixelBuffer& buffer);
+  //Allocation
+  bool allocate(size_t width, size_t height, uint16_t bitsPerPixel, bool clear = true);
+  void release();
+  void swap(PixelBuffer& buffer);
+  void fill(const uint8_t* pixel);
+  //Getters
+  uint8_t* getData();
+  uint8_t* getRow(size_t row);
+  uint8_t* getPixel(size_t row, size_t column);
+  uint8_t* getPixel(size_t index);
+  size_t getWidth();
+  size_t getHeight();
+  size_t getStride();
+  size_t getRowSize();
+  size_t getDataSize();
+  size_t getPixelCount();
+  size_t getBytesPerPixel();
+  uint16_t getBitsPerPixel();
+  static size_t strideFor(size_t width, uint16_t bitsPerPixel);
+
+private:
+  uint8_t* data;
+  size_t width;
+  size_t height;
+  size_t stride;
+  uint16_t bitsPerPixel;
+
+};
+
+} // namespace bmp
+
+#endif
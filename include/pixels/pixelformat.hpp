@@ -0,0 +1,95 @@
+/**
+ *   libBMpp - pixelformat.hpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#ifndef PIXELFORMAT_HPP
+#define PIXELFORMAT_HPP
+
+#include <pixels/bytepixel.hpp>
+#include <pixels/rgbapixel.hpp>
+#include <pixels/rgbpixel.hpp>
+#include <pixels/wordpixel.hpp>
+
+#include <cstddef>
+#include <cstring>
+
+namespace bmp {
+
+/**
+ * Pixel format traits used by BmpImage.
+ * Each format describes:
+ *  - PixelType: the pixel class exposed by getPixelAt
+ *  - ChannelType and channels: a stored pixel is an array of 'channels' ChannelType, in raster order (e.g. B, G, R)
+ *  - bitsPerPixel: bits per pixel in the BMP file
+ *  - storageBitsPerPixel: bits per pixel in the PixelBuffer
+ *  - decodeRow / encodeRow: convert a row between the BMP raster and the PixelBuffer (padding excluded)
+ *  - white: pixel used to fill new areas
+**/
+
+/**
+ * Formats whose PixelBuffer row is the BMP row itself
+**/
+
+template <typename Pixel, typename Channel, size_t Channels>
+struct RasterFormat {
+  typedef Pixel PixelType;
+  typedef Channel ChannelType;
+  static const size_t channels = Channels;
+  static const uint16_t bitsPerPixel = sizeof(Pixel) * 8;
+  static const uint16_t storageBitsPerPixel = sizeof(Pixel) * 8;
+
+  static inline void decodeRow(const uint8_t* src, uint8_t* dst, size_t width) {
+    memcpy(dst, src, width * sizeof(Pixel));
+  }
+
+  static inline void encodeRow(const uint8_t* src, uint8_t* dst, size_t width) {
+    memcpy(dst, src, width * sizeof(Pixel));
+  }
+};
+
+struct ByteFormat : public RasterFormat<BytePixel, uint8_t, 1> {
+  static inline BytePixel white() {
+    return BytePixel(255);
+  }
+};
+
+struct WordFormat : public RasterFormat<WordPixel, uint16_t, 1> {
+  static inline WordPixel white() {
+    return WordPixel(65535);
+  }
+};
+
+struct RGBFormat : public RasterFormat<RGBPixel, uint8_t, 3> {
+  static inline RGBPixel white() {
+    return RGBPixel(255, 255, 255);
+  }
+};
+
+struct RGBAFormat : public RasterFormat<RGBAPixel, uint8_t, 4> {
+  static inline RGBAPixel white() {
+    return RGBAPixel(255, 255, 255, 0);
+  }
+};
+
+} // namespace bmp
+
+#endif
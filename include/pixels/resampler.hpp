@@ -0,0 +1,153 @@
+/**
+ *   libBMpp - resampler.hpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#ifndef RESAMPLER_HPP
+#define RESAMPLER_HPP
+
+#include <params/bmpparams.hpp>
+
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+namespace bmp {
+
+/**
+ * ResampleKernel holds the weights resizing one axis with a filter: sample n of the resized axis is the weighted sum of
+ * the source samples [getFirst(n), getFirst(n) + getCount(n)). Weights are fixed point numbers with 14 fractional bits which sum to 1;
+ * when downscaling, the filter is stretched so that every source sample contributes (area averaging).
+**/
+
+class ResampleKernel {
+
+public:
+  ResampleKernel(size_t srcSize, size_t size, Filter filter);
+  size_t getSourceSize() const;
+  size_t getSize() const;
+  size_t getTaps() const;
+  size_t getFirst(size_t position) const;
+  size_t getCount(size_t position) const;
+  const int16_t* getWeights(size_t position) const;
+
+private:
+  size_t srcSize;
+  size_t size;
+  size_t taps;
+  size_t stride;
+  std::vector<uint32_t> first;
+  std::vector<uint32_t> count;
+  std::vector<int16_t> weights;
+
+};
+
+/**
+ * @function getSourceSize
+ * @description returns the size of the source axis
+ * @returns size_t
+**/
+
+inline size_t ResampleKernel::getSourceSize() const {
+  return srcSize;
+}
+
+/**
+ * @function getSize
+ * @description returns the size of the resized axis
+ * @returns size_t
+**/
+
+inline size_t ResampleKernel::getSize() const {
+  return size;
+}
+
+/**
+ * @function getTaps
+ * @description returns the highest amount of source samples used by a resized sample
+ * @returns size_t
+**/
+
+inline size_t ResampleKernel::getTaps() const {
+  return taps;
+}
+
+/**
+ * @function getFirst
+ * @description returns the first source sample used by a resized sample
+ * @param size_t
+ * @returns size_t
+**/
+
+inline size_t ResampleKernel::getFirst(size_t position) const {
+  return first[position];
+}
+
+/**
+ * @function getCount
+ * @description returns the amount of source samples used by a resized sample
+ * @param size_t
+ * @returns size_t
+**/
+
+inline size_t ResampleKernel::getCount(size_t position) const {
+  return count[position];
+}
+
+/**
+ * @function getWeights
+ * @description returns the weights of the source samples used by a resized sample
+ * @param size_t
+ * @returns const int16_t*
+**/
+
+inline const int16_t* ResampleKernel::getWeights(size_t position) const {
+  return &weights[position * stride];
+}
+
+/**
+ * RowResampler resizes an image a row at a time with the kernels of its columns and of its rows.
+ * Source rows are pushed in order and resampled horizontally into a ring of getTaps() rows; resized rows are resampled vertically
+ * from the ring, so each one must be resampled as soon as the source rows it needs have been pushed.
+ * Rows of 8 bits channels are resampled with SSE2 when the library is built with it enabled.
+**/
+
+template <typename ChannelType>
+class RowResampler {
+
+public:
+  RowResampler(const ResampleKernel& columns, const ResampleKernel& rows, size_t channels);
+  void pushRow(size_t srcRow, const ChannelType* samples);
+  void resampleRow(size_t row, ChannelType* resized);
+
+private:
+  const ResampleKernel& columns;
+  const ResampleKernel& rows;
+  size_t channels;
+  size_t rowSamples;
+  std::vector<ChannelType> ring;
+  std::vector<const ChannelType*> ringRows;
+
+};
+
+} // namespace bmp
+
+#endif
@@ -33,19 +33,76 @@ class RGBAPixel : public Pixel {
 public:
   RGBAPixel(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha);
   void setPixel(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha);
-  uint8_t getRed();
-  uint8_t getGreen();
-  uint8_t getBlue();
-  uint8_t getAlpha();
+  uint8_t getRed() const;
+  uint8_t getGreen() const;
+  uint8_t getBlue() const;
+  uint8_t getAlpha() const;
 
 private:
-  uint8_t red;
-  uint8_t green;
+  //Stored as BGRA, as in the BMP raster
   uint8_t blue;
+  uint8_t green;
+  uint8_t red;
   uint8_t alpha;
 
 };
 
+/**
+ * @function setPixel
+ * @description: Set pixel RGB value
+ * @param uint8_t
+ * @param uint8_t
+ * @param uint8_t
+ * @param uint8_t
+**/
+
+inline void RGBAPixel::setPixel(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha) {
+  this->red = red;
+  this->green = green;
+  this->blue = blue;
+  this->alpha = alpha;
+}
+
+/**
+ * @function getRed
+ * @description returns red level
+ * @returns uint8_t
+**/
+
+inline uint8_t RGBAPixel::getRed() const {
+  return red;
+}
+
+/**
+ * @function getGreen
+ * @description returns green level
+ * @returns uint8_t
+**/
+
+inline uint8_t RGBAPixel::getGreen() const {
+  return green;
+}
+
+/**
+ * @function getBlue
+ * @description returns blue level
+ * @returns uint8_t
+**/
+
+inline uint8_t RGBAPixel::getBlue() const {
+  return blue;
+}
+
+/**
+ * @function getAlpha
+ * @description: returns alpha level
+ * @returns uint8_t
+**/
+
+inline uint8_t RGBAPixel::getAlpha() const {
+  return alpha;
+}
+
 } // namespace bmp
 
 #endif
@@ -33,17 +33,62 @@ class RGBPixel : public Pixel {
 public:
   RGBPixel(uint8_t red, uint8_t green, uint8_t blue);
   void setPixel(uint8_t red, uint8_t green, uint8_t blue);
-  uint8_t getRed();
-  uint8_t getGreen();
-  uint8_t getBlue();
+  uint8_t getRed() const;
+  uint8_t getGreen() const;
+  uint8_t getBlue() const;
 
 private:
-  uint8_t red;
-  uint8_t green;
+  //Stored as BGR, as in the BMP raster
   uint8_t blue;
+  uint8_t green;
+  uint8_t red;
 
 };
 
+/**
+ * @function setPixel
+ * @description: Set pixel RGB value
+ * @param uint8_t
+ * @param uint8_t
+ * @param uint8_t
+**/
+
+inline void RGBPixel::setPixel(uint8_t red, uint8_t green, uint8_t blue) {
+  this->red = red;
+  this->green = green;
+  this->blue = blue;
+}
+
+/**
+ * @function getRed
+ * @description returns red level
+ * @returns uint8_t
+**/
+
+inline uint8_t RGBPixel::getRed() const {
+  return red;
+}
+
+/**
+ * @function getGreen
+ * @description returns green level
+ * @returns uint8_t
+**/
+
+inline uint8_t RGBPixel::getGreen() const {
+  return green;
+}
+
+/**
+ * @function getBlue
+ * @description returns blue level
+ * @returns uint8_t
+**/
+
+inline uint8_t RGBPixel::getBlue() const {
+  return blue;
+}
+
 } // namespace bmp
 
 #endif
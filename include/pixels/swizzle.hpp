@@ -0,0 +1,50 @@
+/**
+ *   libBMpp - swizzle.hpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#ifndef SWIZZLE_HPP
+#define SWIZZLE_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+namespace bmp {
+
+/**
+ * Swizzle converts the layout of the pixels of a row (byte order, palette expansion).
+ * Kernels use AVX2 or SSSE3 shuffles when the library is built with them enabled
+ * (e.g. CXXFLAGS="-O2 -mavx2" or "-march=native"), scalar code otherwise.
+**/
+
+class Swizzle {
+
+public:
+  static void shuffle32(const uint8_t* src, uint8_t* dst, size_t width, const uint8_t* order);
+  static void expandPalette32(const uint8_t* src, uint8_t* dst, size_t width, const uint8_t* palette);
+  static void expandPalette24(const uint8_t* src, uint8_t* dst, size_t width, const uint8_t* palette);
+  static const char* getInstructionSet();
+
+};
+
+} // namespace bmp
+
+#endif
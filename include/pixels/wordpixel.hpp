@@ -33,13 +33,34 @@ class WordPixel : public Pixel {
 public:
   WordPixel(uint16_t value);
   void setPixel(uint16_t value);
-  uint16_t getValue();
+  uint16_t getValue() const;
 
 private:
+  //Stored little endian, as in the BMP raster
   uint16_t value;
 
 };
 
+/**
+ * @function setPixel
+ * @description: Set pixel value
+ * @param uint16_t
+**/
+
+inline void WordPixel::setPixel(uint16_t value) {
+  this->value = value;
+}
+
+/**
+ * @function getValue
+ * @description returns pixel value
+ * @returns uint16_t
+**/
+
+inline uint16_t WordPixel::getValue() const {
+  return value;
+}
+
 } // namespace bmp
 
 #endif
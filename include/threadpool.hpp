@@ -0,0 +1,71 @@
+/**
+ *   libBMpp - threadpool.hpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bmp {
+
+/**
+ * ThreadPool runs the tasks of a job on a set of worker threads and on the calling thread.
+ * A pool runs one job at a time: a job submitted while another one is running (e.g. from another thread)
+ * is run on the calling thread.
+**/
+
+class ThreadPool {
+
+public:
+  ThreadPool(size_t threads);
+  ~ThreadPool();
+  void run(size_t taskCount, const std::function<void(size_t)>& task);
+  size_t getThreadCount();
+  static ThreadPool& getDefault();
+  static size_t getHardwareThreads();
+
+private:
+  ThreadPool(const ThreadPool&);
+  ThreadPool& operator=(const ThreadPool&);
+  void work();
+  std::vector<std::thread> workers;
+  std::mutex jobMutex;
+  std::mutex mutex;
+  std::condition_variable taskCondition;
+  std::condition_variable doneCondition;
+  const std::function<void(size_t)>* currentTask;
+  size_t taskCount;
+  size_t nextTask;
+  size_t pendingTasks;
+  bool stopping;
+
+};
+
+} // namespace bmp
+
+#endif
@@ -21,9 +21,30 @@
  * SOFTWARE.
 **/
 
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
 #include <bmp.hpp>
+#include <threadpool.hpp>
 
+#include <cstddef>
 #include <cstring>
+#include <fstream>
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H) && defined(HAVE_FCNTL_H) && defined(HAVE_SYS_STAT_H) && defined(HAVE_UNISTD_H)
+#define BMP_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #ifdef BMP_DEBUG
 #include <iostream>
@@ -33,6 +54,10 @@
 #define BMP_ID 0x424D
 #define HORIZONTAL_FLIP 'H'
 #define VERTICAL_FLIP 'V'
+//Smallest amount of raster bytes worth a thread
+#define MIN_BAND_SIZE 262144
+//Side of the square tiles copied by 90 and 270 degrees rotations; a tile of 4 bytes pixels takes 4KB
+#define ROTATE_TILE_SIZE 32
 
 using namespace bmp;
 
@@ -43,6 +68,8 @@ using namespace bmp;
 
 Bmp::Bmp() {
   header = nullptr;
+  dibData = nullptr;
+  threads = 1;
 }
 
 /**
@@ -63,6 +90,8 @@ Bmp::Bmp(size_t width, size_t height) {
   //bitsPerPixel must be set by child class
   header->paletteSize = 0;
   header->importantColors = 0;
+  dibData = nullptr;
+  threads = 1;
 }
 
 /**
@@ -72,22 +101,9 @@ Bmp::Bmp(size_t width, size_t height) {
  */
 
 Bmp::Bmp(const Bmp& bmp) {
-  header = new Header();
-  header->bmpId = BMP_ID;
-  header->fileSize = bmp.header->fileSize;
-  header->dataOffset = bmp.header->dataOffset;
-  header->dibSize = bmp.header->dibSize;
-  header->width = bmp.header->width;
-  header->height = bmp.header->height;
-  header->colorPlanes = bmp.header->colorPlanes;
-  header->bitsPerPixel = bmp.header->bitsPerPixel;
-  header->biRgb = bmp.header->biRgb;
-  header->dataSize = bmp.header->dataSize;
-  header->printSizeW = bmp.header->printSizeW;
-  header->printSizeH = bmp.header->printSizeH;
-  header->paletteSize = bmp.header->paletteSize;
-  header->importantColors = bmp.header->importantColors;
-  dibData = bmp.dibData; 
+  header = nullptr;
+  dibData = nullptr;
+  copyBmp(bmp);
 }
 
 /**
@@ -97,22 +113,23 @@ Bmp::Bmp(const Bmp& bmp) {
  */
 
 Bmp::Bmp(Bmp* bmp) {
-  header = new Header();
-  header->bmpId = BMP_ID;
-  header->fileSize = bmp->header->fileSize;
-  header->dataOffset = bmp->header->dataOffset;
-  header->dibSize = bmp->header->dibSize;
-  header->width = bmp->header->width;
-  header->height = bmp->header->height;
-  header->colorPlanes = bmp->header->colorPlanes;
-  header->bitsPerPixel = bmp->header->bitsPerPixel;
-  header->biRgb = bmp->header->biRgb;
-  header->dataSize = bmp->header->dataSize;
-  header->printSizeW = bmp->header->printSizeW;
-  header->printSizeH = bmp->header->printSizeH;
-  header->paletteSize = bmp->header->paletteSize;
-  header->importantColors = bmp->header->importantColors;
-  dibData = bmp->dibData; 
+  header = nullptr;
+  dibData = nullptr;
+  copyBmp(*bmp);
+}
+
+/**
+ * @function operator=
+ * @description copy another image into this one, replacing its header, dib data and pixels
+ * @param const Bmp& bmp
+ * @returns Bmp&
+**/
+
+Bmp& Bmp::operator=(const Bmp& bmp) {
+  if (this != &bmp) {
+    copyBmp(bmp);
+  }
+  return *this;
 }
 
 /**
@@ -125,141 +142,213 @@ Bmp::~Bmp() {
   if (header != nullptr) {
     delete header;
   }
-  //Delete pixels
-  for (auto& pixel : pixelArray) {
-    delete pixel;
-    pixel = nullptr;
-  }
-  pixelArray.clear();
+  //Pixels are released by pixelBuffer
   delete[] dibData;
 }
 
 /**
- * @function decodeBmp
- * @description decode Bmp data buffer filling header struct
- * @param uint8_t*
+ * @function copyBmp
+ * @description replace header, dib data and pixels with a deep copy of another image's; an image without header (e.g. default constructed) copies as an empty one
+ * @param const Bmp& bmp
+**/
+
+void Bmp::copyBmp(const Bmp& bmp) {
+  delete header;
+  header = nullptr;
+  delete[] dibData;
+  dibData = nullptr;
+  if (bmp.header != nullptr) {
+    header = new Header();
+    header->bmpId = BMP_ID;
+    header->fileSize = bmp.header->fileSize;
+    header->dataOffset = bmp.header->dataOffset;
+    header->dibSize = bmp.header->dibSize;
+    header->width = bmp.header->width;
+    header->height = bmp.header->height;
+    header->colorPlanes = bmp.header->colorPlanes;
+    header->bitsPerPixel = bmp.header->bitsPerPixel;
+    header->biRgb = bmp.header->biRgb;
+    header->dataSize = bmp.header->dataSize;
+    header->printSizeW = bmp.header->printSizeW;
+    header->printSizeH = bmp.header->printSizeH;
+    header->paletteSize = bmp.header->paletteSize;
+    header->importantColors = bmp.header->importantColors;
+    header->topDown = bmp.header->topDown;
+    //Copy dibData
+    size_t dibDataSize = (header->dataOffset > 54) ? header->dataOffset - 54 : 0;
+    dibData = new uint8_t[dibDataSize];
+    if (bmp.dibData != nullptr) {
+      memcpy(dibData, bmp.dibData, dibDataSize);
+    }
+  }
+  //Copy pixels
+  pixelBuffer = bmp.pixelBuffer;
+  threads = bmp.threads;
+}
+
+/**
+ * @function decodeHeader
+ * @description decode the BMP file header and the BITMAPINFOHEADER fields of a data buffer into header; nothing is allocated.
+ * Only the first 54 bytes are read: whether the data offset is inside the buffer is checked by the raster decoders
+ * @param const uint8_t*
  * @param size_t
+ * @param Header&
  * @returns bool
 **/
 
-bool Bmp::decodeBmp(uint8_t* bmpData, size_t dataSize) {
+bool Bmp::decodeHeader(const uint8_t* bmpData, size_t dataSize, Header& header) {
 
   //Header is too small
   if (dataSize < 54) {
     return false;
   }
-  //Delete previous header if exists
-  if (header != nullptr) {
-    delete header;
-  }
-
-  header = new Header();
-  //Get header
   //BMP ID 'BM'
-  header->bmpId = (bmpData[0] << 8) + bmpData[1];
-  if (header->bmpId != BMP_ID) {
+  header.bmpId = (bmpData[0] << 8) + bmpData[1];
+  if (header.bmpId != BMP_ID) {
     return false;
   }
 
   //Filesize
-  header->fileSize = bmpData[5];
-  header->fileSize = header->fileSize << 8;
-  header->fileSize += bmpData[4];
-  header->fileSize = header->fileSize << 8;
-  header->fileSize += bmpData[3];
-  header->fileSize = header->fileSize << 8;
-  header->fileSize += bmpData[2];
+  header.fileSize = bmpData[5];
+  header.fileSize = header.fileSize << 8;
+  header.fileSize += bmpData[4];
+  header.fileSize = header.fileSize << 8;
+  header.fileSize += bmpData[3];
+  header.fileSize = header.fileSize << 8;
+  header.fileSize += bmpData[2];
   //Data offset
-  header->dataOffset = bmpData[13];
-  header->dataOffset = header->dataOffset << 8;
-  header->dataOffset += bmpData[12];
-  header->dataOffset = header->dataOffset << 8;
-  header->dataOffset += bmpData[11];
-  header->dataOffset = header->dataOffset << 8;
-  header->dataOffset += bmpData[10];
+  header.dataOffset = bmpData[13];
+  header.dataOffset = header.dataOffset << 8;
+  header.dataOffset += bmpData[12];
+  header.dataOffset = header.dataOffset << 8;
+  header.dataOffset += bmpData[11];
+  header.dataOffset = header.dataOffset << 8;
+  header.dataOffset += bmpData[10];
   //DibSIZE
-  header->dibSize = bmpData[17];
-  header->dibSize = header->dibSize << 8;
-  header->dibSize += bmpData[16];
-  header->dibSize = header->dibSize << 8;
-  header->dibSize += bmpData[15];
-  header->dibSize = header->dibSize << 8;
-  header->dibSize += bmpData[14];
+  header.dibSize = bmpData[17];
+  header.dibSize = header.dibSize << 8;
+  header.dibSize += bmpData[16];
+  header.dibSize = header.dibSize << 8;
+  header.dibSize += bmpData[15];
+  header.dibSize = header.dibSize << 8;
+  header.dibSize += bmpData[14];
   //Width
-  header->width = bmpData[21];
-  header->width = header->width << 8;
-  header->width += bmpData[20];
-  header->width = header->width << 8;
-  header->width += bmpData[19];
-  header->width = header->width << 8;
-  header->width += bmpData[18];
+  header.width = bmpData[21];
+  header.width = header.width << 8;
+  header.width += bmpData[20];
+  header.width = header.width << 8;
+  header.width += bmpData[19];
+  header.width = header.width << 8;
+  header.width += bmpData[18];
   //Height
-  header->height = bmpData[25];
-  header->height = header->height << 8;
-  header->height += bmpData[24];
-  header->height = header->height << 8;
-  header->height += bmpData[23];
-  header->height = header->height << 8;
-  header->height += bmpData[22];
+  header.height = bmpData[25];
+  header.height = header.height << 8;
+  header.height += bmpData[24];
+  header.height = header.height << 8;
+  header.height += bmpData[23];
+  header.height = header.height << 8;
+  header.height += bmpData[22];
+  //A negative height means rows are stored top to bottom
+  header.topDown = (header.height & 0x80000000) != 0;
+  if (header.topDown) {
+    if (header.height == 0x80000000) {
+      return false;
+    }
+    header.height = ~header.height + 1;
+  }
   //Color Planes
-  header->colorPlanes = bmpData[27];
-  header->colorPlanes = header->colorPlanes << 8;
-  header->colorPlanes += bmpData[26];
+  header.colorPlanes = bmpData[27];
+  header.colorPlanes = header.colorPlanes << 8;
+  header.colorPlanes += bmpData[26];
   //Bits per pixel
-  header->bitsPerPixel = bmpData[29];
-  header->bitsPerPixel = header->bitsPerPixel << 8;
-  header->bitsPerPixel += bmpData[28];
+  header.bitsPerPixel = bmpData[29];
+  header.bitsPerPixel = header.bitsPerPixel << 8;
+  header.bitsPerPixel += bmpData[28];
   //biRgb
-  header->biRgb = bmpData[33];
-  header->biRgb = header->biRgb << 8;
-  header->biRgb += bmpData[32];
-  header->biRgb = header->biRgb << 8;
-  header->biRgb += bmpData[31];
-  header->biRgb = header->biRgb << 8;
-  header->biRgb += bmpData[30];
+  header.biRgb = bmpData[33];
+  header.biRgb = header.biRgb << 8;
+  header.biRgb += bmpData[32];
+  header.biRgb = header.biRgb << 8;
+  header.biRgb += bmpData[31];
+  header.biRgb = header.biRgb << 8;
+  header.biRgb += bmpData[30];
   //DataSize
-  header->dataSize = bmpData[37];
-  header->dataSize = header->dataSize << 8;
-  header->dataSize += bmpData[36];
-  header->dataSize = header->dataSize << 8;
-  header->dataSize += bmpData[35];
-  header->dataSize = header->dataSize << 8;
-  header->dataSize += bmpData[34];
+  header.dataSize = bmpData[37];
+  header.dataSize = header.dataSize << 8;
+  header.dataSize += bmpData[36];
+  header.dataSize = header.dataSize << 8;
+  header.dataSize += bmpData[35];
+  header.dataSize = header.dataSize << 8;
+  header.dataSize += bmpData[34];
   //Print size W
-  header->printSizeW = bmpData[41];
-  header->printSizeW = header->printSizeW << 8;
-  header->printSizeW += bmpData[40];
-  header->printSizeW = header->printSizeW << 8;
-  header->printSizeW += bmpData[39];
-  header->printSizeW = header->printSizeW << 8;
-  header->printSizeW += bmpData[38];
+  header.printSizeW = bmpData[41];
+  header.printSizeW = header.printSizeW << 8;
+  header.printSizeW += bmpData[40];
+  header.printSizeW = header.printSizeW << 8;
+  header.printSizeW += bmpData[39];
+  header.printSizeW = header.printSizeW << 8;
+  header.printSizeW += bmpData[38];
   //Print size H
-  header->printSizeH = bmpData[45];
-  header->printSizeH = header->printSizeH << 8;
-  header->printSizeH += bmpData[44];
-  header->printSizeH = header->printSizeH << 8;
-  header->printSizeH += bmpData[43];
-  header->printSizeH = header->printSizeH << 8;
-  header->printSizeH += bmpData[42];
+  header.printSizeH = bmpData[45];
+  header.printSizeH = header.printSizeH << 8;
+  header.printSizeH += bmpData[44];
+  header.printSizeH = header.printSizeH << 8;
+  header.printSizeH += bmpData[43];
+  header.printSizeH = header.printSizeH << 8;
+  header.printSizeH += bmpData[42];
   //Palette Size
-  header->paletteSize = bmpData[49];
-  header->paletteSize = header->paletteSize << 8;
-  header->paletteSize += bmpData[48];
-  header->paletteSize = header->paletteSize << 8;
-  header->paletteSize += bmpData[47];
-  header->paletteSize = header->paletteSize << 8;
-  header->paletteSize += bmpData[46];
+  header.paletteSize = bmpData[49];
+  header.paletteSize = header.paletteSize << 8;
+  header.paletteSize += bmpData[48];
+  header.paletteSize = header.paletteSize << 8;
+  header.paletteSize += bmpData[47];
+  header.paletteSize = header.paletteSize << 8;
+  header.paletteSize += bmpData[46];
   //Important Colors
-  header->importantColors = bmpData[53];
-  header->importantColors = header->importantColors << 8;
-  header->importantColors += bmpData[52];
-  header->importantColors = header->importantColors << 8;
-  header->importantColors += bmpData[51];
-  header->importantColors = header->importantColors << 8;
-  header->importantColors += bmpData[50];
+  header.importantColors = bmpData[53];
+  header.importantColors = header.importantColors << 8;
+  header.importantColors += bmpData[52];
+  header.importantColors = header.importantColors << 8;
+  header.importantColors += bmpData[51];
+  header.importantColors = header.importantColors << 8;
+  header.importantColors += bmpData[50];
+
+  //Data offset must be after header
+  if (header.dataOffset < 54) {
+    return false;
+  }
+
+  return true;
+
+}
+
+/**
+ * @function decodeBmp
+ * @description decode Bmp data buffer filling header struct
+ * @param uint8_t*
+ * @param size_t
+ * @returns bool
+**/
+
+bool Bmp::decodeBmp(uint8_t* bmpData, size_t dataSize) {
+
+  //Delete previous header if exists
+  if (header != nullptr) {
+    delete header;
+  }
+
+  header = new Header();
+  if (!decodeHeader(bmpData, dataSize, *header)) {
+    return false;
+  }
+  //Dib data must be inside the buffer
+  if (header->dataOffset > dataSize) {
+    return false;
+  }
 
   //Save dibData
   size_t dibDataSize = header->dataOffset - 54;
+  delete[] dibData;
   dibData = new uint8_t[dibDataSize];
   memcpy(dibData, bmpData + 54, dibDataSize);
 
@@ -267,6 +356,110 @@ bool Bmp::decodeBmp(uint8_t* bmpData, size_t dataSize) {
 
 }
 
+/**
+ * @function decodeRegion
+ * @description decode the header of Bmp data buffer and check that the area (offsets are from the top left corner) is inside the image.
+ * Pixels of the area are decoded by the classes which extend Bmp
+ * @param uint8_t*
+ * @param size_t
+ * @param size_t xOffset
+ * @param size_t yOffset
+ * @param size_t width
+ * @param size_t height
+ * @returns bool
+**/
+
+bool Bmp::decodeRegion(uint8_t* bmpData, size_t dataSize, size_t xOffset, size_t yOffset, size_t width, size_t height) {
+
+  if (!Bmp::decodeBmp(bmpData, dataSize)) {
+    return false;
+  }
+  if (width == 0 || height == 0 || width > header->width || height > header->height) {
+    return false;
+  }
+  return xOffset <= header->width - width && yOffset <= header->height - height;
+
+}
+
+/**
+ * @function decodeScaled
+ * @description decode Bmp data buffer downscaling it to width x height (which can't be bigger than the image).
+ * Each pixel is the average of a box of pixels, computed while reading the rows, so the image is never decoded at its full size
+ * @param uint8_t*
+ * @param size_t
+ * @param size_t width
+ * @param size_t height
+ * @returns bool
+**/
+
+bool Bmp::decodeScaled(uint8_t* bmpData, size_t dataSize, size_t width, size_t height) {
+  return decodeDownscaled(bmpData, dataSize, width, height);
+}
+
+/**
+ * @function decodeScaled
+ * @description decode Bmp data buffer downscaling it by factor (see decodeScaled); sizes are rounded up
+ * @param uint8_t*
+ * @param size_t
+ * @param ScaleFactor
+ * @returns bool
+**/
+
+bool Bmp::decodeScaled(uint8_t* bmpData, size_t dataSize, ScaleFactor factor) {
+  Header fileHeader;
+  if (!decodeHeader(bmpData, dataSize, fileHeader)) {
+    return false;
+  }
+  size_t divisor = static_cast<size_t>(factor);
+  return decodeDownscaled(bmpData, dataSize, (fileHeader.width + divisor - 1) / divisor, (fileHeader.height + divisor - 1) / divisor);
+}
+
+/**
+ * @function decodeDownscaled
+ * @description decode the header of Bmp data buffer and check that the image can be downscaled to width x height.
+ * Pixels are downscaled by the classes which extend Bmp
+ * @param uint8_t*
+ * @param size_t
+ * @param size_t width
+ * @param size_t height
+ * @returns bool
+**/
+
+bool Bmp::decodeDownscaled(uint8_t* bmpData, size_t dataSize, size_t width, size_t height) {
+
+  if (!Bmp::decodeBmp(bmpData, dataSize)) {
+    return false;
+  }
+  return width > 0 && height > 0 && width <= header->width && height <= header->height;
+
+}
+
+/**
+ * @function hasRaster
+ * @description returns whether the uncompressed raster described by header is inside a buffer of dataSize bytes;
+ * the last row may lack its padding. Sizes are compared by division, so huge widths or heights can't overflow
+ * @param size_t
+ * @returns bool
+**/
+
+bool Bmp::hasRaster(size_t dataSize) {
+
+  if (header == nullptr || header->dataOffset > dataSize) {
+    return false;
+  }
+  if (header->height == 0) {
+    return true;
+  }
+  size_t rasterSize = dataSize - header->dataOffset;
+  size_t rowSize = PixelBuffer::strideFor(header->width, header->bitsPerPixel);
+  size_t realRowSize = (static_cast<size_t>(header->width) * header->bitsPerPixel + 7) / 8;
+  if (realRowSize > rasterSize) {
+    return false;
+  }
+  return rowSize == 0 || header->height - 1 <= (rasterSize - realRowSize) / rowSize;
+
+}
+
 /**
  * @function encodeBmp
  * @description: encodes bitmap to buffer; only header is encoded in Bmp class
@@ -280,96 +473,579 @@ uint8_t* Bmp::encodeBmp(size_t& dataSize) {
     return nullptr;
   }
 
-  //Get our fundamental parameters
-  size_t nextMultipleOf4 = roundToMultiple(header->width * (header->bitsPerPixel / 8), 4);
-  size_t paddingSize = nextMultipleOf4 - header->width * (header->bitsPerPixel / 8);
-  size_t totalRowSize = (header->width * (header->bitsPerPixel / 8)) + paddingSize;
-  //Recalc dataSize
-  int pxDataSize = totalRowSize * header->height;
-  //Recalc dataSize
-  header->dataSize = pxDataSize;
   //We need to allocate the buffer now (dataOffset + dataSize)
-  dataSize = header->dataOffset + header->dataSize;
+  dataSize = getEncodedSize();
   uint8_t* bmpData = new uint8_t[dataSize];
+  encodeHeader(bmpData);
+  return bmpData;
+
+}
+
+/**
+ * @function getEncodedSize
+ * @description: updates header data and file size and returns the size of the encoded bitmap
+ * @returns size_t
+**/
+
+size_t Bmp::getEncodedSize() {
+
+  //Get our fundamental parameters
+  size_t totalRowSize = PixelBuffer::strideFor(header->width, header->bitsPerPixel);
+  //Recalc dataSize
+  header->dataSize = totalRowSize * header->height;
+  header->fileSize = header->dataOffset + header->dataSize;
+  return header->fileSize;
+}
+
+/**
+ * @function encodeHeader
+ * @description: encodes header and dib data (dataOffset bytes) to buffer; getEncodedSize must be called before
+ * @param uint8_t*
+**/
+
+void Bmp::encodeHeader(uint8_t* bmpData) {
+
+  encodeHeader(*header, bmpData);
+  //Store to bmpData dbData
+  if (dibData != nullptr) {
+    memcpy(bmpData + 54, dibData, (header->dataOffset - 54));
+  }
+}
+
+/**
+ * @function encodeHeader
+ * @description: encodes the BMP file header and the BITMAPINFOHEADER fields (54 bytes) to buffer
+ * @param const Header&
+ * @param uint8_t*
+**/
+
+void Bmp::encodeHeader(const Header& header, uint8_t* bmpData) {
+
   //Fill header
   bmpData[0] = 'B';
   bmpData[1] = 'M';
   //FileSize
-  bmpData[2] = dataSize;
-  bmpData[3] = dataSize >> 8;
-  bmpData[4] = dataSize >> 16;
-  bmpData[5] = dataSize >> 24;
+  bmpData[2] = header.fileSize;
+  bmpData[3] = header.fileSize >> 8;
+  bmpData[4] = header.fileSize >> 16;
+  bmpData[5] = header.fileSize >> 24;
   //Reserved
   bmpData[6] = 0;
   bmpData[7] = 0;
   bmpData[8] = 0;
   bmpData[9] = 0;
   //Data offset
-  bmpData[10] = header->dataOffset;
-  bmpData[11] = header->dataOffset >> 8;
-  bmpData[12] = header->dataOffset >> 16;
-  bmpData[13] = header->dataOffset >> 24;
+  bmpData[10] = header.dataOffset;
+  bmpData[11] = header.dataOffset >> 8;
+  bmpData[12] = header.dataOffset >> 16;
+  bmpData[13] = header.dataOffset >> 24;
   //DibSize
-  bmpData[14] = header->dibSize;
-  bmpData[15] = header->dibSize >> 8;
-  bmpData[16] = header->dibSize >> 16;
-  bmpData[17] = header->dibSize >> 24;
+  bmpData[14] = header.dibSize;
+  bmpData[15] = header.dibSize >> 8;
+  bmpData[16] = header.dibSize >> 16;
+  bmpData[17] = header.dibSize >> 24;
   //Width
-  bmpData[18] = header->width;
-  bmpData[19] = header->width >> 8;
-  bmpData[20] = header->width >> 16;
-  bmpData[21] = header->width >> 24;
-  //Height
-  bmpData[22] = header->height;
-  bmpData[23] = header->height >> 8;
-  bmpData[24] = header->height >> 16;
-  bmpData[25] = header->height >> 24;
+  bmpData[18] = header.width;
+  bmpData[19] = header.width >> 8;
+  bmpData[20] = header.width >> 16;
+  bmpData[21] = header.width >> 24;
+  //Height (negative if rows are stored top to bottom)
+  uint32_t height = header.topDown ? ~header.height + 1 : header.height;
+  bmpData[22] = height;
+  bmpData[23] = height >> 8;
+  bmpData[24] = height >> 16;
+  bmpData[25] = height >> 24;
   //Color planes
-  bmpData[26] = header->colorPlanes;
-  bmpData[27] = header->colorPlanes >> 8;
+  bmpData[26] = header.colorPlanes;
+  bmpData[27] = header.colorPlanes >> 8;
   //Bits per pixel
-  bmpData[28] = header->bitsPerPixel;
-  bmpData[29] = header->bitsPerPixel >> 8;
+  bmpData[28] = header.bitsPerPixel;
+  bmpData[29] = header.bitsPerPixel >> 8;
   //biRgb
-  bmpData[30] = header->biRgb;
-  bmpData[31] = header->biRgb >> 8;
-  bmpData[32] = header->biRgb >> 16;
-  bmpData[33] = header->biRgb >> 24;
+  bmpData[30] = header.biRgb;
+  bmpData[31] = header.biRgb >> 8;
+  bmpData[32] = header.biRgb >> 16;
+  bmpData[33] = header.biRgb >> 24;
   //DataSize
-  bmpData[34] = header->dataSize;
-  bmpData[35] = header->dataSize >> 8;
-  bmpData[36] = header->dataSize >> 16;
-  bmpData[37] = header->dataSize >> 24;
+  bmpData[34] = header.dataSize;
+  bmpData[35] = header.dataSize >> 8;
+  bmpData[36] = header.dataSize >> 16;
+  bmpData[37] = header.dataSize >> 24;
   //Print size w
-  bmpData[38] = header->printSizeW;
-  bmpData[39] = header->printSizeW >> 8;
-  bmpData[40] = header->printSizeW >> 16;
-  bmpData[41] = header->printSizeW >> 24;
+  bmpData[38] = header.printSizeW;
+  bmpData[39] = header.printSizeW >> 8;
+  bmpData[40] = header.printSizeW >> 16;
+  bmpData[41] = header.printSizeW >> 24;
   //Print size H
-  bmpData[42] = header->printSizeH;
-  bmpData[43] = header->printSizeH >> 8;
-  bmpData[44] = header->printSizeH >> 16;
-  bmpData[45] = header->printSizeH >> 24;
+  bmpData[42] = header.printSizeH;
+  bmpData[43] = header.printSizeH >> 8;
+  bmpData[44] = header.printSizeH >> 16;
+  bmpData[45] = header.printSizeH >> 24;
   //Palette
-  bmpData[46] = 0;
-  bmpData[47] = 0;
-  bmpData[48] = 0;
-  bmpData[49] = 0;
-  //Important colors 0
-  bmpData[50] = 0;
-  bmpData[51] = 0;
-  bmpData[52] = 0;
-  bmpData[53] = 0;
-  //Store to bmpData dbData
-  memcpy(bmpData + 54, dibData, (header->dataOffset - 54));
+  bmpData[46] = header.paletteSize;
+  bmpData[47] = header.paletteSize >> 8;
+  bmpData[48] = header.paletteSize >> 16;
+  bmpData[49] = header.paletteSize >> 24;
+  //Important colors
+  bmpData[50] = header.importantColors;
+  bmpData[51] = header.importantColors >> 8;
+  bmpData[52] = header.importantColors >> 16;
+  bmpData[53] = header.importantColors >> 24;
 
-  return bmpData;
+}
+
+/**
+ * @function readBmp
+ * @description read a BMP file and decodes it. The decoded Bmp becomes the object.
+ * The file is memory mapped and decoded from the mapping; if it can't be mapped, it is read into a buffer
+ * @param const std::string& bmpFile
+ * @returns bool
+ */
+
+bool Bmp::readBmp(const std::string& bmpFile) {
+  return readFile(bmpFile, true, [this](uint8_t* bmpData, size_t dataSize) {
+    return decodeBmp(bmpData, dataSize);
+  });
+}
+
+/**
+ * @function readRegion
+ * @description read an area of a BMP file (see decodeRegion). The file is memory mapped, so only the rows of the area are read
+ * @param const std::string& bmpFile
+ * @param size_t xOffset
+ * @param size_t yOffset
+ * @param size_t width
+ * @param size_t height
+ * @returns bool
+ */
+
+bool Bmp::readRegion(const std::string& bmpFile, size_t xOffset, size_t yOffset, size_t width, size_t height) {
+  return readFile(bmpFile, false, [this, xOffset, yOffset, width, height](uint8_t* bmpData, size_t dataSize) {
+    return decodeRegion(bmpData, dataSize, xOffset, yOffset, width, height);
+  });
+}
+
+/**
+ * @function readScaled
+ * @description read a BMP file downscaling it to width x height (see decodeScaled)
+ * @param const std::string& bmpFile
+ * @param size_t width
+ * @param size_t height
+ * @returns bool
+ */
+
+bool Bmp::readScaled(const std::string& bmpFile, size_t width, size_t height) {
+  return readFile(bmpFile, true, [this, width, height](uint8_t* bmpData, size_t dataSize) {
+    return decodeScaled(bmpData, dataSize, width, height);
+  });
+}
+
+/**
+ * @function readScaled
+ * @description read a BMP file downscaling it by factor (see decodeScaled)
+ * @param const std::string& bmpFile
+ * @param ScaleFactor factor
+ * @returns bool
+ */
+
+bool Bmp::readScaled(const std::string& bmpFile, ScaleFactor factor) {
+  return readFile(bmpFile, true, [this, factor](uint8_t* bmpData, size_t dataSize) {
+    return decodeScaled(bmpData, dataSize, factor);
+  });
+}
+
+/**
+ * @function readFile
+ * @description memory map a file (or read it into a buffer if it can't be mapped) and decode it with decode
+ * @param const std::string& bmpFile
+ * @param bool sequential: whether the whole file is going to be read
+ * @param const std::function<bool(uint8_t*, size_t)>& decode
+ * @returns bool
+ */
+
+bool Bmp::readFile(const std::string& bmpFile, bool sequential, const std::function<bool(uint8_t*, size_t)>& decode) {
+#ifdef BMP_USE_MMAP
+  int fd = open(bmpFile.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat fileStat;
+  void* mappedFile = MAP_FAILED;
+  size_t mappedSize = 0;
+  if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0) {
+    mappedSize = static_cast<size_t>(fileStat.st_size);
+    mappedFile = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  //The mapping stays valid after the file is closed
+  close(fd);
+  if (mappedFile != MAP_FAILED) {
+#ifdef HAVE_MADVISE
+    madvise(mappedFile, mappedSize, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+#endif
+    //Decode (decoding doesn't write to the buffer)
+    bool rc = decode(static_cast<uint8_t*>(mappedFile), mappedSize);
+    munmap(mappedFile, mappedSize);
+    return rc;
+  }
+#endif
+  //Fallback: read the whole file into a buffer
+  std::ifstream iFile;
+  iFile.open(bmpFile, std::ios::binary | std::ios::ate);
+  if (!iFile.is_open()) {
+    return false;
+  }
+  std::streamsize size = iFile.tellg();
+  iFile.seekg(0, std::ios::beg);
+  char* dataBuffer = new char[size];
+  if (!iFile.read(dataBuffer, size)) {
+    delete[] dataBuffer;
+    return false;
+  }
+  iFile.close();
+  //Decode
+  bool rc = decode(reinterpret_cast<uint8_t*>(dataBuffer), size);
+  delete[] dataBuffer;
+  return rc;
+}
+
+/**
+ * @function writeBmp
+ * @description encode BMP write the buffer to a file.
+ * BI_RGB rasters are written straight from the pixel buffer, right after the header
+ * @param const std::string& bmpFile
+ * @returns bool
+ */
+
+bool Bmp::writeBmp(const std::string& bmpFile) {
+  if (header == nullptr) {
+    return false;
+  }
+  std::ofstream outFile;
+  size_t outDataSize = getEncodedSize();
+  bool rawRaster = header->biRgb == 0 && pixelBuffer.getBitsPerPixel() == header->bitsPerPixel && pixelBuffer.getDataSize() == header->dataSize;
+  if (rawRaster) {
+    std::vector<uint8_t> headerData(header->dataOffset);
+    encodeHeader(headerData.data());
+    //Write file
+    outFile.open(bmpFile, std::ios::binary);
+    if (!outFile.is_open()) {
+      return false;
+    }
+    outFile.write(reinterpret_cast<const char*>(headerData.data()), headerData.size());
+    if (pixelBuffer.getData() != nullptr && !header->topDown) {
+      outFile.write(reinterpret_cast<const char*>(pixelBuffer.getData()), pixelBuffer.getDataSize());
+    } else if (pixelBuffer.getData() != nullptr) {
+      //Rows are stored bottom to top, the file is top to bottom
+      for (size_t row = header->height; row > 0; row--) {
+        outFile.write(reinterpret_cast<const char*>(pixelBuffer.getRow(row - 1)), pixelBuffer.getStride());
+      }
+    }
+  } else {
+    uint8_t* outBuf = encodeBmp(outDataSize);
+    if (outBuf == nullptr) {
+      return false;
+    }
+    //Write file
+    outFile.open(bmpFile, std::ios::binary);
+    if (!outFile.is_open()) {
+      delete[] outBuf;
+      return false;
+    }
+    outFile.write(reinterpret_cast<const char*>(outBuf), outDataSize);
+    delete[] outBuf;
+  }
+  outFile.close();
+  return !outFile.fail();
+}
+
+#if defined(__SSE2__)
+/**
+ * @function loadPixels
+ * @description load a block of pixels: 16 bytes, or 12 bytes (4 pixels) of 3 bytes pixels, so that no byte past the block is read
+ * @param const uint8_t*
+ * @returns __m128i
+**/
+
+template <size_t bytesPerPixel>
+static inline __m128i loadPixels(const uint8_t* pixels) {
+  if (bytesPerPixel != 3) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+  }
+  uint32_t last;
+  memcpy(&last, pixels + 8, 4);
+  return _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels)), _mm_cvtsi32_si128(static_cast<int>(last)));
+}
+
+/**
+ * @function storePixels
+ * @description store a block of pixels loaded by loadPixels
+ * @param uint8_t*
+ * @param __m128i
+**/
+
+template <size_t bytesPerPixel>
+static inline void storePixels(uint8_t* pixels, __m128i block) {
+  if (bytesPerPixel != 3) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels), block);
+    return;
+  }
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(pixels), block);
+  uint32_t last = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(block, 8)));
+  memcpy(pixels + 8, &last, 4);
+}
+#endif
+
+/**
+ * @function transposePixels4
+ * @description copy a 4x4 block of 4 bytes pixels transposed: dst row i is made of the pixels i of the 4 src rows
+ * @param const uint8_t* first pixel of the first src row
+ * @param ptrdiff_t distance between src rows
+ * @param uint8_t* first pixel of the first dst row
+ * @param ptrdiff_t distance between dst rows
+**/
+
+static inline void transposePixels4(const uint8_t* src, ptrdiff_t srcStep, uint8_t* dst, ptrdiff_t dstStep) {
+#if defined(__SSE2__)
+  __m128i row0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  __m128i row1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + srcStep));
+  __m128i row2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (2 * srcStep)));
+  __m128i row3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (3 * srcStep)));
+  __m128i low01 = _mm_unpacklo_epi32(row0, row1);
+  __m128i low23 = _mm_unpacklo_epi32(row2, row3);
+  __m128i high01 = _mm_unpackhi_epi32(row0, row1);
+  __m128i high23 = _mm_unpackhi_epi32(row2, row3);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi64(low01, low23));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + dstStep), _mm_unpackhi_epi64(low01, low23));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + (2 * dstStep)), _mm_unpacklo_epi64(high01, high23));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + (3 * dstStep)), _mm_unpackhi_epi64(high01, high23));
+#else
+  for (ptrdiff_t i = 0; i < 4; i++) {
+    for (ptrdiff_t j = 0; j < 4; j++) {
+      memcpy(dst + (i * dstStep) + (j * 4), src + (j * srcStep) + (i * 4), 4);
+    }
+  }
+#endif
+}
+
+/**
+ * @function transposePixels3
+ * @description copy a 4x4 block of 3 bytes pixels transposed (see transposePixels4)
+ * @param const uint8_t* first pixel of the first src row
+ * @param ptrdiff_t distance between src rows
+ * @param uint8_t* first pixel of the first dst row
+ * @param ptrdiff_t distance between dst rows
+**/
+
+static inline void transposePixels3(const uint8_t* src, ptrdiff_t srcStep, uint8_t* dst, ptrdiff_t dstStep) {
+#if defined(__SSSE3__)
+  //Pixels are widened to 4 bytes, transposed and packed again; rows are read and written 12 bytes at a time
+  const __m128i widenMask = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  const __m128i packMask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+  __m128i rows[4];
+  for (size_t i = 0; i < 4; i++) {
+    rows[i] = _mm_shuffle_epi8(loadPixels<3>(src + (static_cast<ptrdiff_t>(i) * srcStep)), widenMask);
+  }
+  __m128i low01 = _mm_unpacklo_epi32(rows[0], rows[1]);
+  __m128i low23 = _mm_unpacklo_epi32(rows[2], rows[3]);
+  __m128i high01 = _mm_unpackhi_epi32(rows[0], rows[1]);
+  __m128i high23 = _mm_unpackhi_epi32(rows[2], rows[3]);
+  rows[0] = _mm_unpacklo_epi64(low01, low23);
+  rows[1] = _mm_unpackhi_epi64(low01, low23);
+  rows[2] = _mm_unpacklo_epi64(high01, high23);
+  rows[3] = _mm_unpackhi_epi64(high01, high23);
+  for (size_t i = 0; i < 4; i++) {
+    storePixels<3>(dst + (static_cast<ptrdiff_t>(i) * dstStep), _mm_shuffle_epi8(rows[i], packMask));
+  }
+#else
+  for (ptrdiff_t i = 0; i < 4; i++) {
+    for (ptrdiff_t j = 0; j < 4; j++) {
+      memcpy(dst + (i * dstStep) + (j * 3), src + (j * srcStep) + (i * 3), 3);
+    }
+  }
+#endif
+}
+
+/**
+ * @function rotateRows
+ * @description fill rows firstRow to lastRow - 1 of dst with src rotated by 90 (clockwise) or 270 degrees.
+ * Rows of dst are columns of src: pixels are copied by square tiles, so that the src rows of a tile stay in cache,
+ * and 4x4 blocks of 3 and 4 bytes pixels are transposed with SIMD shuffles
+ * @param PixelBuffer& src
+ * @param PixelBuffer& dst
+ * @param bool clockwise
+ * @param size_t firstRow
+ * @param size_t lastRow
+**/
+
+template <size_t bytesPerPixel>
+static void rotateRows(PixelBuffer& src, PixelBuffer& dst, bool clockwise, size_t firstRow, size_t lastRow) {
+
+  size_t srcWidth = src.getWidth();
+  size_t srcHeight = src.getHeight();
+  if (srcHeight == 0) {
+    return;
+  }
+  //Column c of dst row r is pixel (clockwise ? srcWidth - 1 - r : r) of src row (clockwise ? c : srcHeight - 1 - c)
+  ptrdiff_t srcStep = static_cast<ptrdiff_t>(src.getStride());
+  ptrdiff_t dstStep = static_cast<ptrdiff_t>(dst.getStride());
+  const uint8_t* firstSrcRow = src.getRow(0);
+  if (!clockwise) {
+    firstSrcRow = src.getRow(srcHeight - 1);
+    srcStep = -srcStep;
+  }
+  for (size_t tileRow = firstRow; tileRow < lastRow; tileRow += ROTATE_TILE_SIZE) {
+    size_t tileRowEnd = (tileRow + ROTATE_TILE_SIZE < lastRow) ? tileRow + ROTATE_TILE_SIZE : lastRow;
+    for (size_t tileColumn = 0; tileColumn < srcHeight; tileColumn += ROTATE_TILE_SIZE) {
+      size_t tileColumnEnd = (tileColumn + ROTATE_TILE_SIZE < srcHeight) ? tileColumn + ROTATE_TILE_SIZE : srcHeight;
+      const uint8_t* srcTile = firstSrcRow + (static_cast<ptrdiff_t>(tileColumn) * srcStep);
+      size_t row = tileRow;
+      if (bytesPerPixel == 3 || bytesPerPixel == 4) {
+        //4 dst rows are 4 adjacent src columns: the first one of a clockwise rotation is the last of them
+        for (; row + 4 <= tileRowEnd; row += 4) {
+          size_t srcColumn = clockwise ? srcWidth - 4 - row : row;
+          ptrdiff_t blockStep = clockwise ? -dstStep : dstStep;
+          uint8_t* dstRow = dst.getRow(clockwise ? row + 3 : row);
+          size_t column = tileColumn;
+          for (; column + 4 <= tileColumnEnd; column += 4) {
+            const uint8_t* srcPixel = srcTile + (static_cast<ptrdiff_t>(column - tileColumn) * srcStep) + (srcColumn * bytesPerPixel);
+            if (bytesPerPixel == 4) {
+              transposePixels4(srcPixel, srcStep, dstRow + (column * 4), blockStep);
+            } else {
+              transposePixels3(srcPixel, srcStep, dstRow + (column * 3), blockStep);
+            }
+          }
+          //Remaining columns of the tile
+          for (size_t i = 0; i < 4; i++) {
+            size_t blockRow = clockwise ? row + 3 - i : row + i;
+            const uint8_t* srcPixel = srcTile + (static_cast<ptrdiff_t>(column - tileColumn) * srcStep) + ((srcColumn + i) * bytesPerPixel);
+            uint8_t* dstPixel = dst.getRow(blockRow) + (column * bytesPerPixel);
+            for (size_t j = column; j < tileColumnEnd; j++, srcPixel += srcStep, dstPixel += bytesPerPixel) {
+              memcpy(dstPixel, srcPixel, bytesPerPixel);
+            }
+          }
+        }
+      }
+      for (; row < tileRowEnd; row++) {
+        size_t srcColumn = clockwise ? srcWidth - 1 - row : row;
+        const uint8_t* srcPixel = srcTile + (srcColumn * bytesPerPixel);
+        uint8_t* dstPixel = dst.getRow(row) + (tileColumn * bytesPerPixel);
+        for (size_t column = tileColumn; column < tileColumnEnd; column++, srcPixel += srcStep, dstPixel += bytesPerPixel) {
+          memcpy(dstPixel, srcPixel, bytesPerPixel);
+        }
+      }
+    }
+  }
+  //dst is not cleared: set padding
+  size_t rowSize = srcHeight * bytesPerPixel;
+  for (size_t row = firstRow; row < lastRow; row++) {
+    memset(dst.getRow(row) + rowSize, 0x00, dst.getStride() - rowSize);
+  }
+
+}
+
+/**
+ * @function swapRows
+ * @description swap the content of two rows of size bytes, 16 bytes at a time
+ * @param uint8_t*
+ * @param uint8_t*
+ * @param size_t
+**/
+
+static void swapRows(uint8_t* upperRow, uint8_t* lowerRow, size_t size) {
+  size_t offset = 0;
+#if defined(__SSE2__)
+  for (; offset + 16 <= size; offset += 16) {
+    __m128i upper = _mm_loadu_si128(reinterpret_cast<const __m128i*>(upperRow + offset));
+    __m128i lower = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lowerRow + offset));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(upperRow + offset), lower);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lowerRow + offset), upper);
+  }
+#endif
+  for (; offset < size; offset++) {
+    uint8_t swapByte = upperRow[offset];
+    upperRow[offset] = lowerRow[offset];
+    lowerRow[offset] = swapByte;
+  }
+}
+
+/**
+ * @function reversePixels
+ * @description reverse the order of the pixels of a block loaded by loadPixels
+ * @param __m128i
+ * @returns __m128i
+**/
+
+#if defined(__SSE2__)
+template <size_t bytesPerPixel>
+static inline __m128i reversePixels(__m128i pixels) {
+  if (bytesPerPixel == 4) {
+    return _mm_shuffle_epi32(pixels, 0x1B);
+  }
+  if (bytesPerPixel == 2) {
+    pixels = _mm_shuffle_epi32(pixels, 0x4E);
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, 0x1B), 0x1B);
+  }
+#if defined(__SSSE3__)
+  if (bytesPerPixel == 3) {
+    return _mm_shuffle_epi8(pixels, _mm_setr_epi8(9, 10, 11, 6, 7, 8, 3, 4, 5, 0, 1, 2, -1, -1, -1, -1));
+  }
+  return _mm_shuffle_epi8(pixels, _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+#else
+  //Bytes: reverse the words, then the bytes of each word (3 bytes pixels need SSSE3)
+  pixels = reversePixels<2>(pixels);
+  return _mm_or_si128(_mm_slli_epi16(pixels, 8), _mm_srli_epi16(pixels, 8));
+#endif
+}
+#endif
+
+/**
+ * @function reverseRows
+ * @description rotate by 180 degrees the pair of rows upperRow and lowerRow (pixel j of one becomes pixel width - 1 - j of the other).
+ * If they're the same row, the row is reversed
+ * @param uint8_t* upperRow
+ * @param uint8_t* lowerRow
+ * @param size_t width
+**/
+
+template <size_t bytesPerPixel>
+static void reverseRows(uint8_t* upperRow, uint8_t* lowerRow, size_t width) {
+
+  //On the middle row stop at the middle pixel
+  size_t columns = (upperRow == lowerRow) ? width / 2 : width;
+  size_t column = 0;
+#if defined(__SSE2__)
+  //A block from both ends at a time; 3 bytes pixels need SSSE3
+#if defined(__SSSE3__)
+  const bool simd = true;
+#else
+  const bool simd = bytesPerPixel != 3;
+#endif
+  const size_t blockPixels = (bytesPerPixel == 3) ? 4 : 16 / bytesPerPixel;
+  //Blocks of the middle row end before its middle pixel, so they can't overlap
+  for (; simd && column + blockPixels <= columns; column += blockPixels) {
+    uint8_t* leftPixels = upperRow + (column * bytesPerPixel);
+    uint8_t* rightPixels = lowerRow + ((width - blockPixels - column) * bytesPerPixel);
+    __m128i left = loadPixels<bytesPerPixel>(leftPixels);
+    __m128i right = loadPixels<bytesPerPixel>(rightPixels);
+    storePixels<bytesPerPixel>(leftPixels, reversePixels<bytesPerPixel>(right));
+    storePixels<bytesPerPixel>(rightPixels, reversePixels<bytesPerPixel>(left));
+  }
+#endif
+  uint8_t swapPixel[bytesPerPixel];
+  for (; column < columns; column++) {
+    uint8_t* leftPixel = upperRow + (column * bytesPerPixel);
+    uint8_t* rightPixel = lowerRow + ((width - 1 - column) * bytesPerPixel);
+    memcpy(swapPixel, leftPixel, bytesPerPixel);
+    memcpy(leftPixel, rightPixel, bytesPerPixel);
+    memcpy(rightPixel, swapPixel, bytesPerPixel);
+  }
 
 }
 
 /**
  * @function rotate
- * @description: rotates the image by a multiple of 90
+ * @description: rotates the image by a multiple of 90 (clockwise; negative degrees rotate counterclockwise).
+ * 90 and 270 degrees rotations copy pixels to a new raster by tiles, 180 degrees rotations swap pixels in place
  * @param int
  * @returns bool
 **/
@@ -384,10 +1060,35 @@ bool Bmp::rotate(int degrees) {
     return false;
   }
 
+  degrees = ((degrees % 360) + 360) % 360;
   uint32_t previousWidth = header->width;
   uint32_t previousHeight = header->height;
+  size_t bytesPerPixel = pixelBuffer.getBytesPerPixel();
 
   if (degrees == 90 || degrees == 270) {
+    //Create rotated buffer; all its pixels are overwritten
+    PixelBuffer rotatedBuffer;
+    if (!rotatedBuffer.allocate(previousHeight, previousWidth, pixelBuffer.getBitsPerPixel(), false)) {
+      return false;
+    }
+    bool clockwise = degrees == 90;
+    forEachBand(previousWidth, rotatedBuffer.getRowSize(), [this, &rotatedBuffer, clockwise, bytesPerPixel](size_t firstRow, size_t lastRow) {
+      switch (bytesPerPixel) {
+      case 1:
+        rotateRows<1>(pixelBuffer, rotatedBuffer, clockwise, firstRow, lastRow);
+        break;
+      case 2:
+        rotateRows<2>(pixelBuffer, rotatedBuffer, clockwise, firstRow, lastRow);
+        break;
+      case 3:
+        rotateRows<3>(pixelBuffer, rotatedBuffer, clockwise, firstRow, lastRow);
+        break;
+      default:
+        rotateRows<4>(pixelBuffer, rotatedBuffer, clockwise, firstRow, lastRow);
+        break;
+      }
+    });
+    pixelBuffer.swap(rotatedBuffer);
     //Exchange header attributes
     //Update width and height
     header->height = previousWidth;
@@ -396,71 +1097,29 @@ bool Bmp::rotate(int degrees) {
     uint32_t transitionAttr = header->printSizeH;
     header->printSizeH = header->printSizeW;
     header->printSizeW = transitionAttr;
-  }
-
-  std::vector<std::vector<Pixel*>> currentPixelMatrix;
-  int counter = -1;
-  //Store pixels in a matrix
-  for (size_t row = 0; row < previousHeight; row++) {
-    std::vector<Pixel*> rowVector;
-    for (size_t column = 0; column < previousWidth; column++) {
-      rowVector.push_back(pixelArray.at(++counter));
-    }
-    currentPixelMatrix.push_back(rowVector);
-  }
-
-  if (degrees == 270 || degrees == 90) {
-    std::vector<std::vector<Pixel*>> rotatedPixelMatrix;
-    //Create rotated matrix
-    counter = -1;
-    for (size_t row = 0; row < previousWidth; row++) {
-      std::vector<Pixel*> rowVector;
-      for (size_t column = 0; column < previousHeight; column++) {
-        rowVector.push_back(pixelArray.at(++counter));
-      }
-      rotatedPixelMatrix.push_back(rowVector);
-    }
-    if (degrees == 270) {
-      //Rotate 270 degrees
-      for (size_t i = 0; i < previousHeight; i++) {
-        for (size_t j = 0; j < previousWidth; j++) {
-          rotatedPixelMatrix.at(j).at(previousHeight - 1 - i) = currentPixelMatrix.at(i).at(j);
-        }
-      }
-    } else {
-      //Rotate 90 degrees
-      for (size_t i = 0; i < previousHeight; i++) {
-        for (size_t j = 0; j < previousWidth; j++) {
-         rotatedPixelMatrix.at(previousWidth - 1 - j).at(i) = currentPixelMatrix.at(i).at(j);
-        }
-      }
-    }
-    //Convert rotated matrix to pixelArray
-    counter = -1;
-    for (size_t row = 0; row < previousWidth; row++) {
-      for (size_t column = 0; column < previousHeight; column++) {
-        pixelArray.at(++counter) = rotatedPixelMatrix.at(row).at(column);
-      }
-    }
   } else if (degrees == 180) {
-    //Swap elements to rotate image
-    for (size_t i = 0; i < previousHeight; i++) {
-      for (size_t j = 0, k = previousWidth - 1; j < k; j++, k--) {
-        std::swap(currentPixelMatrix.at(i).at(j), currentPixelMatrix.at(i).at(k));
-      }
-    }
-    for (size_t j = 0; j < previousWidth; j++) {
-      for (size_t i = 0, k = previousHeight - 1; i < k; i++, k--) {
-        std::swap(currentPixelMatrix.at(i).at(j), currentPixelMatrix.at(k).at(j));
-      }
-    }
-    //Convert rotated matrix to pixelArray
-    counter = -1;
-    for (size_t row = 0; row < previousHeight; row++) {
-      for (size_t column = 0; column < previousWidth; column++) {
-        pixelArray.at(++counter) = currentPixelMatrix.at(row).at(column);
+    //Swap rows i and height - 1 - i, reversing them
+    size_t pairs = (static_cast<size_t>(previousHeight) + 1) / 2;
+    forEachBand(pairs, pixelBuffer.getRowSize() * 2, [this, previousWidth, previousHeight, bytesPerPixel](size_t firstRow, size_t lastRow) {
+      for (size_t row = firstRow; row < lastRow; row++) {
+        uint8_t* upperRow = pixelBuffer.getRow(row);
+        uint8_t* lowerRow = pixelBuffer.getRow(previousHeight - 1 - row);
+        switch (bytesPerPixel) {
+        case 1:
+          reverseRows<1>(upperRow, lowerRow, previousWidth);
+          break;
+        case 2:
+          reverseRows<2>(upperRow, lowerRow, previousWidth);
+          break;
+        case 3:
+          reverseRows<3>(upperRow, lowerRow, previousWidth);
+          break;
+        default:
+          reverseRows<4>(upperRow, lowerRow, previousWidth);
+          break;
+        }
       }
-    }
+    });
   }
   return true;
 }
@@ -472,12 +1131,12 @@ bool Bmp::rotate(int degrees) {
 **/
 
 bool Bmp::flipHorizontal() {
-  return this->flip(FlipType::VERTICAL);
+  return this->flip(FlipType::HORIZONTAL);
 }
 
 /**
- * @function flipHorizontal
- * @description flip image horizontally
+ * @function flipVertical
+ * @description flip image vertically
  * @returns bool
 **/
 
@@ -487,7 +1146,8 @@ bool Bmp::flipVertical() {
 
 /**
  * @function resizeArea
- * @description resize area (does not scale image), both enlarging or scaling it
+ * @description resize area (does not scale image), both enlarging or scaling it. Each side larger than before places the image at its offset;
+ * each side smaller than before is cropped starting from its offset. The new area is computed in a single pass
  * @param size_t width
  * @param size_t height
  * @param size_t xOffset (optional)
@@ -497,35 +1157,45 @@ bool Bmp::flipVertical() {
 
 bool Bmp::resizeArea(size_t width, size_t height, size_t xOffset /* = 0*/, size_t yOffset /* = 0*/) {
 
-  while (header->width != width || header->height != height) {
-    size_t currWidth = header->width;
-    size_t currHeight = header->height;
-    //Resize image in order to match user requests; start with enlarging if necessary
-    if (width > currWidth || height > currHeight) {
-      //Pass higher size or current one to enlarge
-      size_t enlargedWidth = (width > currWidth) ? width : currWidth;
-      size_t enlargedHeight = (height > currHeight) ? height : currHeight;
-      //Initialize Pixel lambda
-      std::function<void(Pixel*)> initializePixel = [](Pixel* px) { px = new Pixel(); };
-      if (!enlargeArea(enlargedWidth, enlargedHeight, initializePixel, xOffset, yOffset)) {
-        return false;
-      }
-      continue;
+  if (header == nullptr) {
+    return false;
+  }
+  //Turn offsets into the position of the new area in the current image
+  long long areaX = 0;
+  long long areaY = 0;
+  if (width > header->width) {
+    areaX = -static_cast<long long>(xOffset);
+  } else if (width < header->width) {
+    //Cropped area must be inside the image
+    if (xOffset > header->width - width) {
+      return false;
     }
-    //Also, scale area if necessary
-    if (width < currWidth || height << currHeight) {
-      //Pass lower size or current one to scale
-      size_t scaledWidth = (width < currWidth) ? width : currWidth;
-      size_t scaledHeight = (height < currHeight) ? height : currHeight;
-      //Scale image
-      if (!scaleArea(scaledWidth, scaledHeight, xOffset, yOffset)) {
-        return false;
-      }
-      continue;
+    areaX = static_cast<long long>(xOffset);
+  }
+  if (height > header->height) {
+    areaY = -static_cast<long long>(yOffset);
+  } else if (height < header->height) {
+    if (yOffset > header->height - height) {
+      return false;
     }
+    areaY = static_cast<long long>(yOffset);
   }
-  //Return OK
-  return true;
+  return resizeCanvas(width, height, areaX, areaY);
+}
+
+/**
+ * @function resizeCanvas
+ * @description resize the canvas to width x height; new pixel (x, y) from the top left corner is pixel (x + xOffset, y + yOffset) of the current image.
+ * Offsets can be negative and the area can exceed the image on any side: pixels outside of the image are set to 0
+ * @param size_t width
+ * @param size_t height
+ * @param long long xOffset
+ * @param long long yOffset
+ * @returns bool
+**/
+
+bool Bmp::resizeCanvas(size_t width, size_t height, long long xOffset, long long yOffset) {
+  return copyArea(width, height, xOffset, yOffset, nullptr);
 }
 
 /**
@@ -543,6 +1213,34 @@ bool Bmp::resizeImage(size_t width, size_t height) {
   return true;
 }
 
+/**
+ * @function resizeImage
+ * @description resize image (not only area) resampling it with the provided filter
+ * @param size_t
+ * @param size_t
+ * @param Filter
+ * @returns bool
+**/
+
+bool Bmp::resizeImage(size_t width, size_t height, Filter /* filter */) {
+  //Pixel manipulation must be done by subclasses
+  return Bmp::resizeImage(width, height);
+}
+
+/**
+ * @function buildPyramid
+ * @description build the levels of an image pyramid, each one half the size of the previous one (2x2 box filter).
+ * Implemented by BmpImage; Bmpmonochrome is not supported and always returns false
+ * @param size_t levels
+ * @param BmpPyramid& pyramid
+ * @returns bool
+**/
+
+bool Bmp::buildPyramid(size_t /* levels */, BmpPyramid& /* pyramid */) {
+  //Pixel manipulation must be done by subclasses
+  return false;
+}
+
 /**
  * @function getWidth
  * @description: returns the image width
@@ -581,9 +1279,53 @@ uint16_t Bmp::getBitsPerPixel() {
   return header->bitsPerPixel;
 }
 
+/**
+ * @function setTopDown
+ * @description set the orientation of the encoded bitmap: rows top to bottom (negative height) or bottom to top (default).
+ * Decoding sets it as in the decoded bitmap; pixels are accessed the same way in both cases
+ * @param bool
+**/
+
+void Bmp::setTopDown(bool topDown) {
+  if (header != nullptr) {
+    header->topDown = topDown;
+  }
+}
+
+/**
+ * @function isTopDown
+ * @description returns whether the bitmap is encoded with rows top to bottom
+ * @returns bool
+**/
+
+bool Bmp::isTopDown() {
+  return header != nullptr && header->topDown;
+}
+
+/**
+ * @function setThreads
+ * @description set the amount of threads used to decode and encode the image (1 by default, 0 to use all the hardware threads).
+ * Images are split into bands of rows; small images are always processed by the calling thread
+ * @param size_t
+**/
+
+void Bmp::setThreads(size_t threads) {
+  this->threads = threads == 0 ? ThreadPool::getHardwareThreads() : threads;
+}
+
+/**
+ * @function getThreads
+ * @description returns the amount of threads used to decode and encode the image
+ * @returns size_t
+**/
+
+size_t Bmp::getThreads() {
+  return threads;
+}
+
 /**
  * @function flip
- * @description: flip image horizontally or vertically based on argument
+ * @description: flip image horizontally or vertically based on argument; rows are swapped or reversed in place
  * @param FlipType
  * @returns bool
 **/
@@ -599,57 +1341,40 @@ bool Bmp::flip(FlipType flipType) {
     return false;
   }
 
+  size_t bytesPerPixel = pixelBuffer.getBytesPerPixel();
+  size_t width = header->width;
+  size_t height = header->height;
+
   //Apply vertical flip
   if (flipType == FlipType::VERTICAL) {
-    //Apply horizontal flip
-    std::vector<std::vector<Pixel*>> pixelMatrix;
-    int counter = -1;
-    //Store pixels in a matrix
-    for (size_t row = 0; row < header->height; row++) {
-      std::vector<Pixel*> rowVector;
-      for (size_t column = 0; column < header->width; column++) {
-        rowVector.push_back(pixelArray.at(++counter));
-      }
-      pixelMatrix.push_back(rowVector);
-    }
-    for (size_t row = 0; row < header->height / 2; row++) {
-      std::swap(pixelMatrix.at(row), pixelMatrix.at(header->height - 1 - row));
-    }
-    //Convert rotated matrix to pixelArray
-    counter = -1;
-    for (size_t row = 0; row < header->height; row++) {
-      for (size_t column = 0; column < header->width; column++) {
-        pixelArray.at(++counter) = pixelMatrix.at(row).at(column);
-      }
-    }
-  } else if (flipType == FlipType::HORIZONTAL) { 
-    //Apply horizontal flip
-    std::vector<std::vector<Pixel*>> pixelMatrix;
-    int counter = -1;
-    //Store pixels in a matrix
-    for (size_t row = 0; row < header->height; row++) {
-      std::vector<Pixel*> rowVector;
-      for (size_t column = 0; column < header->width; column++) {
-        rowVector.push_back(pixelArray.at(++counter));
+    //Swap rows in place
+    size_t stride = pixelBuffer.getStride();
+    forEachBand(height / 2, stride * 2, [this, stride, height](size_t firstRow, size_t lastRow) {
+      for (size_t row = firstRow; row < lastRow; row++) {
+        swapRows(pixelBuffer.getRow(row), pixelBuffer.getRow(height - 1 - row), stride);
       }
-      pixelMatrix.push_back(rowVector);
-    }
-    //Flip horizontally
-    counter = -1;
-    for (size_t row = 0; row < header->height; row++) {
-      //Save counter at new line
-      int beginRowCounter = counter;
-      for (size_t column = 0; column < header->width / 2; column++) {
-        //Swap elements on a row
-        std::swap(pixelMatrix.at(row).at(column), pixelMatrix.at(row).at(header->width - 1 - column));
-        //Put left side element on left side of row in pixel array
-        pixelArray.at(++counter) = pixelMatrix.at(row).at(column);
-        //Put right side element on right side of row in pixel array
-        pixelArray.at((header->width - column) + beginRowCounter) = pixelMatrix.at(row).at(header->width - 1 - column);
+    });
+  } else if (flipType == FlipType::HORIZONTAL) {
+    //Apply horizontal flip: reverse each row in place
+    forEachBand(height, pixelBuffer.getStride(), [this, width, bytesPerPixel](size_t firstRow, size_t lastRow) {
+      for (size_t row = firstRow; row < lastRow; row++) {
+        uint8_t* rowData = pixelBuffer.getRow(row);
+        switch (bytesPerPixel) {
+        case 1:
+          reverseRows<1>(rowData, rowData, width);
+          break;
+        case 2:
+          reverseRows<2>(rowData, rowData, width);
+          break;
+        case 3:
+          reverseRows<3>(rowData, rowData, width);
+          break;
+        default:
+          reverseRows<4>(rowData, rowData, width);
+          break;
+        }
       }
-      //Add to counter missing part to finish line
-      counter += header->width / 2;
-    }
+    });
   }
   return true;
 }
@@ -669,217 +1394,94 @@ bool Bmp::scaleArea(size_t width, size_t height, size_t xOffset /* = 0 */, size_
   //Out image is bigger than current image (@! enlarge)
   if (width + xOffset > header->width || height + yOffset > header->height) {
     return false;
-  } else {
-    //Since pixels are stored bottom to top, we need to flip and then resize the matrix
-    if (!flipVertical()) {
-      return false;
-    }
-    //If offset is set cut starting from offset
-    if (xOffset > 0 || yOffset > 0) {
-      //Flip horizontally
-      if (!flipHorizontal()) {
-        return false;
-      }
-      //Resize passing offsets as width and height
-      if (!scaleArea(header->width - xOffset, header->height - yOffset)) {
-        return false;
-      }
-      //Reflip horizontally
-      if (!flipHorizontal()) {
-        return false;
-      }
-    }
-    //Convert image to matrix
-    std::vector<std::vector<Pixel*>> pixelMatrix;
-    //Store pixels in a matrix
-    size_t counter = 0;
-    for (size_t row = 0; row < header->height; row++) {
-      std::vector<Pixel*> rowVector;
-      for (size_t column = 0; column < header->width; column++) {
-        rowVector.push_back(pixelArray.at(counter));
-        counter++;
-      }
-      pixelMatrix.push_back(rowVector);
-    }
-    //Cut image
-    std::vector<std::vector<Pixel*>> resizedPixelMatrix = pixelMatrix;
-    //Resize height
-    resizedPixelMatrix.resize(height);
-    //Resize each row
-    for (size_t i = 0; i < height; i++) {
-      resizedPixelMatrix.at(i).resize(width);
-    }
-    //Delete out of bounds pixels
-    size_t count = 0;
-    //Delete all rows elements which have been cut off
-    for (size_t i = height; i < header->height; i++) {
-      for (size_t j = 0; j < header->width; j++) {
-        delete pixelMatrix.at(i).at(j);
-        count++;
-      }
-    }
-    //Delete cut columns
-    for (size_t i = 0; i < height; i++) {
-      for (size_t j = width; j < header->width; j++) {
-        delete pixelMatrix.at(i).at(j);
-        count++;
-      }
-    }
-
-    //Convert matrix to array
-    pixelArray.clear();
-    for (size_t row = 0; row < height; row++) {
-      for (size_t column = 0; column < width; column++) {
-        pixelArray.push_back(resizedPixelMatrix.at(row).at(column));
-      }
-    }
-
-    //Update BMP header
-    header->width = width;
-    header->height = height;
-    //Re-flip image
-    if (!flipVertical()) {
-      return false;
-    }
-    return true;
   }
+  return copyArea(width, height, static_cast<long long>(xOffset), static_cast<long long>(yOffset), nullptr);
 }
 
 /**
  * @function enlarge
- * @description enlarge image following the enlargement type passed (this function just adds pixels). A transformation function can be called to pixels which are created
+ * @description enlarge image following the enlargement type passed (this function just adds pixels). New pixels are set to fillPixel
  * @param size_t
  * @param size_t
- * @param std::function<void(Pixel*)> functions which initializes and instances a pixel
+ * @param const uint8_t* bytes of the pixel to set on new pixels
  * @param size_t
  * @param size_t
  * @returns bool
 **/
 
-bool Bmp::enlargeArea(size_t width, size_t height, std::function<void(Pixel*&)> initializePixel, size_t xOffset /* = 0*/, size_t yOffset /* = 0*/) {
+bool Bmp::enlargeArea(size_t width, size_t height, const uint8_t* fillPixel, size_t xOffset /* = 0*/, size_t yOffset /* = 0*/) {
 
   //Check if image will be actually be enlarged
   if (width <= header->width && height <= header->height) {
     return false;
   }
-  //Store previous size
+  //Previous image is placed at offset (from the top left corner); cut what exceeds the new size
+  return copyArea(width, height, -static_cast<long long>(xOffset), -static_cast<long long>(yOffset), fillPixel);
+}
+
+/**
+ * @function copyArea
+ * @description replace the image with a width x height area, whose pixel (x, y) from the top left corner is pixel (x + xOffset, y + yOffset)
+ * of the current image, or fillPixel (0 if nullptr) when outside of it. The new buffer is allocated once and rows are copied as spans
+ * @param size_t width
+ * @param size_t height
+ * @param long long xOffset
+ * @param long long yOffset
+ * @param const uint8_t* bytes of the pixel to set outside of the image
+ * @returns bool
+**/
+
+bool Bmp::copyArea(size_t width, size_t height, long long xOffset, long long yOffset, const uint8_t* fillPixel) {
+
+  if (header == nullptr) {
+    return false;
+  }
   size_t prevWidth = header->width;
   size_t prevHeight = header->height;
-  //Since pixels are stored bottom to top, we need to flip and then resize the matrix
-  if (!flipVertical()) {
+  size_t bytesPerPixel = pixelBuffer.getBytesPerPixel();
+  PixelBuffer areaBuffer;
+  if (!areaBuffer.allocate(width, height, pixelBuffer.getBitsPerPixel(), false)) {
     return false;
   }
-  //Convert image to matrix
-  std::vector<std::vector<Pixel*>> pixelMatrix;
-  //Store pixels in a matrix
-  size_t counter = 0;
-  for (size_t row = 0; row < header->height; row++) {
-    std::vector<Pixel*> rowVector;
-    for (size_t column = 0; column < header->width; column++) {
-      rowVector.push_back(pixelArray.at(counter));
-      counter++;
-    }
-    pixelMatrix.push_back(rowVector);
-  }
-  //Handle offset in X
-  if (xOffset > 0) {
-    //We need to add n element at the beginning of each row
-    for (size_t row = 0; row < prevHeight; row++) {
-      std::vector<Pixel*> rowVector = pixelMatrix.at(row);
-      std::vector<Pixel*> rowWithOffset;
-      //Add offset
-      for (size_t column = 0; column < xOffset; column++) {
-        //Add new pixel and transform it
-        Pixel* pixelToAdd = nullptr;
-        //Transform pixel
-        initializePixel(pixelToAdd);
-        if (pixelToAdd == nullptr) {
-          pixelToAdd = new Pixel();
-        }
-        //Add pixel to row vector
-        rowWithOffset.push_back(pixelToAdd);
-      }
-      //Finally add to rowWithOffset rowVector
-      rowWithOffset.insert(std::end(rowWithOffset), std::begin(rowVector), std::end(rowVector));
-      pixelMatrix.at(row) = rowWithOffset;
-    }
-    //Update prevWidth with prevWidth + xOffset
-    prevWidth += xOffset;
-  }
-  //Handle offset in Y
-  if (yOffset > 0) {
-    //We need to add n rows at the top of the image
-    std::vector<std::vector<Pixel*>> offsetMatrix;
-    for (size_t row = 0; row < yOffset; row++) {
-      std::vector<Pixel*> rowVector;
-      for (size_t column = 0; column < prevWidth; column++) {
-        //Add new pixel and transform it
-        Pixel* pixelToAdd = nullptr;
-        //Transform pixel
-        initializePixel(pixelToAdd);
-        if (pixelToAdd == nullptr) {
-          pixelToAdd = new Pixel();
-        }
-        //Add pixel to row vector
-        rowVector.push_back(pixelToAdd);
-      }
-      //Add to offsetMatrix row Vector
-      offsetMatrix.push_back(rowVector);
-    }
-    //Add to offsetMatrix pixelMatrix
-    offsetMatrix.insert(std::end(offsetMatrix), std::begin(pixelMatrix), std::end(pixelMatrix));
-    //Pixel matrix becomes offsetMatrix
-    pixelMatrix = offsetMatrix;
-    //Update prevWidth with prevWidth + yOffset
-    prevHeight += yOffset;
-  }
-  //Start with adding pixels on X on currently existing rows
-  for (size_t row = 0; row < prevHeight; row++) {
-    std::vector<Pixel*> rowVector = pixelMatrix.at(row);
-    for (size_t column = prevWidth; column < width; column++) {
-      //Add new pixel and transform it
-      Pixel* pixelToAdd = nullptr;
-      //Transform pixel
-      initializePixel(pixelToAdd);
-      if (pixelToAdd == nullptr) {
-        pixelToAdd = new Pixel();
-      }
-      //Add pixel to row vector
-      rowVector.push_back(pixelToAdd);
-    }
-    pixelMatrix.at(row) = rowVector;
-  }
-  //Now add pixels on Y with width = newWidth
-  for (size_t row = prevHeight; row < height; row++) {
-    std::vector<Pixel*> rowVector;
-    for (size_t column = 0; column < width; column++) {
-      //Add new pixel and transform it
-      Pixel* pixelToAdd = nullptr;
-      //Transform pixel
-      initializePixel(pixelToAdd);
-      if (pixelToAdd == nullptr) {
-        pixelToAdd = new Pixel();
+  //Columns [firstColumn, lastColumn) of the new area come from the image
+  long long firstColumn = xOffset < 0 ? -xOffset : 0;
+  long long lastColumn = static_cast<long long>(prevWidth) - xOffset;
+  if (lastColumn > static_cast<long long>(width)) {
+    lastColumn = static_cast<long long>(width);
+  }
+  if (lastColumn < firstColumn) {
+    lastColumn = firstColumn = 0;
+  }
+  //Prepare a whole row of fill pixels, then each row is made of fill, image span, fill
+  size_t rowSize = width * bytesPerPixel;
+  std::vector<uint8_t> fillRow(rowSize, 0);
+  for (size_t column = 0; fillPixel != nullptr && column < width; column++) {
+    memcpy(fillRow.data() + (column * bytesPerPixel), fillPixel, bytesPerPixel);
+  }
+  size_t stride = areaBuffer.getStride();
+  size_t spanBegin = static_cast<size_t>(firstColumn) * bytesPerPixel;
+  size_t spanEnd = static_cast<size_t>(lastColumn) * bytesPerPixel;
+  //The span starts at column firstColumn + xOffset (never negative) of the image rows
+  size_t srcBegin = static_cast<size_t>(firstColumn + xOffset) * bytesPerPixel;
+  forEachBand(height, stride, [&, this](size_t firstRow, size_t lastRow) {
+    for (size_t row = firstRow; row < lastRow; row++) {
+      uint8_t* dstRow = areaBuffer.getRow(height - 1 - row);
+      long long srcRow = static_cast<long long>(row) + yOffset;
+      if (srcRow < 0 || srcRow >= static_cast<long long>(prevHeight) || spanBegin == spanEnd) {
+        memcpy(dstRow, fillRow.data(), rowSize);
+      } else {
+        const uint8_t* srcData = pixelBuffer.getRow(prevHeight - 1 - static_cast<size_t>(srcRow)) + srcBegin;
+        memcpy(dstRow, fillRow.data(), spanBegin);
+        memcpy(dstRow + spanBegin, srcData, spanEnd - spanBegin);
+        memcpy(dstRow + spanEnd, fillRow.data() + spanEnd, rowSize - spanEnd);
       }
-      //Add pixel to row vector
-      rowVector.push_back(pixelToAdd);
+      memset(dstRow + rowSize, 0, stride - rowSize);
     }
-    //Add rowVector to pixel matrix
-    pixelMatrix.push_back(rowVector);
-  }
+  });
+  pixelBuffer.swap(areaBuffer);
   //Update header
   header->width = width;
   header->height = height;
-  //Convert matrix into array
-  pixelArray.clear();
-  for (size_t row = 0; row < height; row++) {
-    for (size_t column = 0; column < width; column++) {
-      pixelArray.push_back(pixelMatrix.at(row).at(column));
-    }
-  }
-  //Re-flip image
-  if (!flipVertical()) {
-    return false;
-  }
   return true;
 }
 
@@ -901,3 +1503,29 @@ int Bmp::roundToMultiple(int toRound, int multiple) {
 
   return toRound + multiple - remainder;
 }
+
+/**
+ * @function forEachBand
+ * @description split rows into bands and run task(firstRow, lastRow + 1) for each band on the thread pool.
+ * Bands are at least MIN_BAND_SIZE bytes long; with a single band, task is run on the calling thread
+ * @param size_t
+ * @param size_t
+ * @param const std::function<void(size_t, size_t)>&
+**/
+
+void Bmp::forEachBand(size_t rows, size_t rowSize, const std::function<void(size_t, size_t)>& task) {
+
+  size_t bands = threads;
+  size_t maxBands = rowSize > 0 ? (rows * rowSize) / MIN_BAND_SIZE : 0;
+  if (bands > maxBands) {
+    bands = maxBands;
+  }
+  if (bands <= 1) {
+    task(0, rows);
+    return;
+  }
+  ThreadPool::getDefault().run(bands, [rows, bands, &task](size_t band) {
+    task((rows * band) / bands, (rows * (band + 1)) / bands);
+  });
+
+}
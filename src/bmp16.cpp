@@ -23,7 +23,8 @@
 
 #include <bmp16.hpp>
 
-#include <fstream>
+#include <cstring>
+#include <vector>
 
 #ifdef BMP_DEBUG
 #include <iostream>
@@ -32,13 +33,50 @@
 
 namespace bmp {
 
+/**
+ * @function unpackRow
+ * @description unpack a row of RGB555 pixels into three 16 bits channels (blue, green, red); 5 bits values are scaled to the whole word
+ * @param const uint16_t* pixels
+ * @param uint16_t* channels
+ * @param size_t width
+**/
+
+static void unpackRow(const uint16_t* pixels, uint16_t* channels, size_t width) {
+  for (size_t column = 0; column < width; column++, channels += 3) {
+    uint16_t pixel = pixels[column];
+    for (size_t channel = 0; channel < 3; channel++) {
+      uint16_t value = (pixel >> (channel * 5)) & 0x1F;
+      channels[channel] = static_cast<uint16_t>((value << 11) | (value << 6) | (value << 1) | (value >> 4));
+    }
+  }
+}
+
+/**
+ * @function packRow
+ * @description pack a row of three 16 bits channels (blue, green, red) into RGB555 pixels, rounding to nearest
+ * @param const uint16_t* channels
+ * @param uint16_t* pixels
+ * @param size_t width
+**/
+
+static void packRow(const uint16_t* channels, uint16_t* pixels, size_t width) {
+  for (size_t column = 0; column < width; column++, channels += 3) {
+    uint16_t pixel = 0;
+    for (size_t channel = 0; channel < 3; channel++) {
+      uint32_t value = channels[channel];
+      pixel |= static_cast<uint16_t>(((value * 31) + 32767) / 65535) << (channel * 5);
+    }
+    pixels[column] = pixel;
+  }
+}
+
 /**
  * @function Bmp16
  * @description Bmp16 class constructor
 **/
 
-Bmp16::Bmp16() : Bmp() {
-  pixelArray.clear();
+Bmp16::Bmp16() : BmpImage<WordFormat>() {
+
 }
 
 /**
@@ -49,23 +87,8 @@ Bmp16::Bmp16() : Bmp() {
  * @param uint16_t default color
 **/
 
-Bmp16::Bmp16(size_t width, size_t height, uint16_t defaultColor) : Bmp(width, height) {
-  //Set bits per pixel
-  header->bitsPerPixel = 8;
-  //FileSize must be set by child class
-  size_t nextMultipleOf4 = roundToMultiple(width * (header->bitsPerPixel / 8), 4);
-  size_t paddingSize = nextMultipleOf4 - (header->width * (header->bitsPerPixel / 8));
-  size_t rowSize = paddingSize + ((width * header->bitsPerPixel / 8));
-  size_t dataSize = rowSize * height;
-  header->fileSize = 54 + dataSize;
-  //DataSize must be set by child class
-  header->dataSize = dataSize;
-  //Create empty image
-  size_t arraySize = header->width * header->height;
-  pixelArray.reserve(arraySize);
-  for (size_t i = 0; i < arraySize; i++) {
-    pixelArray.push_back(new WordPixel(defaultColor));
-  }
+Bmp16::Bmp16(size_t width, size_t height, uint16_t defaultColor) : BmpImage<WordFormat>(width, height, WordPixel(defaultColor)) {
+
 }
 
 /**
@@ -74,13 +97,8 @@ Bmp16::Bmp16(size_t width, size_t height, uint16_t defaultColor) : Bmp(width, he
  * @param const Bmp& bmp
  */
 
-Bmp16::Bmp16(const Bmp16& bmp) : Bmp(bmp) {
-  //Copy pixel array to new bmp
-  size_t arraySize = bmp.pixelArray.size();
-  for (size_t i = 0; i < arraySize; i++) {
-    WordPixel* copyPixel = reinterpret_cast<WordPixel*>(bmp.pixelArray.at(i));
-    pixelArray.push_back(new WordPixel(copyPixel->getValue()));
-  }
+Bmp16::Bmp16(const Bmp16& bmp) : BmpImage<WordFormat>(bmp) {
+  //Pixels are copied by Bmp
 }
 
 /**
@@ -89,239 +107,73 @@ Bmp16::Bmp16(const Bmp16& bmp) : Bmp(bmp) {
  * @param const Bmp& bmp
  */
 
-Bmp16::Bmp16(Bmp16* bmp) : Bmp(bmp) {
-  //Copy pixel array to new bmp
-  size_t arraySize = bmp->pixelArray.size();
-  for (size_t i = 0; i < arraySize; i++) {
-    WordPixel* copyPixel = reinterpret_cast<WordPixel*>(bmp->pixelArray.at(i));
-    pixelArray.push_back(new WordPixel(copyPixel->getValue()));
-  }
+Bmp16::Bmp16(Bmp16* bmp) : BmpImage<WordFormat>(bmp) {
+  //Pixels are copied by Bmp
 }
 
 /**
- * @function ~Bmp16
- * @description Bmp16 class destructor
+ * @function operator=
+ * @description Bmp16 class copy assignment
+ * @param const Bmp16& bmp
+ * @returns Bmp16&
 **/
 
-Bmp16::~Bmp16() {
-  
-}
-
-
-bool Bmp16::decodeBmp(uint8_t* bmpData, size_t dataSize) {
-
-  //Call superclass decodeBmp to decode header
-  if (!Bmp::decodeBmp(bmpData, dataSize)) {
-    return false;
-  }
-  //Get data
-  size_t nextMultipleOf4 = roundToMultiple(header->width * (header->bitsPerPixel / 8), 4);
-  size_t paddingSize = nextMultipleOf4 - (header->width * (header->bitsPerPixel / 8));
-  size_t realRowSize = (header->width * (header->bitsPerPixel / 8));
-  size_t rowPositionCounter = 0;
-  for (size_t dataPtr = header->dataOffset - 1; dataPtr < header->fileSize - 1;) {
-    //Store Pixels for each byte
-    uint16_t value = bmpData[++dataPtr] << 8;
-    value += bmpData[++dataPtr];
-    //Create new pixel
-    pixelArray.push_back(new WordPixel(value));
-    rowPositionCounter += 2;
-    //If row has been parsed, go to next line
-    if (rowPositionCounter >= realRowSize) {
-      rowPositionCounter = 0;
-      dataPtr += paddingSize;
-    }
-  }
-  return true;
-
+Bmp16& Bmp16::operator=(const Bmp16& bmp) {
+  BmpImage<WordFormat>::operator=(bmp);
+  return *this;
 }
 
 /**
- * @function encodeBmp
- * @description: encodes bitmap to buffer
- * @param size_t*
- * @returns uint8_t*
+ * @function ~Bmp16
+ * @description Bmp16 class destructor
 **/
 
-uint8_t* Bmp16::encodeBmp(size_t& dataSize) {
-  //Get our fundamental parameters
-  size_t nextMultipleOf4 = roundToMultiple(header->width * (header->bitsPerPixel / 8), 4);
-  size_t paddingSize = nextMultipleOf4 - header->width * (header->bitsPerPixel / 8);
-  size_t realRowSize = (header->width * (header->bitsPerPixel / 8));
-  //Fill header and get bmpData with fixed size
-  uint8_t* bmpData = Bmp::encodeBmp(dataSize);
-  //Return nullptr if needed
-  if (bmpData == nullptr) {
-    return nullptr;
-  }
+Bmp16::~Bmp16() {
   
-  //Fill data
-  int pxIndex = -1;
-  size_t rowPositionCounter = 0;
-  for (size_t dataPtr = header->dataOffset - 1; dataPtr < dataSize - 1;) {
-    //Set pixel
-    WordPixel* currPixel = reinterpret_cast<WordPixel*>(pixelArray.at(++pxIndex));
-    uint16_t value = currPixel->getValue();
-    bmpData[++dataPtr] = value >> 8;
-    bmpData[++dataPtr] = value & 255;
-    //Check if row has to be closed
-    rowPositionCounter += 2;
-    if (rowPositionCounter >= realRowSize) {
-      //Fill row with padding and go on new line
-      rowPositionCounter = 0;
-      for (size_t i = 0; i < paddingSize; i++) {
-        bmpData[++dataPtr] = 0;
-      }
-    }
-  }
-  return bmpData;
 }
 
 /**
- * @function readBmp
- * @description read a BMP file and decodes it. The decoded Bmp becomes the object
- * @param const std::string& bmpFile
+ * @function resizeImage
+ * @description resize image resampling it with the provided filter (see BmpImage::resizeImage). Pixels are RGB555 words, so they are unpacked
+ * to one sample per channel, resampled and packed again; the unused top bit is cleared
+ * @param size_t
+ * @param size_t
+ * @param Filter
  * @returns bool
- */
+**/
 
-bool Bmp16::readBmp(const std::string& bmpFile) {
-  std::ifstream iFile;
-  iFile.open(bmpFile, std::ios::binary | std::ios::ate);
-  if (!iFile.is_open()) {
+bool Bmp16::resizeImage(size_t width, size_t height, Filter filter) {
+  if (header == nullptr) {
     return false;
   }
-  std::streamsize size = iFile.tellg();
-  iFile.seekg(0, std::ios::beg);
-  char* dataBuffer = new char[size];
-  if (!iFile.read(dataBuffer, size)) {
-    delete[] dataBuffer;
+  size_t prevWidth = header->width;
+  PixelBuffer channels;
+  if (!channels.allocate(prevWidth, header->height, 48, false)) {
     return false;
   }
-  iFile.close();
-  //Decode
-  bool rc = decodeBmp(reinterpret_cast<uint8_t*>(dataBuffer), size);
-  delete[] dataBuffer;
-  return rc;
-}
-
-/**
- * @function writeBmp
- * @description encode BMP write the buffer to a file.
- * @param const std::string& bmpFile
- * @returns bool
- */
-
-bool Bmp16::writeBmp(const std::string& bmpFile) {
-  size_t outDataSize;
-  uint8_t* outBuf = encodeBmp(outDataSize);
-  if (outBuf == nullptr) {
+  forEachBand(header->height, channels.getStride(), [&, this](size_t firstRow, size_t lastRow) {
+    for (size_t row = firstRow; row < lastRow; row++) {
+      unpackRow(reinterpret_cast<const uint16_t*>(pixelBuffer.getRow(row)), reinterpret_cast<uint16_t*>(channels.getRow(row)), prevWidth);
+    }
+  });
+  PixelBuffer resizedChannels;
+  if (!resampleBuffers(channels, 3, std::vector<ImageSize>(1, ImageSize{width, height}), std::vector<PixelBuffer*>(1, &resizedChannels), filter)) {
     return false;
   }
-  //Write file
-  std::ofstream outFile;
-  outFile.open(bmpFile);
-  if (!outFile.is_open()) {
-    delete[] outBuf;
+  PixelBuffer resizedBuffer;
+  if (!resizedBuffer.allocate(width, height, 16, false)) {
     return false;
   }
-  for (size_t i = 0; i < outDataSize; i++) {
-    outFile << outBuf[i];
-  }
-  outFile.close();
-  delete[] outBuf;
-  return true;
-}
-
-
-/**
- * @function resizeArea
- * @description resize area (does not scale image), both enlarging or scaling it
- * @param size_t width
- * @param size_t height
- * @param size_t xOffset (optional)
- * @param size_t yOffset (optional)
- * @returns bool
-**/
-
-bool Bmp16::resizeArea(size_t width, size_t height, size_t xOffset /* = 0*/, size_t yOffset /* = 0*/) {
-
-  while (header->width != width || header->height != height) {
-    size_t currWidth = header->width;
-    size_t currHeight = header->height;
-    //Resize image in order to match user requests; start with enlarging if necessary
-    if (width > currWidth || height > currHeight) {
-      //Pass higher size or current one to enlarge
-      size_t enlargedWidth = (width > currWidth) ? width : currWidth;
-      size_t enlargedHeight = (height > currHeight) ? height : currHeight;
-      //Initialize Pixel lambda
-      std::function<void(Pixel*&)> initializePixel = [](Pixel*& px) { px = new WordPixel(65535); };
-      if (!enlargeArea(enlargedWidth, enlargedHeight, initializePixel, xOffset, yOffset)) {
-        return false;
-      }
-      continue;
-    }
-    //Also, scale area if necessary
-    if (width < currWidth || height << currHeight) {
-      //Pass lower size or current one to scale
-      size_t scaledWidth = (width < currWidth) ? width : currWidth;
-      size_t scaledHeight = (height < currHeight) ? height : currHeight;
-      //Scale image
-      if (!scaleArea(scaledWidth, scaledHeight, xOffset, yOffset)) {
-        return false;
-      }
-      continue;
-    }
-  }
-  //Return OK
-  return true;
-}
-
-/**
- * @function resizeImage
- * @description resize image (not only area) applying bilinear image scaling
- * @param size_t
- * @param size_t
- * @returns bool
-**/
-
-bool Bmp16::resizeImage(size_t width, size_t height) {
-  //Apply resizing
-  size_t prevWidth = header->width;
-  size_t prevHeight = header->height;
-  std::vector<Pixel*> resizedArray; //New pixel vector
-  float xRatio = static_cast<float>(prevWidth - 1) / width;
-  float yRatio = static_cast<float>(prevHeight - 1) / height;
-  //Working variables
-  WordPixel *px1, *px2, *px3, *px4;
-  int x, y, index;
-  float xDiff, yDiff;
-  uint16_t value;
-  for (size_t row = 0; row < height; row++) {
-    for (size_t column = 0; column < width; column++) {
-      x = static_cast<int>(xRatio * column);
-      y = static_cast<int>(yRatio * row);
-      xDiff = (xRatio * column) - x;
-      yDiff = (yRatio * row) - y;
-      index = ((y * prevWidth) + x);
-      px1 = reinterpret_cast<WordPixel*>(pixelArray.at(index));
-      px2 = reinterpret_cast<WordPixel*>(pixelArray.at(index + 1));
-      px3 = reinterpret_cast<WordPixel*>(pixelArray.at(index + prevWidth));
-      px4 = reinterpret_cast<WordPixel*>(pixelArray.at(index + prevWidth + 1));
-      //Yb = Ab(1-w)(1-h) + Bb(w)(1-h) + Cb(h)(1-w) + Db(wh)
-      value = (px1->getValue() * (1 - xDiff) * (1 - yDiff)) + (px2->getValue() * (xDiff) * (1 - yDiff)) + (px3->getValue() * (yDiff) * (1 - xDiff)) + (px4->getValue() * (xDiff * yDiff));
-      //Instance new pixel
-      Pixel* resizedPixel = new WordPixel(value);
-      //Push pixel into array
-      resizedArray.push_back(resizedPixel);
+  size_t stride = resizedBuffer.getStride();
+  size_t rowSize = resizedBuffer.getRowSize();
+  forEachBand(height, stride, [&](size_t firstRow, size_t lastRow) {
+    for (size_t row = firstRow; row < lastRow; row++) {
+      uint8_t* dstRow = resizedBuffer.getRow(row);
+      packRow(reinterpret_cast<const uint16_t*>(resizedChannels.getRow(row)), reinterpret_cast<uint16_t*>(dstRow), width);
+      memset(dstRow + rowSize, 0, stride - rowSize);
     }
-  }
-  //Delete all pixels in previous pixel array
-  for (auto& pixel : pixelArray) {
-    WordPixel* px = reinterpret_cast<WordPixel*>(pixel);
-    delete px;
-  }
-  pixelArray = resizedArray;
-  //Change header parameters
+  });
+  pixelBuffer.swap(resizedBuffer);
   return Bmp::resizeImage(width, height);
 }
 
@@ -351,42 +203,12 @@ bool Bmp16::setPixelAt(size_t row, size_t column, uint16_t value) {
 **/
 
 bool Bmp16::setPixelAt(size_t index, uint16_t value) {
-  if (index >= pixelArray.size()) {
+  if (index >= pixelBuffer.getPixelCount()) {
     return false;
   }
-  WordPixel* reqPixel = reinterpret_cast<WordPixel*>(pixelArray.at(index));
+  WordPixel* reqPixel = reinterpret_cast<WordPixel*>(pixelBuffer.getPixel(index));
   reqPixel->setPixel(value);
   return true;
 }
 
-/**
- * @function getPixelAt
- * @description return pointer to pixel in the provided position
- * @param size_t
- * @param size_t
- * @returns WordPixel*
-**/
-
-WordPixel* Bmp16::getPixelAt(size_t row, size_t column) {
-
-  //Get index, considering that pixels are stored bottom to top
-  size_t reversedRow = (header->height - 1 - row); // h - 1 - r
-  size_t index = (header->width * reversedRow) + column;
-  return getPixelAt(index);
-}
-
-/**
- * @function getPixelAt
- * @description return pointer to pixel in the provided position
- * @param size_t
- * @returns WordPixel*
-**/
-
-WordPixel* Bmp16::getPixelAt(size_t index) {
-  if (index >= pixelArray.size()) {
-    return nullptr;
-  }
-  return reinterpret_cast<WordPixel*>(pixelArray.at(index));
-}
-
 }
@@ -22,8 +22,8 @@
 **/
 
 #include <bmp24.hpp>
-
-#include <fstream>
+#include <bmp8.hpp>
+#include <pixels/greyscale.hpp>
 
 #ifdef BMP_DEBUG
 #include <iostream>
@@ -39,8 +39,8 @@ namespace bmp {
  * @description Bmp24 class constructor
 **/
 
-Bmp24::Bmp24() : Bmp() {
-  pixelArray.clear();
+Bmp24::Bmp24() : BmpImage<RGBFormat>() {
+
 }
 
 /**
@@ -53,23 +53,8 @@ Bmp24::Bmp24() : Bmp() {
  * @param uint8_t default blue
 **/
 
-Bmp24::Bmp24(size_t width, size_t height, uint8_t defaultRed, uint8_t defaultGreen, uint8_t defaultBlue) : Bmp(width, height) {
-  //Set bits per pixel
-  header->bitsPerPixel = 24;
-  //FileSize must be set by child class
-  size_t nextMultipleOf4 = roundToMultiple(width * (header->bitsPerPixel / 8), 4);
-  size_t paddingSize = nextMultipleOf4 - (header->width * (header->bitsPerPixel / 8));
-  size_t rowSize = paddingSize + ((width * header->bitsPerPixel / 8));
-  size_t dataSize = rowSize * height;
-  header->fileSize = 54 + dataSize;
-  //DataSize must be set by child class
-  header->dataSize = dataSize;
-  //Create empty image
-  size_t arraySize = header->width * header->height;
-  pixelArray.reserve(arraySize);
-  for (size_t i = 0; i < arraySize; i++) {
-    pixelArray.push_back(new RGBPixel(defaultRed, defaultGreen, defaultBlue));
-  }
+Bmp24::Bmp24(size_t width, size_t height, uint8_t defaultRed, uint8_t defaultGreen, uint8_t defaultBlue) : BmpImage<RGBFormat>(width, height, RGBPixel(defaultRed, defaultGreen, defaultBlue)) {
+
 }
 
 /**
@@ -78,13 +63,8 @@ Bmp24::Bmp24(size_t width, size_t height, uint8_t defaultRed, uint8_t defaultGre
  * @param const Bmp& bmp
  */
 
-Bmp24::Bmp24(const Bmp24& bmp) : Bmp(bmp) {
-  //Copy pixel array to new bmp
-  size_t arraySize = bmp.pixelArray.size();
-  for (size_t i = 0; i < arraySize; i++) {
-    RGBPixel* copyPixel = reinterpret_cast<RGBPixel*>(bmp.pixelArray.at(i));
-    pixelArray.push_back(new RGBPixel(copyPixel->getRed(), copyPixel->getGreen(), copyPixel->getBlue()));
-  }
+Bmp24::Bmp24(const Bmp24& bmp) : BmpImage<RGBFormat>(bmp) {
+  //Pixels are copied by Bmp
 }
 
 /**
@@ -93,164 +73,31 @@ Bmp24::Bmp24(const Bmp24& bmp) : Bmp(bmp) {
  * @param const Bmp& bmp
  */
 
-Bmp24::Bmp24(Bmp24* bmp) : Bmp(bmp) {
-  //Copy pixel array to new bmp
-  size_t arraySize = bmp->pixelArray.size();
-  for (size_t i = 0; i < arraySize; i++) {
-    RGBPixel* copyPixel = reinterpret_cast<RGBPixel*>(bmp->pixelArray.at(i));
-    pixelArray.push_back(new RGBPixel(copyPixel->getRed(), copyPixel->getGreen(), copyPixel->getBlue()));
-  }
-}
-
-/**
- * @function ~Bmp24
- * @description Bmp24 class destructor
-**/
-
-Bmp24::~Bmp24() {
-  
+Bmp24::Bmp24(Bmp24* bmp) : BmpImage<RGBFormat>(bmp) {
+  //Pixels are copied by Bmp
 }
 
 /**
- * @function decodeBmp
- * @description decode Bmp data buffer converting it to header struct and RGBPixel array
- * @param uint8_t*
- * @param size_t
- * @returns bool
+ * @function operator=
+ * @description Bmp24 class copy assignment
+ * @param const Bmp24& bmp
+ * @returns Bmp24&
 **/
 
-
-bool Bmp24::decodeBmp(uint8_t* bmpData, size_t dataSize) {
-
-  //Call superclass decodeBmp to decode header
-  if (!Bmp::decodeBmp(bmpData, dataSize)) {
-    return false;
-  }
-
-  //Get data
-  size_t nextMultipleOf4 = roundToMultiple(header->width * (header->bitsPerPixel / 8), 4);
-  size_t paddingSize = nextMultipleOf4 - (header->width * (header->bitsPerPixel / 8));
-  size_t realRowSize = (header->width * (header->bitsPerPixel / 8));
-  size_t rowPositionCounter = 0;
-  for (size_t dataPtr = header->dataOffset - 1; dataPtr < header->fileSize - 1;) {
-    //Store Pixels for each byte NOTE: BMP is BGR
-    uint8_t blue = bmpData[++dataPtr];
-    uint8_t green = bmpData[++dataPtr];
-    uint8_t red = bmpData[++dataPtr];
-    //Create new pixel
-    pixelArray.push_back(new RGBPixel(red, green, blue));
-    rowPositionCounter += 3;
-    //If row has been parsed, go to next line
-    if (rowPositionCounter >= realRowSize) {
-      rowPositionCounter = 0;
-      dataPtr += paddingSize;
-    }
-  }
-
-  return true;
+Bmp24& Bmp24::operator=(const Bmp24& bmp) {
+  BmpImage<RGBFormat>::operator=(bmp);
+  return *this;
 }
 
 /**
- * @function encodeBmp
- * @description: encodes bitmap to buffer
- * @param size_t*
- * @returns uint8_t*
+ * @function ~Bmp24
+ * @description Bmp24 class destructor
 **/
 
-uint8_t* Bmp24::encodeBmp(size_t& dataSize) {  
-
-  //Get our fundamental parameters
-  size_t nextMultipleOf4 = roundToMultiple(header->width * (header->bitsPerPixel / 8), 4);
-  size_t paddingSize = nextMultipleOf4 - header->width * (header->bitsPerPixel / 8);
-  size_t realRowSize = (header->width * (header->bitsPerPixel / 8));
-  //Fill header and get bmpData with fixed size
-  uint8_t* bmpData = Bmp::encodeBmp(dataSize);
-  //Return nullptr if needed
-  if (bmpData == nullptr) {
-    return nullptr;
-  }
+Bmp24::~Bmp24() {
   
-  //Fill data
-  int pxIndex = -1;
-  size_t rowPositionCounter = 0;
-  for (size_t dataPtr = header->dataOffset - 1; dataPtr < dataSize - 1;) {
-    if (++pxIndex >= static_cast<int>(pixelArray.size())) {
-      break;
-    }
-    //Set pixel
-    RGBPixel* currPixel = reinterpret_cast<RGBPixel*>(pixelArray.at(pxIndex));
-    bmpData[++dataPtr] = currPixel->getBlue();
-    bmpData[++dataPtr] = currPixel->getGreen();
-    bmpData[++dataPtr] = currPixel->getRed();
-    //Check if row has to be closed
-    rowPositionCounter += 3;
-    if (rowPositionCounter >= realRowSize) {
-      //Fill row with padding and go on new line
-      rowPositionCounter = 0;
-      for (size_t i = 0; i < paddingSize; i++) {
-        bmpData[++dataPtr] = 0;
-      }
-    }
-  }
-  return bmpData;
-}
-
-/**
- * @function readBmp
- * @description read a BMP file and decodes it. The decoded Bmp becomes the object
- * @param const std::string& bmpFile
- * @returns bool
- */
-
-bool Bmp24::readBmp(const std::string& bmpFile) {
-  std::ifstream iFile;
-  iFile.open(bmpFile, std::ios::binary | std::ios::ate);
-  if (!iFile.is_open()) {
-    return false;
-  }
-  std::streamsize size = iFile.tellg();
-  iFile.seekg(0, std::ios::beg);
-  char* dataBuffer = new char[size];
-  if (!iFile.read(dataBuffer, size)) {
-    delete[] dataBuffer;
-    return false;
-  }
-  iFile.close();
-  //Decode
-  bool rc = decodeBmp(reinterpret_cast<uint8_t*>(dataBuffer), size);
-  delete[] dataBuffer;
-  return rc;
-}
-
-/**
- * @function writeBmp
- * @description encode BMP write the buffer to a file.
- * @param const std::string& bmpFile
- * @returns bool
- */
-
-bool Bmp24::writeBmp(const std::string& bmpFile) {
-  size_t outDataSize;
-  uint8_t* outBuf = encodeBmp(outDataSize);
-  if (outBuf == nullptr) {
-    return false;
-  }
-  //Write file
-  std::ofstream outFile;
-  outFile.open(bmpFile);
-  if (!outFile.is_open()) {
-    delete[] outBuf;
-    return false;
-  }
-  for (size_t i = 0; i < outDataSize; i++) {
-    outFile << outBuf[i];
-  }
-  outFile.close();
-  delete[] outBuf;
-  return true;
 }
 
-
 /**
  * @function setPixelAt
  * @description: replace pixel in a certain position with the provided one
@@ -281,71 +128,64 @@ bool Bmp24::setPixelAt(size_t row, size_t column, uint8_t red, uint8_t green, ui
 **/
 
 bool Bmp24::setPixelAt(size_t index, uint8_t red, uint8_t green, uint8_t blue) {
-  if (index >= pixelArray.size()) {
+  if (index >= pixelBuffer.getPixelCount()) {
     return false;
   }
-  RGBPixel* reqPixel = reinterpret_cast<RGBPixel*>(pixelArray.at(index));
+  RGBPixel* reqPixel = reinterpret_cast<RGBPixel*>(pixelBuffer.getPixel(index));
   reqPixel->setPixel(red, green, blue);
   return true;
 }
 
 /**
- * @function getPixelAt
- * @description return pointer to pixel in the provided position
- * @param size_t
- * @param size_t
- * @returns RGBPixel*
+ * @function toGreyScale
+ * @description convert bitmap to grey with the provided weights (see GreyScale); if greyLevels is set, provided amount of greys will be used.
+ * Rows are converted in place with SSE2 and split among threads
+ * @param int
+ * @param GreyWeights
+ * @returns bool
 **/
 
-RGBPixel* Bmp24::getPixelAt(size_t row, size_t column) {
+bool Bmp24::toGreyScale(int greyLevels /*= 255*/, GreyWeights weights /* = GreyWeights::AVERAGE */) {
 
-  //Get index, considering that pixels are stored bottom to top
-  size_t reversedRow = (header->height - 1 - row); // h - 1 - r
-  size_t index = (header->width * reversedRow) + column;
-  return getPixelAt(index);
+  if (header == nullptr || greyLevels < 1) {
+    return false;
+  }
+  GreyScale greyScale(weights, greyLevels);
+  size_t width = header->width;
+  forEachBand(header->height, width * 3, [this, &greyScale, width](size_t firstRow, size_t lastRow) {
+    for (size_t row = firstRow; row < lastRow; row++) {
+      greyScale.toGreyRow24(pixelBuffer.getRow(row), width);
+    }
+  });
+  return true;
 }
 
 /**
- * @function getPixelAt
- * @description return pointer to pixel in the provided position
+ * @function toGreyBmp8
+ * @description returns a new 8 bits bitmap (with a grey palette) with the grey of the pixels, as toGreyScale would compute it;
+ * nullptr on failure
  * @param int
- * @returns RGBPixel*
+ * @param GreyWeights
+ * @returns Bmp8*
 **/
 
-RGBPixel* Bmp24::getPixelAt(size_t index) {
+Bmp8* Bmp24::toGreyBmp8(int greyLevels /*= 255*/, GreyWeights weights /* = GreyWeights::AVERAGE */) {
 
-  if (index >= pixelArray.size()) {
+  if (header == nullptr || greyLevels < 1) {
     return nullptr;
   }
-  return reinterpret_cast<RGBPixel*>(pixelArray.at(index));
-}
-
-/**
- * @function toGreyScale
- * @description: convert bitmap to greyscaleArea; if greyLevels is set, provided amount of greys will be used
- * @param int
- * @returns bool
-**/
-
-bool Bmp24::toGreyScale(int greyLevels /*= 255*/) {
-
-  //Convert each pixel to grey
-  for (auto& pixel : pixelArray) {
-    RGBPixel* rgbPixel = reinterpret_cast<RGBPixel*>(pixel);
-    //Get average value (grey for each pixel)
-    uint8_t red = rgbPixel->getRed();
-    uint8_t green = rgbPixel->getGreen();
-    uint8_t blue = rgbPixel->getBlue();
-    uint8_t greyValue = (red + green + blue) / 3;
-    //Apply greyLevels
-    if (greyLevels < 255) {
-      uint8_t appliedLevel = 255 / greyLevels;
-      //Fix grey based on levels we have
-      greyValue = greyValue - (greyValue % appliedLevel);
+  GreyScale greyScale(weights, greyLevels);
+  size_t width = header->width;
+  Bmp8* bmp = new Bmp8(width, header->height);
+  bmp->setTopDown(header->topDown);
+  bmp->setThreads(threads);
+  forEachBand(header->height, width * 3, [this, bmp, &greyScale, width](size_t firstRow, size_t lastRow) {
+    for (size_t row = firstRow; row < lastRow; row++) {
+      uint8_t* dstRow = reinterpret_cast<uint8_t*>(bmp->getPixelAt(row * width));
+      greyScale.toGrey(pixelBuffer.getRow(row), dstRow, width, 3);
     }
-    rgbPixel->setPixel(greyValue, greyValue, greyValue);
-  }
-  return true;
+  });
+  return bmp;
 }
 
 /**
@@ -356,12 +196,14 @@ bool Bmp24::toGreyScale(int greyLevels /*= 255*/) {
 
 bool Bmp24::toSepiaTone() {
   //Convert each pixel to sepia
-  for (auto& pixel : pixelArray) {
-    RGBPixel* rgbPixel = reinterpret_cast<RGBPixel*>(pixel);
-    uint8_t red = MIN((rgbPixel->getRed() * 0.393) + (rgbPixel->getGreen() * 0.769) + (rgbPixel->getBlue() * 0.189), 255);
-    uint8_t green = MIN((rgbPixel->getRed() * 0.349) + (rgbPixel->getGreen() * 0.686) + (rgbPixel->getBlue() * 0.168), 255);
-    uint8_t blue = MIN((rgbPixel->getRed() * 0.272) + (rgbPixel->getGreen() * 0.534) + (rgbPixel->getBlue() * 0.131), 255);
-    rgbPixel->setPixel(red, green, blue);
+  for (size_t row = 0; row < header->height; row++) {
+    RGBPixel* rgbPixel = reinterpret_cast<RGBPixel*>(pixelBuffer.getRow(row));
+    for (size_t column = 0; column < header->width; column++, rgbPixel++) {
+      uint8_t red = MIN((rgbPixel->getRed() * 0.393) + (rgbPixel->getGreen() * 0.769) + (rgbPixel->getBlue() * 0.189), 255);
+      uint8_t green = MIN((rgbPixel->getRed() * 0.349) + (rgbPixel->getGreen() * 0.686) + (rgbPixel->getBlue() * 0.168), 255);
+      uint8_t blue = MIN((rgbPixel->getRed() * 0.272) + (rgbPixel->getGreen() * 0.534) + (rgbPixel->getBlue() * 0.131), 255);
+      rgbPixel->setPixel(red, green, blue);
+    }
   }
   return true;
 }
@@ -374,108 +216,36 @@ bool Bmp24::toSepiaTone() {
 
 bool Bmp24::invert() {
   //Convert each pixel to sepia
-  for (auto& pixel : pixelArray) {
-    RGBPixel* rgbPixel = reinterpret_cast<RGBPixel*>(pixel);
-    uint8_t red = 255 - rgbPixel->getRed();
-    uint8_t green = 255 - rgbPixel->getGreen();
-    uint8_t blue = 255 - rgbPixel->getBlue();
-    rgbPixel->setPixel(red, green, blue);
-  }
-  return true;
-}
-
-/**
- * @function resizeArea
- * @description resize area (does not scale image), both enlarging or scaling it
- * @param size_t width
- * @param size_t height
- * @param size_t xOffset (optional)
- * @param size_t yOffset (optional)
- * @returns bool
-**/
-
-bool Bmp24::resizeArea(size_t width, size_t height, size_t xOffset /* = 0*/, size_t yOffset /* = 0*/) {
-
-  while (header->width != width || header->height != height) {
-    size_t currWidth = header->width;
-    size_t currHeight = header->height;
-    //Resize image in order to match user requests; start with enlarging if necessary
-    if (width > currWidth || height > currHeight) {
-      //Pass higher size or current one to enlarge
-      size_t enlargedWidth = (width > currWidth) ? width : currWidth;
-      size_t enlargedHeight = (height > currHeight) ? height : currHeight;
-      //Initialize Pixel lambda
-      std::function<void(Pixel*&)> initializePixel = [](Pixel*& px) { px = new RGBPixel(255, 255, 255); };
-      if (!enlargeArea(enlargedWidth, enlargedHeight, initializePixel, xOffset, yOffset)) {
-        return false;
-      }
-      continue;
-    }
-    //Also, scale area if necessary
-    if (width < currWidth || height << currHeight) {
-      //Pass lower size or current one to scale
-      size_t scaledWidth = (width < currWidth) ? width : currWidth;
-      size_t scaledHeight = (height < currHeight) ? height : currHeight;
-      //Scale image
-      if (!scaleArea(scaledWidth, scaledHeight, xOffset, yOffset)) {
-        return false;
-      }
-      continue;
+  for (size_t row = 0; row < header->height; row++) {
+    RGBPixel* rgbPixel = reinterpret_cast<RGBPixel*>(pixelBuffer.getRow(row));
+    for (size_t column = 0; column < header->width; column++, rgbPixel++) {
+      uint8_t red = 255 - rgbPixel->getRed();
+      uint8_t green = 255 - rgbPixel->getGreen();
+      uint8_t blue = 255 - rgbPixel->getBlue();
+      rgbPixel->setPixel(red, green, blue);
     }
   }
-  //Return OK
   return true;
 }
 
 /**
- * @function resizeImage
- * @description resize image (not only area) applying bilinear image scaling
- * @param size_t
- * @param size_t
+ * @function resizeMany
+ * @description resize the image to every provided size at once, resampling it with the provided filter: source rows are read once
+ * and resampled for every size, so renditions don't start over from the source pixels
+ * @param const std::vector<ImageSize>& sizes
+ * @param std::vector<Bmp24>& resized images, one per size
+ * @param Filter
  * @returns bool
 **/
 
-bool Bmp24::resizeImage(size_t width, size_t height) {
-  //Apply resizing
-  size_t prevWidth = header->width;
-  size_t prevHeight = header->height;
-  std::vector<Pixel*> resizedArray; //New pixel vector
-  float xRatio = static_cast<float>(prevWidth - 1) / width;
-  float yRatio = static_cast<float>(prevHeight - 1) / height;
-  //Working variables
-  RGBPixel *px1, *px2, *px3, *px4;
-  int x, y, index;
-  float xDiff, yDiff;
-  uint8_t red, green, blue;
-  for (size_t row = 0; row < height; row++) {
-    for (size_t column = 0; column < width; column++) {
-      x = static_cast<int>(xRatio * column);
-      y = static_cast<int>(yRatio * row);
-      xDiff = (xRatio * column) - x;
-      yDiff = (yRatio * row) - y;
-      index = ((y * prevWidth) + x);
-      px1 = reinterpret_cast<RGBPixel*>(pixelArray.at(index));
-      px2 = reinterpret_cast<RGBPixel*>(pixelArray.at(index + 1));
-      px3 = reinterpret_cast<RGBPixel*>(pixelArray.at(index + prevWidth));
-      px4 = reinterpret_cast<RGBPixel*>(pixelArray.at(index + prevWidth + 1));
-      //Yb = Ab(1-w)(1-h) + Bb(w)(1-h) + Cb(h)(1-w) + Db(wh)
-      blue = (px1->getBlue() * (1 - xDiff) * (1 - yDiff)) + (px2->getBlue() * (xDiff) * (1 - yDiff)) + (px3->getBlue() * (yDiff) * (1 - xDiff)) + (px4->getBlue() * (xDiff * yDiff));
-      green = (px1->getGreen() * (1 - xDiff) * (1 - yDiff)) + (px2->getGreen() * (xDiff) * (1 - yDiff)) + (px3->getGreen() * (yDiff) * (1 - xDiff)) + (px4->getGreen() * (xDiff * yDiff));
-      red = (px1->getRed() * (1 - xDiff) * (1 - yDiff)) + (px2->getRed() * (xDiff) * (1 - yDiff)) + (px3->getRed() * (yDiff) * (1 - xDiff)) + (px4->getRed() * (xDiff * yDiff));
-      //Instance new pixel
-      Pixel* resizedPixel = new RGBPixel(red, green, blue);
-      //Push pixel into array
-      resizedArray.push_back(resizedPixel);
-    }
-  }
-  //Delete all pixels in previous pixel array
-  for (auto& pixel : pixelArray) {
-    RGBPixel* px = reinterpret_cast<RGBPixel*>(pixel);
-    delete px;
+bool Bmp24::resizeMany(const std::vector<ImageSize>& sizes, std::vector<Bmp24>& resized, Filter filter /* = Filter::BILINEAR */) {
+  resized.clear();
+  resized.resize(sizes.size());
+  std::vector<BmpImage<RGBFormat>*> images;
+  for (Bmp24& image : resized) {
+    images.push_back(&image);
   }
-  pixelArray = resizedArray;
-  //Change header parameters
-  return Bmp::resizeImage(width, height);
+  return resizeInto(sizes, images, filter);
 }
 
 }
@@ -22,8 +22,9 @@
 **/
 
 #include <bmp32.hpp>
-
-#include <fstream>
+#include <bmp8.hpp>
+#include <pixels/greyscale.hpp>
+#include <pixels/swizzle.hpp>
 
 #ifdef BMP_DEBUG
 #include <iostream>
@@ -31,6 +32,8 @@
 #endif
 
 #define MIN(a,b) ((a) < (b) ? (a) : (b))
+#define BI_BITFIELDS 3
+#define BI_ALPHABITFIELDS 6
 
 using namespace bmp;
 
@@ -39,8 +42,8 @@ using namespace bmp;
  * @description Bmp32 class constructor
 **/
 
-Bmp32::Bmp32() : Bmp() {
-  pixelArray.clear();
+Bmp32::Bmp32() : BmpImage<RGBAFormat>() {
+
 }
 
 /**
@@ -48,23 +51,8 @@ Bmp32::Bmp32() : Bmp() {
  * @description Bmp class constructor
 **/
 
-Bmp32::Bmp32(size_t width, size_t height, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha) : Bmp(width, height) {
-  //Set bits per pixel
-  header->bitsPerPixel = 24;
-  //FileSize must be set by child class
-  size_t nextMultipleOf4 = roundToMultiple(width * (header->bitsPerPixel / 8), 4);
-  size_t paddingSize = nextMultipleOf4 - (header->width * (header->bitsPerPixel / 8));
-  size_t rowSize = paddingSize + ((width * header->bitsPerPixel / 8));
-  size_t dataSize = rowSize * height;
-  header->fileSize = 54 + dataSize;
-  //DataSize must be set by child class
-  header->dataSize = dataSize;
-  //Create empty image
-  size_t arraySize = header->width * header->height;
-  pixelArray.reserve(arraySize);
-  for (size_t i = 0; i < arraySize; i++) {
-    pixelArray.push_back(new RGBAPixel(red, green, blue, alpha));
-  }
+Bmp32::Bmp32(size_t width, size_t height, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha) : BmpImage<RGBAFormat>(width, height, RGBAPixel(red, green, blue, alpha)) {
+
 }
 
 /**
@@ -73,13 +61,8 @@ Bmp32::Bmp32(size_t width, size_t height, uint8_t red, uint8_t green, uint8_t bl
  * @param const Bmp& bmp
  */
 
-Bmp32::Bmp32(const Bmp32& bmp) : Bmp(bmp) {
-  //Copy pixel array to new bmp
-  size_t arraySize = bmp.pixelArray.size();
-  for (size_t i = 0; i < arraySize; i++) {
-    RGBAPixel* copyPixel = reinterpret_cast<RGBAPixel*>(bmp.pixelArray.at(i));
-    pixelArray.push_back(new RGBAPixel(copyPixel->getRed(), copyPixel->getGreen(), copyPixel->getBlue(), copyPixel->getAlpha()));
-  }
+Bmp32::Bmp32(const Bmp32& bmp) : BmpImage<RGBAFormat>(bmp) {
+  //Pixels are copied by Bmp
 }
 
 /**
@@ -88,13 +71,20 @@ Bmp32::Bmp32(const Bmp32& bmp) : Bmp(bmp) {
  * @param const Bmp& bmp
  */
 
-Bmp32::Bmp32(Bmp32* bmp) : Bmp(bmp) {
-  //Copy pixel array to new bmp
-  size_t arraySize = bmp->pixelArray.size();
-  for (size_t i = 0; i < arraySize; i++) {
-    RGBAPixel* copyPixel = reinterpret_cast<RGBAPixel*>(bmp->pixelArray.at(i));
-    pixelArray.push_back(new RGBAPixel(copyPixel->getRed(), copyPixel->getGreen(), copyPixel->getBlue(), copyPixel->getAlpha()));
-  }
+Bmp32::Bmp32(Bmp32* bmp) : BmpImage<RGBAFormat>(bmp) {
+  //Pixels are copied by Bmp
+}
+
+/**
+ * @function operator=
+ * @description Bmp32 class copy assignment
+ * @param const Bmp32& bmp
+ * @returns Bmp32&
+**/
+
+Bmp32& Bmp32::operator=(const Bmp32& bmp) {
+  BmpImage<RGBAFormat>::operator=(bmp);
+  return *this;
 }
 
 /**
@@ -106,148 +96,213 @@ Bmp32::~Bmp32() {
   
 }
 
+/**
+ * @function maskToChannel
+ * @description extract the channel selected by mask from a pixel and scale it to 8 bits
+ * @param uint32_t pixel
+ * @param uint32_t mask
+ * @returns uint8_t
+**/
+
+static uint8_t maskToChannel(uint32_t pixel, uint32_t mask) {
+  if (mask == 0) {
+    return 0;
+  }
+  size_t shift = 0;
+  while (((mask >> shift) & 1) == 0) {
+    shift++;
+  }
+  size_t bits = 0;
+  while (shift + bits < 32 && ((mask >> (shift + bits)) & 1) == 1) {
+    bits++;
+  }
+  uint32_t value = (pixel & mask) >> shift;
+  if (bits >= 8) {
+    return static_cast<uint8_t>(value >> (bits - 8));
+  }
+  return static_cast<uint8_t>((value * 255) / ((1U << bits) - 1));
+}
+
+/**
+ * @function maskToByte
+ * @description returns the index of the byte selected by mask, or 4 if the mask doesn't select exactly one byte
+ * @param uint32_t mask
+ * @returns uint8_t
+**/
+
+static uint8_t maskToByte(uint32_t mask) {
+  for (uint8_t byte = 0; byte < 4; byte++) {
+    if (mask == (0xFFU << (byte * 8))) {
+      return byte;
+    }
+  }
+  return 4;
+}
+
+/**
+ * @function getByteOrder
+ * @description get the byte of each channel (blue, green, red, alpha) if masks are byte aligned; alpha is the remaining byte if it has no mask
+ * @param const uint32_t[4] masks
+ * @param uint8_t[4] order
+ * @returns bool: false if masks are not byte aligned
+**/
+
+static bool getByteOrder(const uint32_t masks[4], uint8_t order[4]) {
+  uint8_t redByte = maskToByte(masks[0]);
+  uint8_t greenByte = maskToByte(masks[1]);
+  uint8_t blueByte = maskToByte(masks[2]);
+  uint8_t alphaByte = maskToByte(masks[3]);
+  if (redByte >= 4 || greenByte >= 4 || blueByte >= 4 || redByte == greenByte || redByte == blueByte || greenByte == blueByte) {
+    return false;
+  }
+  if (alphaByte >= 4 || alphaByte == redByte || alphaByte == greenByte || alphaByte == blueByte) {
+    alphaByte = static_cast<uint8_t>(6 - redByte - greenByte - blueByte);
+  }
+  order[0] = blueByte;
+  order[1] = greenByte;
+  order[2] = redByte;
+  order[3] = alphaByte;
+  return true;
+}
+
 /**
  * @function decodeBmp
- * @description decode Bmp data buffer converting it to header struct and RGBAPixel array
+ * @description decode Bmp data buffer converting it to header struct and pixel buffer.
+ * BI_BITFIELDS images are converted to BGRA: with byte aligned masks by a shuffle, otherwise channel by channel
  * @param uint8_t*
  * @param size_t
  * @returns bool
 **/
 
-
 bool Bmp32::decodeBmp(uint8_t* bmpData, size_t dataSize) {
 
-  //Call superclass decodeBmp to decode header
-  if (!Bmp::decodeBmp(bmpData, dataSize)) {
+  //Rows are copied as they are
+  if (!BmpImage<RGBAFormat>::decodeBmp(bmpData, dataSize)) {
     return false;
   }
+  return decodeBitfields();
+}
 
-  //Get data
-  size_t nextMultipleOf4 = roundToMultiple(header->width * (header->bitsPerPixel / 8), 4);
-  size_t paddingSize = nextMultipleOf4 - (header->width * (header->bitsPerPixel / 8));
-  size_t realRowSize = (header->width * (header->bitsPerPixel / 8));
-  size_t rowPositionCounter = 0;
-  for (size_t dataPtr = header->dataOffset - 1; dataPtr < header->fileSize - 1;) {
-    //Store Pixels for each byte NOTE: BMP is BGRA
-    uint8_t blue = bmpData[++dataPtr];
-    uint8_t green = bmpData[++dataPtr];
-    uint8_t red = bmpData[++dataPtr];
-    uint8_t alpha = bmpData[++dataPtr];
-    //Create new pixel
-    pixelArray.push_back(new RGBAPixel(red, green, blue, alpha));
-    rowPositionCounter += 4;
-    //If row has been parsed, go to next line
-    if (rowPositionCounter >= realRowSize) {
-      rowPositionCounter = 0;
-      dataPtr += paddingSize;
-    }
-  }
+/**
+ * @function decodeRegion
+ * @description decode only an area of Bmp data buffer (see BmpImage::decodeRegion); BI_BITFIELDS images are converted to BGRA
+ * @param uint8_t*
+ * @param size_t
+ * @param size_t xOffset
+ * @param size_t yOffset
+ * @param size_t width
+ * @param size_t height
+ * @returns bool
+**/
 
-  return true;
+bool Bmp32::decodeRegion(uint8_t* bmpData, size_t dataSize, size_t xOffset, size_t yOffset, size_t width, size_t height) {
+
+  if (!BmpImage<RGBAFormat>::decodeRegion(bmpData, dataSize, xOffset, yOffset, width, height)) {
+    return false;
+  }
+  return decodeBitfields();
 }
 
 /**
- * @function encodeBmp
- * @description: encodes bitmap to buffer
- * @param size_t*
- * @returns uint8_t*
+ * @function decodeDownscaled
+ * @description decode Bmp data buffer downscaling it to width x height (see BmpImage::decodeDownscaled).
+ * BI_BITFIELDS channels which aren't byte aligned can't be averaged byte by byte, so they're converted at full size first
+ * @param uint8_t*
+ * @param size_t
+ * @param size_t width
+ * @param size_t height
+ * @returns bool
 **/
 
-uint8_t* Bmp32::encodeBmp(size_t& dataSize) {  
+bool Bmp32::decodeDownscaled(uint8_t* bmpData, size_t dataSize, size_t width, size_t height) {
 
-  //Get our fundamental parameters
-  size_t nextMultipleOf4 = roundToMultiple(header->width * (header->bitsPerPixel / 8), 4);
-  size_t paddingSize = nextMultipleOf4 - header->width * (header->bitsPerPixel / 8);
-  size_t realRowSize = (header->width * (header->bitsPerPixel / 8));
-  //Fill header and get bmpData with fixed size
-  uint8_t* bmpData = Bmp::encodeBmp(dataSize);
-  //Return nullptr if needed
-  if (bmpData == nullptr) {
-    return nullptr;
+  Header fileHeader;
+  if (!decodeHeader(bmpData, dataSize, fileHeader)) {
+    return false;
   }
-  
-  //Fill data
-  int pxIndex = -1;
-  size_t rowPositionCounter = 0;
-  for (size_t dataPtr = header->dataOffset - 1; dataPtr < dataSize - 1;) {
-    if (++pxIndex >= static_cast<int>(pixelArray.size())) {
-      break;
+  if (fileHeader.biRgb == BI_BITFIELDS || fileHeader.biRgb == BI_ALPHABITFIELDS) {
+    //Masks are in the dib data
+    if (!Bmp::decodeBmp(bmpData, dataSize)) {
+      return false;
     }
-    //Set pixel
-    RGBAPixel* currPixel = reinterpret_cast<RGBAPixel*>(pixelArray.at(pxIndex));
-    bmpData[++dataPtr] = currPixel->getBlue();
-    bmpData[++dataPtr] = currPixel->getGreen();
-    bmpData[++dataPtr] = currPixel->getRed();
-    bmpData[++dataPtr] = currPixel->getAlpha();
-    //Check if row has to be closed
-    rowPositionCounter += 4;
-    if (rowPositionCounter >= realRowSize) {
-      //Fill row with padding and go on new line
-      rowPositionCounter = 0;
-      for (size_t i = 0; i < paddingSize; i++) {
-        bmpData[++dataPtr] = 0;
-      }
+    uint32_t masks[4];
+    uint8_t order[4];
+    if (!readMasks(masks)) {
+      return false;
+    }
+    if (!getByteOrder(masks, order)) {
+      return decodeBmp(bmpData, dataSize) && downscaleBuffer(width, height);
     }
   }
-  return bmpData;
+  if (!BmpImage<RGBAFormat>::decodeDownscaled(bmpData, dataSize, width, height)) {
+    return false;
+  }
+  return decodeBitfields();
 }
 
 /**
- * @function readBmp
- * @description read a BMP file and decodes it. The decoded Bmp becomes the object
- * @param const std::string& bmpFile
+ * @function decodeBitfields
+ * @description convert the decoded pixel buffer to BGRA if the image is BI_BITFIELDS
  * @returns bool
- */
+**/
 
-bool Bmp32::readBmp(const std::string& bmpFile) {
-  std::ifstream iFile;
-  iFile.open(bmpFile, std::ios::binary | std::ios::ate);
-  if (!iFile.is_open()) {
-    return false;
+bool Bmp32::decodeBitfields() {
+
+  if (header->biRgb != BI_BITFIELDS && header->biRgb != BI_ALPHABITFIELDS) {
+    return true;
   }
-  std::streamsize size = iFile.tellg();
-  iFile.seekg(0, std::ios::beg);
-  char* dataBuffer = new char[size];
-  if (!iFile.read(dataBuffer, size)) {
-    delete[] dataBuffer;
+  uint32_t masks[4]; //Red, green, blue, alpha
+  if (!readMasks(masks)) {
     return false;
   }
-  iFile.close();
-  //Decode
-  bool rc = decodeBmp(reinterpret_cast<uint8_t*>(dataBuffer), size);
-  delete[] dataBuffer;
-  return rc;
+  uint8_t order[4];
+  if (getByteOrder(masks, order)) {
+    forEachBand(header->height, pixelBuffer.getStride(), [this, &order](size_t firstRow, size_t endRow) {
+      for (size_t row = firstRow; row < endRow; row++) {
+        uint8_t* rowData = pixelBuffer.getRow(row);
+        Swizzle::shuffle32(rowData, rowData, header->width, order);
+      }
+    });
+  } else {
+    forEachBand(header->height, pixelBuffer.getStride(), [this, &masks](size_t firstRow, size_t endRow) {
+      for (size_t row = firstRow; row < endRow; row++) {
+        uint8_t* srcPixel = pixelBuffer.getRow(row);
+        RGBAPixel* rgbaPixel = reinterpret_cast<RGBAPixel*>(srcPixel);
+        for (size_t column = 0; column < header->width; column++, rgbaPixel++, srcPixel += 4) {
+          uint32_t pixel = srcPixel[0] | (srcPixel[1] << 8) | (srcPixel[2] << 16) | (static_cast<uint32_t>(srcPixel[3]) << 24);
+          rgbaPixel->setPixel(maskToChannel(pixel, masks[0]), maskToChannel(pixel, masks[1]), maskToChannel(pixel, masks[2]), maskToChannel(pixel, masks[3]));
+        }
+      }
+    });
+  }
+  //Raster is now BGRA
+  header->biRgb = 0;
+  return true;
 }
 
 /**
- * @function writeBmp
- * @description encode BMP write the buffer to a file.
- * @param const std::string& bmpFile
- * @returns bool
- */
+ * @function readMasks
+ * @description read red, green, blue and alpha masks of a BI_BITFIELDS image from the dib data
+ * @param uint32_t[4] masks
+ * @returns bool: false if the masks are not in the dib data
+**/
 
-bool Bmp32::writeBmp(const std::string& bmpFile) {
-  size_t outDataSize;
-  uint8_t* outBuf = encodeBmp(outDataSize);
-  if (outBuf == nullptr) {
-    return false;
-  }
-  //Write file
-  std::ofstream outFile;
-  outFile.open(bmpFile);
-  if (!outFile.is_open()) {
-    delete[] outBuf;
+bool Bmp32::readMasks(uint32_t masks[4]) {
+
+  //Masks follow the 40 bytes info header (alpha mask is there only from the V3 header or with BI_ALPHABITFIELDS)
+  size_t dibDataSize = header->dataOffset - 54;
+  bool hasAlphaMask = header->biRgb == BI_ALPHABITFIELDS || header->dibSize >= 56;
+  if (dibDataSize < (hasAlphaMask ? 16U : 12U)) {
     return false;
   }
-  for (size_t i = 0; i < outDataSize; i++) {
-    outFile << outBuf[i];
+  masks[3] = 0;
+  for (size_t i = 0; i < (hasAlphaMask ? 4U : 3U); i++) {
+    const uint8_t* mask = dibData + (i * 4);
+    masks[i] = mask[0] | (mask[1] << 8) | (mask[2] << 16) | (static_cast<uint32_t>(mask[3]) << 24);
   }
-  outFile.close();
-  delete[] outBuf;
   return true;
 }
 
-
 /**
  * @function setPixelAt
  * @description: replace pixel in a certain position with the provided one
@@ -280,71 +335,64 @@ bool Bmp32::setPixelAt(size_t row, size_t column, uint8_t red, uint8_t green, ui
 **/
 
 bool Bmp32::setPixelAt(size_t index, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha) {
-  if (index >= pixelArray.size()) {
+  if (index >= pixelBuffer.getPixelCount()) {
     return false;
   }
-  RGBAPixel* reqPixel = reinterpret_cast<RGBAPixel*>(pixelArray.at(index));
+  RGBAPixel* reqPixel = reinterpret_cast<RGBAPixel*>(pixelBuffer.getPixel(index));
   reqPixel->setPixel(red, green, blue, alpha);
   return true;
 }
 
 /**
- * @function getPixelAt
- * @description return pointer to pixel in the provided position
- * @param size_t
- * @param size_t
- * @returns RGBPixel*
+ * @function toGreyScale
+ * @description convert bitmap to grey with the provided weights (see GreyScale); if greyLevels is set, provided amount of greys will be used.
+ * Rows are converted in place with SSE2 (alpha is kept) and split among threads
+ * @param int
+ * @param GreyWeights
+ * @returns bool
 **/
 
-RGBAPixel* Bmp32::getPixelAt(size_t row, size_t column) {
+bool Bmp32::toGreyScale(int greyLevels /*= 255*/, GreyWeights weights /* = GreyWeights::AVERAGE */) {
 
-  //Get index, considering that pixels are stored bottom to top
-  size_t reversedRow = (header->height - 1 - row); // h - 1 - r
-  size_t index = (header->width * reversedRow) + column;
-  return getPixelAt(index);
+  if (header == nullptr || greyLevels < 1) {
+    return false;
+  }
+  GreyScale greyScale(weights, greyLevels);
+  size_t width = header->width;
+  forEachBand(header->height, width * 4, [this, &greyScale, width](size_t firstRow, size_t lastRow) {
+    for (size_t row = firstRow; row < lastRow; row++) {
+      greyScale.toGreyRow32(pixelBuffer.getRow(row), width);
+    }
+  });
+  return true;
 }
 
 /**
- * @function getPixelAt
- * @description return pointer to pixel in the provided position
- * @param size_t
- * @returns RGBPixel*
+ * @function toGreyBmp8
+ * @description returns a new 8 bits bitmap (with a grey palette) with the grey of the pixels, as toGreyScale would compute it;
+ * nullptr on failure
+ * @param int
+ * @param GreyWeights
+ * @returns Bmp8*
 **/
 
-RGBAPixel* Bmp32::getPixelAt(size_t index) {
+Bmp8* Bmp32::toGreyBmp8(int greyLevels /*= 255*/, GreyWeights weights /* = GreyWeights::AVERAGE */) {
 
-  if (index >= pixelArray.size()) {
+  if (header == nullptr || greyLevels < 1) {
     return nullptr;
   }
-  return reinterpret_cast<RGBAPixel*>(pixelArray.at(index));
-}
-
-/**
- * @function toGreyScale
- * @description: convert bitmap to greyscaleArea; if greyLevels is set, provided amount of greys will be used
- * @param size_t
- * @returns bool
-**/
-
-bool Bmp32::toGreyScale(int greyLevels /*= 255*/) {
-
-  //Convert each pixel to grey
-  for (auto& pixel : pixelArray) {
-    RGBAPixel* rgbaPixel = reinterpret_cast<RGBAPixel*>(pixel);
-    //Get average value (grey for each pixel)
-    uint8_t red = rgbaPixel->getRed();
-    uint8_t green = rgbaPixel->getGreen();
-    uint8_t blue = rgbaPixel->getBlue();
-    uint8_t greyValue = (red + green + blue) / 3;
-    //Apply greyLevels
-    if (greyLevels < 255) {
-      uint8_t appliedLevel = 255 / greyLevels;
-      //Fix grey based on levels we have
-      greyValue = greyValue - (greyValue % appliedLevel);
+  GreyScale greyScale(weights, greyLevels);
+  size_t width = header->width;
+  Bmp8* bmp = new Bmp8(width, header->height);
+  bmp->setTopDown(header->topDown);
+  bmp->setThreads(threads);
+  forEachBand(header->height, width * 4, [this, bmp, &greyScale, width](size_t firstRow, size_t lastRow) {
+    for (size_t row = firstRow; row < lastRow; row++) {
+      uint8_t* dstRow = reinterpret_cast<uint8_t*>(bmp->getPixelAt(row * width));
+      greyScale.toGrey(pixelBuffer.getRow(row), dstRow, width, 4);
     }
-    rgbaPixel->setPixel(greyValue, greyValue, greyValue, rgbaPixel->getAlpha());
-  }
-  return true;
+  });
+  return bmp;
 }
 
 /**
@@ -355,12 +403,14 @@ bool Bmp32::toGreyScale(int greyLevels /*= 255*/) {
 
 bool Bmp32::toSepiaTone() {
   //Convert each pixel to sepia
-  for (auto& pixel : pixelArray) {
-    RGBAPixel* rgbaPixel = reinterpret_cast<RGBAPixel*>(pixel);
-    uint8_t red = MIN((rgbaPixel->getRed() * 0.393) + (rgbaPixel->getGreen() * 0.769) + (rgbaPixel->getBlue() * 0.189), 255);
-    uint8_t green = MIN((rgbaPixel->getRed() * 0.349) + (rgbaPixel->getGreen() * 0.686) + (rgbaPixel->getBlue() * 0.168), 255);
-    uint8_t blue = MIN((rgbaPixel->getRed() * 0.272) + (rgbaPixel->getGreen() * 0.534) + (rgbaPixel->getBlue() * 0.131), 255);
-    rgbaPixel->setPixel(red, green, blue, rgbaPixel->getAlpha());
+  for (size_t row = 0; row < header->height; row++) {
+    RGBAPixel* rgbaPixel = reinterpret_cast<RGBAPixel*>(pixelBuffer.getRow(row));
+    for (size_t column = 0; column < header->width; column++, rgbaPixel++) {
+      uint8_t red = MIN((rgbaPixel->getRed() * 0.393) + (rgbaPixel->getGreen() * 0.769) + (rgbaPixel->getBlue() * 0.189), 255);
+      uint8_t green = MIN((rgbaPixel->getRed() * 0.349) + (rgbaPixel->getGreen() * 0.686) + (rgbaPixel->getBlue() * 0.168), 255);
+      uint8_t blue = MIN((rgbaPixel->getRed() * 0.272) + (rgbaPixel->getGreen() * 0.534) + (rgbaPixel->getBlue() * 0.131), 255);
+      rgbaPixel->setPixel(red, green, blue, rgbaPixel->getAlpha());
+    }
   }
   return true;
 }
@@ -373,107 +423,34 @@ bool Bmp32::toSepiaTone() {
 
 bool Bmp32::invert() {
   //Convert each pixel to sepia
-  for (auto& pixel : pixelArray) {
-    RGBAPixel* rgbPixel = reinterpret_cast<RGBAPixel*>(pixel);
-    uint8_t red = 255 - rgbPixel->getRed();
-    uint8_t green = 255 - rgbPixel->getGreen();
-    uint8_t blue = 255 - rgbPixel->getBlue();
-    rgbPixel->setPixel(red, green, blue, rgbPixel->getAlpha());
-  }
-  return true;
-}
-
-/**
- * @function resizeArea
- * @description resize area (does not scale image), both enlarging or scaling it
- * @param size_t width
- * @param size_t height
- * @param size_t xOffset (optional)
- * @param size_t yOffset (optional)
- * @returns bool
-**/
-
-bool Bmp32::resizeArea(size_t width, size_t height, size_t xOffset /* = 0*/, size_t yOffset /* = 0*/) {
-
-  while (header->width != width || header->height != height) {
-    size_t currWidth = header->width;
-    size_t currHeight = header->height;
-    //Resize image in order to match user requests; start with enlarging if necessary
-    if (width > currWidth || height > currHeight) {
-      //Pass higher size or current one to enlarge
-      size_t enlargedWidth = (width > currWidth) ? width : currWidth;
-      size_t enlargedHeight = (height > currHeight) ? height : currHeight;
-      //Initialize Pixel lambda
-      std::function<void(Pixel*&)> initializePixel = [](Pixel*& px) { px = new RGBAPixel(255, 255, 255, 0); };
-      if (!enlargeArea(enlargedWidth, enlargedHeight, initializePixel, xOffset, yOffset)) {
-        return false;
-      }
-      continue;
-    }
-    //Also, scale area if necessary
-    if (width < currWidth || height << currHeight) {
-      //Pass lower size or current one to scale
-      size_t scaledWidth = (width < currWidth) ? width : currWidth;
-      size_t scaledHeight = (height < currHeight) ? height : currHeight;
-      //Scale image
-      if (!scaleArea(scaledWidth, scaledHeight, xOffset, yOffset)) {
-        return false;
-      }
-      continue;
+  for (size_t row = 0; row < header->height; row++) {
+    RGBAPixel* rgbPixel = reinterpret_cast<RGBAPixel*>(pixelBuffer.getRow(row));
+    for (size_t column = 0; column < header->width; column++, rgbPixel++) {
+      uint8_t red = 255 - rgbPixel->getRed();
+      uint8_t green = 255 - rgbPixel->getGreen();
+      uint8_t blue = 255 - rgbPixel->getBlue();
+      rgbPixel->setPixel(red, green, blue, rgbPixel->getAlpha());
     }
   }
-  //Return OK
   return true;
 }
 
 /**
- * @function resizeImage
- * @description resize image (not only area) applying bilinear image scaling
- * @param size_t
- * @param size_t
+ * @function resizeMany
+ * @description resize the image to every provided size at once, resampling it with the provided filter: source rows are read once
+ * and resampled for every size, so renditions don't start over from the source pixels
+ * @param const std::vector<ImageSize>& sizes
+ * @param std::vector<Bmp32>& resized images, one per size
+ * @param Filter
  * @returns bool
 **/
 
-bool Bmp32::resizeImage(size_t width, size_t height) {
-  //Apply resizing
-  size_t prevWidth = header->width;
-  size_t prevHeight = header->height;
-  std::vector<Pixel*> resizedArray; //New pixel vector
-  float xRatio = static_cast<float>(prevWidth - 1) / width;
-  float yRatio = static_cast<float>(prevHeight - 1) / height;
-  //Working variables
-  RGBAPixel *px1, *px2, *px3, *px4;
-  int x, y, index;
-  float xDiff, yDiff;
-  uint8_t red, green, blue, alpha;
-  for (size_t row = 0; row < height; row++) {
-    for (size_t column = 0; column < width; column++) {
-      x = static_cast<int>(xRatio * column);
-      y = static_cast<int>(yRatio * row);
-      xDiff = (xRatio * column) - x;
-      yDiff = (yRatio * row) - y;
-      index = ((y * prevWidth) + x);
-      px1 = reinterpret_cast<RGBAPixel*>(pixelArray.at(index));
-      px2 = reinterpret_cast<RGBAPixel*>(pixelArray.at(index + 1));
-      px3 = reinterpret_cast<RGBAPixel*>(pixelArray.at(index + prevWidth));
-      px4 = reinterpret_cast<RGBAPixel*>(pixelArray.at(index + prevWidth + 1));
-      //Yb = Ab(1-w)(1-h) + Bb(w)(1-h) + Cb(h)(1-w) + Db(wh)
-      blue = (px1->getBlue() * (1 - xDiff) * (1 - yDiff)) + (px2->getBlue() * (xDiff) * (1 - yDiff)) + (px3->getBlue() * (yDiff) * (1 - xDiff)) + (px4->getBlue() * (xDiff * yDiff));
-      green = (px1->getGreen() * (1 - xDiff) * (1 - yDiff)) + (px2->getGreen() * (xDiff) * (1 - yDiff)) + (px3->getGreen() * (yDiff) * (1 - xDiff)) + (px4->getGreen() * (xDiff * yDiff));
-      red = (px1->getRed() * (1 - xDiff) * (1 - yDiff)) + (px2->getRed() * (xDiff) * (1 - yDiff)) + (px3->getRed() * (yDiff) * (1 - xDiff)) + (px4->getRed() * (xDiff * yDiff));
-      alpha = (px1->getAlpha() * (1 - xDiff) * (1 - yDiff)) + (px2->getAlpha() * (xDiff) * (1 - yDiff)) + (px3->getAlpha() * (yDiff) * (1 - xDiff)) + (px4->getAlpha() * (xDiff * yDiff));
-      //Instance new pixel
-      Pixel* resizedPixel = new RGBAPixel(red, green, blue, alpha);
-      //Push pixel into array
-      resizedArray.push_back(resizedPixel);
-    }
-  }
-  //Delete all pixels in previous pixel array
-  for (auto& pixel : pixelArray) {
-    RGBAPixel* px = reinterpret_cast<RGBAPixel*>(pixel);
-    delete px;
+bool Bmp32::resizeMany(const std::vector<ImageSize>& sizes, std::vector<Bmp32>& resized, Filter filter /* = Filter::BILINEAR */) {
+  resized.clear();
+  resized.resize(sizes.size());
+  std::vector<BmpImage<RGBAFormat>*> images;
+  for (Bmp32& image : resized) {
+    images.push_back(&image);
   }
-  pixelArray = resizedArray;
-  //Change header parameters
-  return Bmp::resizeImage(width, height);
+  return resizeInto(sizes, images, filter);
 }
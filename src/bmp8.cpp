@@ -22,7 +22,14 @@
 **/
 
 #include <bmp8.hpp>
+#include <bmp24.hpp>
+#include <bmp32.hpp>
+#include <pixels/greyscale.hpp>
+#include <pixels/swizzle.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 
 #ifdef BMP_DEBUG
@@ -30,42 +37,139 @@
 #include <string>
 #endif
 
+#define BI_RGB 0
+#define BI_RLE8 1
+#define BI_RLE4 2
+#define RLE_MAX_RUN 255
+//Absolute mode needs at least 3 pixels (0x00 0x01 and 0x00 0x02 are escapes)
+#define RLE_MIN_ABSOLUTE 3
+#define PALETTE_MAX_COLORS 256
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+
 namespace bmp {
 
+/**
+ * @function runLength
+ * @description returns the amount of equal pixels starting from column (at most maxRun)
+ * @param const uint8_t*
+ * @param size_t
+ * @param size_t
+ * @param size_t
+ * @returns size_t
+**/
+
+static inline size_t runLength(const uint8_t* row, size_t column, size_t width, size_t maxRun) {
+  size_t run = 1;
+  while (run < maxRun && column + run < width && row[column + run] == row[column]) {
+    run++;
+  }
+  return run;
+}
+
+/**
+ * @function encodeRle8
+ * @description encodes pixels as RLE8 into rleData. Returns the encoded size or 0 if it exceeds maxSize
+ * @param PixelBuffer&
+ * @param uint8_t*
+ * @param size_t
+ * @returns size_t
+**/
+
+static size_t encodeRle8(PixelBuffer& pixels, uint8_t* rleData, size_t maxSize) {
+
+  size_t width = pixels.getWidth();
+  size_t height = pixels.getHeight();
+  size_t rleSize = 0;
+  for (size_t row = 0; row < height; row++) {
+    const uint8_t* rowData = pixels.getRow(row);
+    size_t column = 0;
+    while (column < width) {
+      size_t run = runLength(rowData, column, width, RLE_MAX_RUN);
+      if (run < RLE_MIN_ABSOLUTE) {
+        //Collect pixels until the next run worth encoding
+        size_t absoluteEnd = column + run;
+        while (absoluteEnd < width) {
+          size_t nextRun = runLength(rowData, absoluteEnd, width, RLE_MIN_ABSOLUTE);
+          if (nextRun >= RLE_MIN_ABSOLUTE || absoluteEnd + nextRun - column > RLE_MAX_RUN) {
+            break;
+          }
+          absoluteEnd += nextRun;
+        }
+        size_t absoluteSize = absoluteEnd - column;
+        if (absoluteSize >= RLE_MIN_ABSOLUTE) {
+          //Absolute mode: 0x00, count, pixels, padded to 16 bits
+          size_t paddedSize = (absoluteSize + 1) & ~static_cast<size_t>(1);
+          if (rleSize + 2 + paddedSize > maxSize) {
+            return 0;
+          }
+          rleData[rleSize++] = 0;
+          rleData[rleSize++] = static_cast<uint8_t>(absoluteSize);
+          memcpy(rleData + rleSize, rowData + column, absoluteSize);
+          rleSize += absoluteSize;
+          if (paddedSize != absoluteSize) {
+            rleData[rleSize++] = 0;
+          }
+          column = absoluteEnd;
+          continue;
+        }
+      }
+      //Encoded mode: count, pixel
+      if (rleSize + 2 > maxSize) {
+        return 0;
+      }
+      rleData[rleSize++] = static_cast<uint8_t>(run);
+      rleData[rleSize++] = rowData[column];
+      column += run;
+    }
+    //End of line, or end of bitmap after the last row
+    if (rleSize + 2 > maxSize) {
+      return 0;
+    }
+    rleData[rleSize++] = 0;
+    rleData[rleSize++] = (row + 1 < height) ? 0 : 1;
+  }
+  return rleSize;
+
+}
+
+/**
+ * @function getGreyPalette
+ * @description returns a 256 colors palette where index i is grey level i
+ * @returns std::vector<RGBAPixel>
+**/
+
+static std::vector<RGBAPixel> getGreyPalette() {
+
+  std::vector<RGBAPixel> greyPalette;
+  greyPalette.reserve(PALETTE_MAX_COLORS);
+  for (size_t index = 0; index < PALETTE_MAX_COLORS; index++) {
+    uint8_t grey = static_cast<uint8_t>(index);
+    greyPalette.push_back(RGBAPixel(grey, grey, grey, 0));
+  }
+  return greyPalette;
+
+}
+
 /**
  * @function Bmp8
  * @description Bmp8 class constructor
 **/
 
-Bmp8::Bmp8() : Bmp() {
-  pixelArray.clear();
+Bmp8::Bmp8() : BmpImage<ByteFormat>() {
+  compression = Compression::NONE;
 }
 
 /**
  * @function Bmp
- * @description Bmp class constructor
+ * @description Bmp class constructor. The image gets a grey palette (index i is grey level i)
  * @param size_t width
  * @param size_t height
  * @param uint8_t default color
 **/
 
-Bmp8::Bmp8(size_t width, size_t height, uint8_t defaultColor) : Bmp(width, height) {
-  //Set bits per pixel
-  header->bitsPerPixel = 8;
-  //FileSize must be set by child class
-  size_t nextMultipleOf4 = roundToMultiple(width * (header->bitsPerPixel / 8), 4);
-  size_t paddingSize = nextMultipleOf4 - (header->width * (header->bitsPerPixel / 8));
-  size_t rowSize = paddingSize + ((width * header->bitsPerPixel / 8));
-  size_t dataSize = rowSize * height;
-  header->fileSize = 54 + dataSize;
-  //DataSize must be set by child class
-  header->dataSize = dataSize;
-  //Create empty image
-  size_t arraySize = header->width * header->height;
-  pixelArray.reserve(arraySize);
-  for (size_t i = 0; i < arraySize; i++) {
-    pixelArray.push_back(new BytePixel(defaultColor));
-  }
+Bmp8::Bmp8(size_t width, size_t height, uint8_t defaultColor) : BmpImage<ByteFormat>(width, height, BytePixel(defaultColor)) {
+  compression = Compression::NONE;
+  setPalette(getGreyPalette());
 }
 
 /**
@@ -74,13 +178,9 @@ Bmp8::Bmp8(size_t width, size_t height, uint8_t defaultColor) : Bmp(width, heigh
  * @param const Bmp& bmp
  */
 
-Bmp8::Bmp8(const Bmp8& bmp) : Bmp(bmp) {
-  //Copy pixel array to new bmp
-  size_t arraySize = bmp.pixelArray.size();
-  for (size_t i = 0; i < arraySize; i++) {
-    BytePixel* copyPixel = reinterpret_cast<BytePixel*>(bmp.pixelArray.at(i));
-    pixelArray.push_back(new BytePixel(copyPixel->getValue()));
-  }
+Bmp8::Bmp8(const Bmp8& bmp) : BmpImage<ByteFormat>(bmp) {
+  //Pixels are copied by Bmp
+  compression = bmp.compression;
 }
 
 /**
@@ -89,13 +189,22 @@ Bmp8::Bmp8(const Bmp8& bmp) : Bmp(bmp) {
  * @param const Bmp& bmp
  */
 
-Bmp8::Bmp8(Bmp8* bmp) : Bmp(bmp) {
-  //Copy pixel array to new bmp
-  size_t arraySize = bmp->pixelArray.size();
-  for (size_t i = 0; i < arraySize; i++) {
-    BytePixel* copyPixel = reinterpret_cast<BytePixel*>(bmp->pixelArray.at(i));
-    pixelArray.push_back(new BytePixel(copyPixel->getValue()));
-  }
+Bmp8::Bmp8(Bmp8* bmp) : BmpImage<ByteFormat>(bmp) {
+  //Pixels are copied by Bmp
+  compression = bmp->compression;
+}
+
+/**
+ * @function operator=
+ * @description Bmp8 class copy assignment
+ * @param const Bmp8& bmp
+ * @returns Bmp8&
+**/
+
+Bmp8& Bmp8::operator=(const Bmp8& bmp) {
+  BmpImage<ByteFormat>::operator=(bmp);
+  compression = bmp.compression;
+  return *this;
 }
 
 /**
@@ -107,218 +216,398 @@ Bmp8::~Bmp8() {
   
 }
 
+/**
+ * @function decodeBmp
+ * @description decode Bmp data buffer. RLE8, RLE4 and 4 bits bitmaps are decoded to 8 bits (one palette index per byte)
+ * @param uint8_t*
+ * @param size_t
+ * @returns bool
+**/
 
 bool Bmp8::decodeBmp(uint8_t* bmpData, size_t dataSize) {
 
-  //Call superclass decodeBmp to decode header
+  Header fileHeader;
+  if (!decodeHeader(bmpData, dataSize, fileHeader)) {
+    return false;
+  }
+  //Uncompressed 8 bits rows are copied as they are
+  if (fileHeader.bitsPerPixel == 8 && fileHeader.biRgb == BI_RGB) {
+    return BmpImage<ByteFormat>::decodeBmp(bmpData, dataSize);
+  }
+  //RLE bitmaps can't be top-down
+  bool rle8 = fileHeader.bitsPerPixel == 8 && fileHeader.biRgb == BI_RLE8 && !fileHeader.topDown;
+  bool rle4 = fileHeader.bitsPerPixel == 4 && fileHeader.biRgb == BI_RLE4 && !fileHeader.topDown;
+  bool fourBits = fileHeader.bitsPerPixel == 4 && fileHeader.biRgb == BI_RGB;
+  if (!rle8 && !rle4 && !fourBits) {
+    return false;
+  }
+  //Call superclass decodeBmp to decode header and keep the palette
   if (!Bmp::decodeBmp(bmpData, dataSize)) {
     return false;
   }
-  //Get data
-  size_t nextMultipleOf4 = roundToMultiple(header->width * (header->bitsPerPixel / 8), 4);
-  size_t paddingSize = nextMultipleOf4 - (header->width * (header->bitsPerPixel / 8));
-  size_t realRowSize = (header->width * (header->bitsPerPixel / 8));
-  size_t rowPositionCounter = 0;
-  for (size_t dataPtr = header->dataOffset - 1; dataPtr < header->fileSize - 1;) {
-    //Store Pixels for each byte NOTE: BMP is 0/1
-    uint8_t value = bmpData[++dataPtr];
-    //Create new pixel
-    pixelArray.push_back(new BytePixel(value));
-    rowPositionCounter++;
-    //If row has been parsed, go to next line
-    if (rowPositionCounter >= realRowSize) {
-      rowPositionCounter = 0;
-      dataPtr += paddingSize;
-    }
+  const uint8_t* rasterData = bmpData + header->dataOffset;
+  size_t rasterSize = dataSize - header->dataOffset;
+  bool rc = fourBits ? decodeFourBits(rasterData, rasterSize) : decodeRle(rasterData, rasterSize, rle4);
+  if (!rc) {
+    return false;
+  }
+  //The raster is now an uncompressed 8 bits one; a 4 bits palette has 16 colors at most
+  if (header->bitsPerPixel == 4 && header->paletteSize == 0) {
+    header->paletteSize = 16;
   }
+  header->bitsPerPixel = 8;
+  header->biRgb = BI_RGB;
   return true;
 
 }
 
 /**
- * @function encodeBmp
- * @description: encodes bitmap to buffer
- * @param size_t*
- * @returns uint8_t*
+ * @function decodeRegion
+ * @description decode only an area of Bmp data buffer. Uncompressed 8 bits rows of the area are read directly (see BmpImage::decodeRegion);
+ * RLE and 4 bits bitmaps have no row offsets, so they are decoded and then cropped
+ * @param uint8_t*
+ * @param size_t
+ * @param size_t xOffset
+ * @param size_t yOffset
+ * @param size_t width
+ * @param size_t height
+ * @returns bool
 **/
 
-uint8_t* Bmp8::encodeBmp(size_t& dataSize) {
-  //Get our fundamental parameters
-  size_t nextMultipleOf4 = roundToMultiple(header->width * (header->bitsPerPixel / 8), 4);
-  size_t paddingSize = nextMultipleOf4 - header->width * (header->bitsPerPixel / 8);
-  size_t realRowSize = (header->width * (header->bitsPerPixel / 8));
-  //Fill header and get bmpData with fixed size
-  uint8_t* bmpData = Bmp::encodeBmp(dataSize);
-  //Return nullptr if needed
-  if (bmpData == nullptr) {
-    return nullptr;
+bool Bmp8::decodeRegion(uint8_t* bmpData, size_t dataSize, size_t xOffset, size_t yOffset, size_t width, size_t height) {
+
+  Header fileHeader;
+  if (!decodeHeader(bmpData, dataSize, fileHeader)) {
+    return false;
   }
-  
-  //Fill data
-  int pxIndex = -1;
-  size_t rowPositionCounter = 0;
-  for (size_t dataPtr = header->dataOffset - 1; dataPtr < dataSize - 1;) {
-    //Set pixel
-    BytePixel* currPixel = reinterpret_cast<BytePixel*>(pixelArray.at(++pxIndex));
-    bmpData[++dataPtr] = currPixel->getValue();
-    //Check if row has to be closed
-    rowPositionCounter++;
-    if (rowPositionCounter >= realRowSize) {
-      //Fill row with padding and go on new line
-      rowPositionCounter = 0;
-      for (size_t i = 0; i < paddingSize; i++) {
-        bmpData[++dataPtr] = 0;
-      }
-    }
+  if (fileHeader.bitsPerPixel == 8 && fileHeader.biRgb == BI_RGB) {
+    return BmpImage<ByteFormat>::decodeRegion(bmpData, dataSize, xOffset, yOffset, width, height);
   }
-  return bmpData;
+  if (width == 0 || height == 0 || width > fileHeader.width || height > fileHeader.height) {
+    return false;
+  }
+  if (xOffset > fileHeader.width - width || yOffset > fileHeader.height - height) {
+    return false;
+  }
+  if (!decodeBmp(bmpData, dataSize)) {
+    return false;
+  }
+  return scaleArea(width, height, xOffset, yOffset);
+
 }
 
 /**
- * @function readBmp
- * @description read a BMP file and decodes it. The decoded Bmp becomes the object
- * @param const std::string& bmpFile
+ * @function decodeDownscaled
+ * @description decode Bmp data buffer downscaling it to width x height (see BmpImage::decodeDownscaled).
+ * Values are averaged only with a grey palette, otherwise the pixel in the center of each box is kept;
+ * RLE and 4 bits bitmaps have no row offsets, so they are decoded and then downscaled
+ * @param uint8_t*
+ * @param size_t
+ * @param size_t width
+ * @param size_t height
  * @returns bool
- */
+**/
 
-bool Bmp8::readBmp(const std::string& bmpFile) {
-  std::ifstream iFile;
-  iFile.open(bmpFile, std::ios::binary | std::ios::ate);
-  if (!iFile.is_open()) {
+bool Bmp8::decodeDownscaled(uint8_t* bmpData, size_t dataSize, size_t width, size_t height) {
+
+  Header fileHeader;
+  if (!decodeHeader(bmpData, dataSize, fileHeader)) {
+    return false;
+  }
+  if (fileHeader.bitsPerPixel != 8 || fileHeader.biRgb != BI_RGB) {
+    return decodeBmp(bmpData, dataSize) && downscaleBuffer(width, height, hasGreyPalette());
+  }
+  if (!Bmp::decodeDownscaled(bmpData, dataSize, width, height)) {
     return false;
   }
-  std::streamsize size = iFile.tellg();
-  iFile.seekg(0, std::ios::beg);
-  char* dataBuffer = new char[size];
-  if (!iFile.read(dataBuffer, size)) {
-    delete[] dataBuffer;
+  size_t rowSize = PixelBuffer::strideFor(header->width, 8);
+  if (!hasRaster(dataSize)) {
     return false;
   }
-  iFile.close();
-  //Decode
-  bool rc = decodeBmp(reinterpret_cast<uint8_t*>(dataBuffer), size);
-  delete[] dataBuffer;
-  return rc;
+  return downscaleRaster(bmpData + header->dataOffset, rowSize, header->topDown, width, height, hasGreyPalette());
+
 }
 
 /**
- * @function writeBmp
- * @description encode BMP write the buffer to a file.
- * @param const std::string& bmpFile
+ * @function resizeImage
+ * @description resize image resampling it with the provided filter (see BmpImage::resizeImage). Indexes are resampled only with a grey palette,
+ * where they are grey levels; otherwise each pixel keeps the index of the source pixel under its center, since blended indexes are unrelated colors
+ * @param size_t
+ * @param size_t
+ * @param Filter
  * @returns bool
- */
+**/
 
-bool Bmp8::writeBmp(const std::string& bmpFile) {
-  size_t outDataSize;
-  uint8_t* outBuf = encodeBmp(outDataSize);
-  if (outBuf == nullptr) {
+bool Bmp8::resizeImage(size_t width, size_t height, Filter filter) {
+  if (header == nullptr) {
     return false;
   }
-  //Write file
-  std::ofstream outFile;
-  outFile.open(bmpFile);
-  if (!outFile.is_open()) {
-    delete[] outBuf;
+  if (!hasGreyPalette()) {
+    return resizeNearest(width, height);
+  }
+  return BmpImage<ByteFormat>::resizeImage(width, height, filter);
+}
+
+/**
+ * @function buildPyramid
+ * @description build the levels of an image pyramid (see BmpImage::buildPyramid). Blocks are averaged only with a grey palette;
+ * otherwise each level keeps the first pixel of every 2x2 block, so that levels have the colors of the palette
+ * @param size_t levels
+ * @param BmpPyramid& pyramid
+ * @returns bool
+**/
+
+bool Bmp8::buildPyramid(size_t levels, BmpPyramid& pyramid) {
+  if (header == nullptr) {
     return false;
   }
-  for (size_t i = 0; i < outDataSize; i++) {
-    outFile << outBuf[i];
+  return buildLevels(levels, pyramid, hasGreyPalette());
+}
+
+/**
+ * @function hasGreyPalette
+ * @description returns whether each palette index is the grey level with the same value (or there's no palette)
+ * @returns bool
+**/
+
+bool Bmp8::hasGreyPalette() {
+
+  RGBAPixel* palette = getPalette();
+  size_t colors = getPaletteSize();
+  for (size_t index = 0; index < colors; index++) {
+    if (palette[index].getBlue() != index || palette[index].getGreen() != index || palette[index].getRed() != index) {
+      return false;
+    }
   }
-  outFile.close();
-  delete[] outBuf;
   return true;
+
 }
 
 /**
- * @function resizeArea
- * @description resize area (does not scale image), both enlarging or scaling it
- * @param size_t width
- * @param size_t height
- * @param size_t xOffset (optional)
- * @param size_t yOffset (optional)
+ * @function getPaletteTable
+ * @description fill table with the 256 palette entries (4 bytes each: blue, green, red, reserved) used to expand indexes.
+ * Indexes past the end of the palette are black; without a palette, index i is grey level i
+ * @param uint8_t* table (1024 bytes)
+**/
+
+void Bmp8::getPaletteTable(uint8_t* table) {
+
+  RGBAPixel* palette = getPalette();
+  if (palette == nullptr) {
+    for (size_t index = 0; index < PALETTE_MAX_COLORS; index++) {
+      memset(table + (index * 4), static_cast<int>(index), 3);
+      table[(index * 4) + 3] = 0;
+    }
+    return;
+  }
+  size_t colors = getPaletteSize();
+  memcpy(table, palette, colors * 4);
+  memset(table + (colors * 4), 0, (PALETTE_MAX_COLORS - colors) * 4);
+
+}
+
+/**
+ * @function decodeRle
+ * @description decode RLE8 (or RLE4) data into pixel buffer. Skipped pixels are set to 0
+ * @param const uint8_t*
+ * @param size_t
+ * @param bool
  * @returns bool
 **/
 
-bool Bmp8::resizeArea(size_t width, size_t height, size_t xOffset /* = 0*/, size_t yOffset /* = 0*/) {
-
-  while (header->width != width || header->height != height) {
-    size_t currWidth = header->width;
-    size_t currHeight = header->height;
-    //Resize image in order to match user requests; start with enlarging if necessary
-    if (width > currWidth || height > currHeight) {
-      //Pass higher size or current one to enlarge
-      size_t enlargedWidth = (width > currWidth) ? width : currWidth;
-      size_t enlargedHeight = (height > currHeight) ? height : currHeight;
-      //Initialize Pixel lambda
-      std::function<void(Pixel*&)> initializePixel = [](Pixel*& px) { px = new BytePixel(255); };
-      if (!enlargeArea(enlargedWidth, enlargedHeight, initializePixel, xOffset, yOffset)) {
-        return false;
+bool Bmp8::decodeRle(const uint8_t* rleData, size_t rleSize, bool fourBits) {
+
+  size_t width = header->width;
+  size_t height = header->height;
+  if (!pixelBuffer.allocate(width, height, 8)) {
+    return false;
+  }
+  //Rows are encoded bottom to top, as in the pixel buffer
+  size_t column = 0;
+  size_t row = 0;
+  uint8_t* rowData = height > 0 ? pixelBuffer.getRow(0) : nullptr;
+  size_t position = 0;
+  while (position + 1 < rleSize && row < height) {
+    uint8_t count = rleData[position];
+    uint8_t value = rleData[position + 1];
+    position += 2;
+    if (count > 0) {
+      //Encoded mode: count pixels; with 4 bits, pixels alternate the two nibbles of value
+      size_t pixels = (column < width) ? width - column : 0;
+      pixels = (count < pixels) ? count : pixels;
+      if (fourBits) {
+        for (size_t i = 0; i < pixels; i++) {
+          rowData[column + i] = (i & 1) ? value & 0x0F : value >> 4;
+        }
+      } else {
+        memset(rowData + column, value, pixels);
       }
+      column += count;
       continue;
     }
-    //Also, scale area if necessary
-    if (width < currWidth || height << currHeight) {
-      //Pass lower size or current one to scale
-      size_t scaledWidth = (width < currWidth) ? width : currWidth;
-      size_t scaledHeight = (height < currHeight) ? height : currHeight;
-      //Scale image
-      if (!scaleArea(scaledWidth, scaledHeight, xOffset, yOffset)) {
-        return false;
+    if (value == 0) {
+      //End of line
+      column = 0;
+      row++;
+      rowData = row < height ? pixelBuffer.getRow(row) : nullptr;
+    } else if (value == 1) {
+      //End of bitmap
+      break;
+    } else if (value == 2) {
+      //Delta
+      if (position + 1 >= rleSize) {
+        break;
       }
-      continue;
+      column += rleData[position];
+      row += rleData[position + 1];
+      position += 2;
+      rowData = row < height ? pixelBuffer.getRow(row) : nullptr;
+    } else {
+      //Absolute mode: value pixels, padded to 16 bits
+      size_t absoluteSize = fourBits ? (value + 1) / 2 : value;
+      if (position + absoluteSize > rleSize) {
+        break;
+      }
+      const uint8_t* absoluteData = rleData + position;
+      size_t pixels = (column < width) ? width - column : 0;
+      pixels = (value < pixels) ? value : pixels;
+      if (fourBits) {
+        for (size_t i = 0; i < pixels; i++) {
+          rowData[column + i] = (i & 1) ? absoluteData[i / 2] & 0x0F : absoluteData[i / 2] >> 4;
+        }
+      } else {
+        memcpy(rowData + column, absoluteData, pixels);
+      }
+      column += value;
+      position += (absoluteSize + 1) & ~static_cast<size_t>(1);
     }
   }
-  //Return OK
   return true;
+
 }
 
 /**
- * @function resizeImage
- * @description resize image (not only area) applying bilinear image scaling
- * @param size_t
+ * @function decodeFourBits
+ * @description decode an uncompressed 4 bits raster into pixel buffer
+ * @param const uint8_t*
  * @param size_t
  * @returns bool
 **/
 
-bool Bmp8::resizeImage(size_t width, size_t height) {
-  //Apply resizing
-  size_t prevWidth = header->width;
-  size_t prevHeight = header->height;
-  std::vector<Pixel*> resizedArray; //New pixel vector
-  float xRatio = static_cast<float>(prevWidth - 1) / width;
-  float yRatio = static_cast<float>(prevHeight - 1) / height;
-  //Working variables
-  BytePixel *px1, *px2, *px3, *px4;
-  int x, y, index;
-  float xDiff, yDiff;
-  uint8_t value;
+bool Bmp8::decodeFourBits(const uint8_t* rasterData, size_t rasterSize) {
+
+  size_t width = header->width;
+  size_t height = header->height;
+  size_t rowSize = PixelBuffer::strideFor(width, 4);
+  size_t realRowSize = (width + 1) / 2;
+  //Check that the whole raster is in the buffer
+  if (height > 0 && (rowSize * (height - 1)) + realRowSize > rasterSize) {
+    return false;
+  }
+  if (!pixelBuffer.allocate(width, height, 8)) {
+    return false;
+  }
   for (size_t row = 0; row < height; row++) {
+    //Top-down rows are read in reverse order
+    const uint8_t* srcRow = rasterData + ((header->topDown ? height - 1 - row : row) * rowSize);
+    uint8_t* dstRow = pixelBuffer.getRow(row);
     for (size_t column = 0; column < width; column++) {
-      x = static_cast<int>(xRatio * column);
-      y = static_cast<int>(yRatio * row);
-      xDiff = (xRatio * column) - x;
-      yDiff = (yRatio * row) - y;
-      index = ((y * prevWidth) + x);
-      px1 = reinterpret_cast<BytePixel*>(pixelArray.at(index));
-      px2 = reinterpret_cast<BytePixel*>(pixelArray.at(index + 1));
-      px3 = reinterpret_cast<BytePixel*>(pixelArray.at(index + prevWidth));
-      px4 = reinterpret_cast<BytePixel*>(pixelArray.at(index + prevWidth + 1));
-      //Yb = Ab(1-w)(1-h) + Bb(w)(1-h) + Cb(h)(1-w) + Db(wh)
-      value = (px1->getValue() * (1 - xDiff) * (1 - yDiff)) + (px2->getValue() * (xDiff) * (1 - yDiff)) + (px3->getValue() * (yDiff) * (1 - xDiff)) + (px4->getValue() * (xDiff * yDiff));
-      //Instance new pixel
-      Pixel* resizedPixel = new BytePixel(value);
-      //Push pixel into array
-      resizedArray.push_back(resizedPixel);
+      dstRow[column] = (column & 1) ? srcRow[column / 2] & 0x0F : srcRow[column / 2] >> 4;
     }
   }
-  //Delete all pixels in previous pixel array
-  for (auto& pixel : pixelArray) {
-    BytePixel* px = reinterpret_cast<BytePixel*>(pixel);
-    delete px;
+  return true;
+
+}
+
+/**
+ * @function encodeBmp
+ * @description: encodes bitmap to buffer; with RLE8 compression pixels are run length encoded,
+ * with AUTO compression the smaller between RLE8 and uncompressed is encoded
+ * @param size_t*
+ * @returns uint8_t*
+**/
+
+uint8_t* Bmp8::encodeBmp(size_t& dataSize) {
+
+  if (compression == Compression::NONE || header == nullptr) {
+    return BmpImage<ByteFormat>::encodeBmp(dataSize);
   }
-  pixelArray = resizedArray;
-  //Change header parameters
-  return Bmp::resizeImage(width, height);
+  size_t rawDataSize = getEncodedSize() - header->dataOffset;
+  //RLE8 takes 2 bytes per pixel at most, plus end of line markers
+  size_t maxRleSize = header->height * (2 * static_cast<size_t>(header->width) + 2);
+  if (compression == Compression::AUTO) {
+    maxRleSize = rawDataSize > 0 ? rawDataSize - 1 : 0;
+  }
+  uint8_t* bmpData = new uint8_t[header->dataOffset + maxRleSize];
+  size_t rleSize = encodeRle8(pixelBuffer, bmpData + header->dataOffset, maxRleSize);
+  if (rleSize == 0) {
+    //Uncompressed is smaller
+    delete[] bmpData;
+    return BmpImage<ByteFormat>::encodeBmp(dataSize);
+  }
+  //RLE bitmaps are always bottom-up
+  Header rleHeader = *header;
+  rleHeader.topDown = false;
+  rleHeader.biRgb = BI_RLE8;
+  rleHeader.dataSize = rleSize;
+  rleHeader.fileSize = header->dataOffset + rleSize;
+  encodeHeader(rleHeader, bmpData);
+  if (dibData != nullptr) {
+    memcpy(bmpData + 54, dibData, header->dataOffset - 54);
+  }
+  dataSize = rleHeader.fileSize;
+  return bmpData;
+
+}
+
+/**
+ * @function writeBmp
+ * @description encode BMP and write it to a file; uncompressed bitmaps are written straight from the pixel buffer
+ * @param const std::string& bmpFile
+ * @returns bool
+**/
+
+bool Bmp8::writeBmp(const std::string& bmpFile) {
+
+  if (compression == Compression::NONE) {
+    return BmpImage<ByteFormat>::writeBmp(bmpFile);
+  }
+  size_t outDataSize;
+  uint8_t* outBuf = encodeBmp(outDataSize);
+  if (outBuf == nullptr) {
+    return false;
+  }
+  std::ofstream outFile;
+  outFile.open(bmpFile, std::ios::binary);
+  if (!outFile.is_open()) {
+    delete[] outBuf;
+    return false;
+  }
+  outFile.write(reinterpret_cast<const char*>(outBuf), outDataSize);
+  delete[] outBuf;
+  outFile.close();
+  return !outFile.fail();
+
+}
+
+/**
+ * @function setCompression
+ * @description set the compression used by encodeBmp and writeBmp (NONE by default)
+ * @param Compression
+**/
+
+void Bmp8::setCompression(Compression compression) {
+  this->compression = compression;
+}
+
+/**
+ * @function getCompression
+ * @description returns the compression used by encodeBmp and writeBmp
+ * @returns Compression
+**/
+
+Compression Bmp8::getCompression() {
+  return compression;
 }
 
 /**
@@ -347,43 +636,404 @@ bool Bmp8::setPixelAt(size_t row, size_t column, uint8_t value) {
 **/
 
 bool Bmp8::setPixelAt(size_t index, uint8_t value) {
-  if (index >= pixelArray.size()) {
+  if (index >= pixelBuffer.getPixelCount()) {
     return false;
   }
-  BytePixel* reqPixel = reinterpret_cast<BytePixel*>(pixelArray.at(index));
+  BytePixel* reqPixel = reinterpret_cast<BytePixel*>(pixelBuffer.getPixel(index));
   reqPixel->setPixel(value);
   return true;
 }
 
 /**
- * @function getPixelAt
- * @description return pointer to pixel in the provided position
+ * @function getColorAt
+ * @description get the palette color of the pixel in a certain position
  * @param size_t
  * @param size_t
- * @returns RGBPixel*
+ * @param RGBAPixel&
+ * @returns bool
 **/
 
-BytePixel* Bmp8::getPixelAt(size_t row, size_t column) {
+bool Bmp8::getColorAt(size_t row, size_t column, RGBAPixel& color) {
+
+  if (header == nullptr || row >= header->height || column >= header->width) {
+    return false;
+  }
+  uint8_t index = getIndexRow(row)[column];
+  RGBAPixel* palette = getPalette();
+  if (palette == nullptr) {
+    color.setPixel(index, index, index, 0);
+    return true;
+  }
+  if (index >= getPaletteSize()) {
+    return false;
+  }
+  color = palette[index];
+  return true;
 
-  //Get index, considering that pixels are stored bottom to top
-  size_t reversedRow = (header->height - 1 - row); // h - 1 - r
-  size_t index = (header->width * reversedRow) + column;
-  return getPixelAt(index);
 }
 
 /**
- * @function getPixelAt
- * @description return pointer to pixel in the provided position
+ * @function getIndexRow
+ * @description returns the palette indexes of a row (row 0 is the top one), nullptr if row is out of range
  * @param size_t
- * @returns RGBPixel*
+ * @returns uint8_t*
+**/
+
+uint8_t* Bmp8::getIndexRow(size_t row) {
+
+  if (header == nullptr || row >= header->height) {
+    return nullptr;
+  }
+  //Pixels are stored bottom to top
+  return pixelBuffer.getRow(header->height - 1 - row);
+
+}
+
+/**
+ * @function getPalette
+ * @description returns the palette colors, stored in place in the color table; nullptr if the image has no palette
+ * @returns RGBAPixel*
+**/
+
+RGBAPixel* Bmp8::getPalette() {
+
+  if (getPaletteSize() == 0) {
+    return nullptr;
+  }
+  //Palette follows the info header
+  size_t paletteOffset = (header->dibSize > 40) ? header->dibSize - 40 : 0;
+  return reinterpret_cast<RGBAPixel*>(dibData + paletteOffset);
+
+}
+
+/**
+ * @function getPaletteSize
+ * @description returns the amount of colors in the palette (256 at most)
+ * @returns size_t
+**/
+
+size_t Bmp8::getPaletteSize() {
+
+  if (header == nullptr || dibData == nullptr) {
+    return 0;
+  }
+  size_t paletteOffset = (header->dibSize > 40) ? header->dibSize - 40 : 0;
+  size_t dibDataSize = header->dataOffset - 54;
+  if (dibDataSize <= paletteOffset) {
+    return 0;
+  }
+  //A palette size of 0 means all the colors which fit in the color table
+  size_t colors = (dibDataSize - paletteOffset) / 4;
+  if (header->paletteSize > 0 && header->paletteSize < colors) {
+    colors = header->paletteSize;
+  }
+  if (colors > PALETTE_MAX_COLORS) {
+    colors = PALETTE_MAX_COLORS;
+  }
+  return colors;
+
+}
+
+/**
+ * @function setPalette
+ * @description replace the palette with the provided colors (1 to 256); pixels keep their indexes
+ * @param const std::vector<RGBAPixel>&
+ * @returns bool
+**/
+
+bool Bmp8::setPalette(const std::vector<RGBAPixel>& palette) {
+
+  if (header == nullptr || palette.empty() || palette.size() > PALETTE_MAX_COLORS) {
+    return false;
+  }
+  //Keep the info header fields which follow the first 40 bytes
+  size_t paletteOffset = (header->dibSize > 40) ? header->dibSize - 40 : 0;
+  size_t dibDataSize = header->dataOffset - 54;
+  size_t paletteBytes = palette.size() * 4;
+  uint8_t* newDibData = new uint8_t[paletteOffset + paletteBytes];
+  memset(newDibData, 0x00, paletteOffset);
+  if (dibData != nullptr) {
+    memcpy(newDibData, dibData, (dibDataSize < paletteOffset) ? dibDataSize : paletteOffset);
+  }
+  memcpy(newDibData + paletteOffset, palette.data(), paletteBytes);
+  delete[] dibData;
+  dibData = newDibData;
+  header->dataOffset = 54 + paletteOffset + paletteBytes;
+  header->paletteSize = palette.size();
+  if (header->importantColors > palette.size()) {
+    header->importantColors = 0;
+  }
+  header->fileSize = header->dataOffset + header->dataSize;
+  return true;
+
+}
+
+/**
+ * @function toBmp24
+ * @description returns a new 24 bits bitmap with the palette colors of the pixels (nullptr on failure)
+ * @returns Bmp24*
+**/
+
+Bmp24* Bmp8::toBmp24() {
+
+  if (header == nullptr) {
+    return nullptr;
+  }
+  uint8_t table[PALETTE_MAX_COLORS * 4];
+  getPaletteTable(table);
+  size_t width = header->width;
+  Bmp24* bmp = new Bmp24(width, header->height);
+  bmp->setTopDown(header->topDown);
+  bmp->setThreads(threads);
+  forEachBand(header->height, width * 3, [this, bmp, width, &table](size_t firstRow, size_t lastRow) {
+    for (size_t row = firstRow; row < lastRow; row++) {
+      uint8_t* dstRow = reinterpret_cast<uint8_t*>(bmp->getPixelAt(row * width));
+      Swizzle::expandPalette24(pixelBuffer.getRow(row), dstRow, width, table);
+    }
+  });
+  return bmp;
+
+}
+
+/**
+ * @function toBmp32
+ * @description returns a new 32 bits bitmap with the palette colors of the pixels (nullptr on failure).
+ * The reserved byte of palette entries becomes the alpha channel
+ * @returns Bmp32*
+**/
+
+Bmp32* Bmp8::toBmp32() {
+
+  if (header == nullptr) {
+    return nullptr;
+  }
+  uint8_t table[PALETTE_MAX_COLORS * 4];
+  getPaletteTable(table);
+  size_t width = header->width;
+  Bmp32* bmp = new Bmp32(width, header->height);
+  bmp->setTopDown(header->topDown);
+  bmp->setThreads(threads);
+  forEachBand(header->height, width * 4, [this, bmp, width, &table](size_t firstRow, size_t lastRow) {
+    for (size_t row = firstRow; row < lastRow; row++) {
+      uint8_t* dstRow = reinterpret_cast<uint8_t*>(bmp->getPixelAt(row * width));
+      Swizzle::expandPalette32(pixelBuffer.getRow(row), dstRow, width, table);
+    }
+  });
+  return bmp;
+
+}
+
+/**
+ * @function toGreyScale
+ * @description convert the palette colors to grey with the provided weights (see GreyScale); if greyLevels is set, provided amount of greys will be used.
+ * Only the palette is changed (pixels keep their indexes)
+ * @param int
+ * @param GreyWeights
+ * @returns bool
+**/
+
+bool Bmp8::toGreyScale(int greyLevels /*= 255*/, GreyWeights weights /* = GreyWeights::AVERAGE */) {
+
+  if (greyLevels < 1) {
+    return false;
+  }
+  RGBAPixel* palette = getEditablePalette();
+  if (palette == nullptr) {
+    return false;
+  }
+  GreyScale greyScale(weights, greyLevels);
+  size_t colors = getPaletteSize();
+  for (size_t index = 0; index < colors; index++) {
+    RGBAPixel& color = palette[index];
+    uint8_t greyValue = greyScale.getGrey(color.getRed(), color.getGreen(), color.getBlue());
+    color.setPixel(greyValue, greyValue, greyValue, color.getAlpha());
+  }
+  return true;
+
+}
+
+/**
+ * @function toSepiaTone
+ * @description convert the palette colors to sepia tone. Only the palette is changed (pixels keep their indexes)
+ * @returns bool
+**/
+
+bool Bmp8::toSepiaTone() {
+
+  RGBAPixel* palette = getEditablePalette();
+  if (palette == nullptr) {
+    return false;
+  }
+  size_t colors = getPaletteSize();
+  for (size_t index = 0; index < colors; index++) {
+    RGBAPixel& color = palette[index];
+    uint8_t red = MIN((color.getRed() * 0.393) + (color.getGreen() * 0.769) + (color.getBlue() * 0.189), 255);
+    uint8_t green = MIN((color.getRed() * 0.349) + (color.getGreen() * 0.686) + (color.getBlue() * 0.168), 255);
+    uint8_t blue = MIN((color.getRed() * 0.272) + (color.getGreen() * 0.534) + (color.getBlue() * 0.131), 255);
+    color.setPixel(red, green, blue, color.getAlpha());
+  }
+  return true;
+
+}
+
+/**
+ * @function invert
+ * @description invert the palette colors. Only the palette is changed (pixels keep their indexes)
+ * @returns bool
+**/
+
+bool Bmp8::invert() {
+
+  RGBAPixel* palette = getEditablePalette();
+  if (palette == nullptr) {
+    return false;
+  }
+  size_t colors = getPaletteSize();
+  for (size_t index = 0; index < colors; index++) {
+    RGBAPixel& color = palette[index];
+    color.setPixel(255 - color.getRed(), 255 - color.getGreen(), 255 - color.getBlue(), color.getAlpha());
+  }
+  return true;
+
+}
+
+/**
+ * @function applyGamma
+ * @description apply gamma correction to the palette colors: each channel c becomes 255 * (c / 255) ^ (1 / gamma).
+ * Only the palette is changed (pixels keep their indexes)
+ * @param double
+ * @returns bool
+**/
+
+bool Bmp8::applyGamma(double gamma) {
+
+  if (!(gamma > 0)) {
+    return false;
+  }
+  RGBAPixel* palette = getEditablePalette();
+  if (palette == nullptr) {
+    return false;
+  }
+  //Channels have 256 values only
+  uint8_t levels[256];
+  for (size_t level = 0; level < 256; level++) {
+    levels[level] = static_cast<uint8_t>(std::pow(level / 255.0, 1.0 / gamma) * 255.0 + 0.5);
+  }
+  size_t colors = getPaletteSize();
+  for (size_t index = 0; index < colors; index++) {
+    RGBAPixel& color = palette[index];
+    color.setPixel(levels[color.getRed()], levels[color.getGreen()], levels[color.getBlue()], color.getAlpha());
+  }
+  return true;
+
+}
+
+/**
+ * @function remapIndexes
+ * @description replace each pixel index i with indexMap[i] (indexes past the end of indexMap are kept), in a single pass over the pixels.
+ * The palette is not changed; mapped indexes must be in the palette
+ * @param const std::vector<uint8_t>&
+ * @returns bool
 **/
 
-BytePixel* Bmp8::getPixelAt(size_t index) {
+bool Bmp8::remapIndexes(const std::vector<uint8_t>& indexMap) {
 
-  if (index >= pixelArray.size()) {
+  if (header == nullptr || indexMap.size() > PALETTE_MAX_COLORS) {
+    return false;
+  }
+  size_t colors = getPaletteSize();
+  uint8_t table[PALETTE_MAX_COLORS];
+  for (size_t index = 0; index < PALETTE_MAX_COLORS; index++) {
+    table[index] = static_cast<uint8_t>(index);
+  }
+  for (size_t index = 0; index < indexMap.size(); index++) {
+    if (colors > 0 && indexMap[index] >= colors) {
+      return false;
+    }
+    table[index] = indexMap[index];
+  }
+  size_t width = header->width;
+  forEachBand(header->height, width, [this, width, &table](size_t firstRow, size_t lastRow) {
+    for (size_t row = firstRow; row < lastRow; row++) {
+      uint8_t* indexes = pixelBuffer.getRow(row);
+      for (size_t column = 0; column < width; column++) {
+        indexes[column] = table[indexes[column]];
+      }
+    }
+  });
+  return true;
+
+}
+
+/**
+ * @function swapPaletteEntries
+ * @description swap two palette entries and the indexes of the pixels which use them; the image looks the same
+ * @param uint8_t
+ * @param uint8_t
+ * @returns bool
+**/
+
+bool Bmp8::swapPaletteEntries(uint8_t first, uint8_t second) {
+
+  RGBAPixel* palette = getPalette();
+  if (palette == nullptr || first >= getPaletteSize() || second >= getPaletteSize()) {
+    return false;
+  }
+  if (first == second) {
+    return true;
+  }
+  std::vector<uint8_t> indexMap(PALETTE_MAX_COLORS);
+  for (size_t index = 0; index < PALETTE_MAX_COLORS; index++) {
+    indexMap[index] = static_cast<uint8_t>(index);
+  }
+  indexMap[first] = second;
+  indexMap[second] = first;
+  if (!remapIndexes(indexMap)) {
+    return false;
+  }
+  std::swap(palette[first], palette[second]);
+  return true;
+
+}
+
+/**
+ * @function mergePaletteEntries
+ * @description make the pixels which use the palette entry source use target; source is left in the palette, unused
+ * @param uint8_t source
+ * @param uint8_t target
+ * @returns bool
+**/
+
+bool Bmp8::mergePaletteEntries(uint8_t source, uint8_t target) {
+
+  if (getPalette() == nullptr || source >= getPaletteSize() || target >= getPaletteSize()) {
+    return false;
+  }
+  std::vector<uint8_t> indexMap(static_cast<size_t>(source) + 1);
+  for (size_t index = 0; index < indexMap.size(); index++) {
+    indexMap[index] = static_cast<uint8_t>(index);
+  }
+  indexMap[source] = target;
+  return remapIndexes(indexMap);
+
+}
+
+/**
+ * @function getEditablePalette
+ * @description returns the palette; a bitmap without a palette gets the grey one it is displayed with. nullptr on failure
+ * @returns RGBAPixel*
+**/
+
+RGBAPixel* Bmp8::getEditablePalette() {
+
+  if (header == nullptr) {
     return nullptr;
   }
-  return reinterpret_cast<BytePixel*>(pixelArray.at(index));
+  if (getPaletteSize() == 0 && !setPalette(getGreyPalette())) {
+    return nullptr;
+  }
+  return getPalette();
+
 }
 
 }
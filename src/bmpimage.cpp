@@ -0,0 +1,1190 @@
+/**
+ *   libBMpp - bmpimage.cpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#include <bmpimage.hpp>
+#include <bmppyramid.hpp>
+#include <pixels/resampler.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifdef BMP_DEBUG
+#include <iostream>
+#include <string>
+#endif
+
+//Resize weights are fixed point numbers with 14 fractional bits; 8 bits rows are blended with 7 bits, so that blended samples fit in a signed 16 bits integer
+#define RESIZE_WEIGHT_BITS 14
+#define RESIZE_WEIGHT_ONE (1 << RESIZE_WEIGHT_BITS)
+#define RESIZE_BYTE_ROW_BITS 7
+#define RESIZE_BYTE_SHIFT (RESIZE_BYTE_ROW_BITS + RESIZE_WEIGHT_BITS)
+#define RESIZE_WORD_SHIFT (RESIZE_WEIGHT_BITS * 2)
+
+namespace bmp {
+
+/**
+ * @function divide
+ * @description returns dividend / divisor, multiplying by the inverse of divisor and correcting its rounding error
+ * @param uint64_t dividend
+ * @param uint64_t divisor
+ * @param double inverse of divisor
+ * @returns uint64_t
+**/
+
+static inline uint64_t divide(uint64_t dividend, uint64_t divisor, double inverse) {
+  uint64_t quotient = static_cast<uint64_t>(static_cast<double>(dividend) * inverse);
+  if (quotient * divisor > dividend) {
+    quotient--;
+  } else if ((quotient + 1) * divisor <= dividend) {
+    quotient++;
+  }
+  return quotient;
+}
+
+/**
+ * Column sums used by downscaling and blended rows used by resizing: 16 bits for 8 bits channels, 32 bits for 16 bits channels
+**/
+
+template <typename ChannelType>
+struct ColumnSum;
+
+template <>
+struct ColumnSum<uint8_t> {
+  typedef uint16_t Type;
+};
+
+template <>
+struct ColumnSum<uint16_t> {
+  typedef uint32_t Type;
+};
+
+/**
+ * @function accumulateRow
+ * @description add the samples of a row to the column sums (AVX2 or SSE2 when enabled at build time)
+ * @param const uint8_t* row
+ * @param uint16_t* sums
+ * @param size_t samples
+**/
+
+static void accumulateRow(const uint8_t* row, uint16_t* sums, size_t samples) {
+  size_t sample = 0;
+#if defined(__AVX2__)
+  for (; sample + 32 <= samples; sample += 32) {
+    __m256i low = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + sample)));
+    __m256i high = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + sample + 16)));
+    __m256i* lowSums = reinterpret_cast<__m256i*>(sums + sample);
+    __m256i* highSums = reinterpret_cast<__m256i*>(sums + sample + 16);
+    _mm256_storeu_si256(lowSums, _mm256_add_epi16(_mm256_loadu_si256(lowSums), low));
+    _mm256_storeu_si256(highSums, _mm256_add_epi16(_mm256_loadu_si256(highSums), high));
+  }
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; sample + 16 <= samples; sample += 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + sample));
+    __m128i* lowSums = reinterpret_cast<__m128i*>(sums + sample);
+    __m128i* highSums = reinterpret_cast<__m128i*>(sums + sample + 8);
+    _mm_storeu_si128(lowSums, _mm_add_epi16(_mm_loadu_si128(lowSums), _mm_unpacklo_epi8(bytes, zero)));
+    _mm_storeu_si128(highSums, _mm_add_epi16(_mm_loadu_si128(highSums), _mm_unpackhi_epi8(bytes, zero)));
+  }
+#endif
+  for (; sample < samples; sample++) {
+    sums[sample] += row[sample];
+  }
+}
+
+/**
+ * @function accumulateRow
+ * @description add the samples of a row to the column sums
+ * @param const uint16_t* row
+ * @param uint32_t* sums
+ * @param size_t samples
+**/
+
+static void accumulateRow(const uint16_t* row, uint32_t* sums, size_t samples) {
+  for (size_t sample = 0; sample < samples; sample++) {
+    sums[sample] += row[sample];
+  }
+}
+
+/**
+ * @function samplePosition
+ * @description map a row or a column of the resized image to the source one, aligning pixel centers; first is the first source sample
+ * and weight the fixed point weight of the next one (0 on the last sample, so edges are clamped)
+ * @param size_t position
+ * @param size_t resized size
+ * @param size_t source size
+ * @param size_t& first
+ * @param uint16_t& weight
+**/
+
+static inline void samplePosition(size_t position, size_t size, size_t prevSize, size_t& first, uint16_t& weight) {
+  double source = ((static_cast<double>(position) + 0.5) * prevSize) / size - 0.5;
+  first = 0;
+  weight = 0;
+  if (source <= 0) {
+    return;
+  }
+  first = static_cast<size_t>(source);
+  if (first >= prevSize - 1) {
+    first = prevSize - 1;
+    return;
+  }
+  weight = static_cast<uint16_t>(std::lround((source - first) * RESIZE_WEIGHT_ONE));
+}
+
+/**
+ * @function blendRows
+ * @description blend two rows of samples: blended = first * (1 - weight) + second * weight, with 7 bits weights (AVX2 or SSE2 when enabled at build time)
+ * @param const uint8_t* first row
+ * @param const uint8_t* second row
+ * @param uint16_t weight of the second row
+ * @param uint16_t* blended
+ * @param size_t samples
+**/
+
+static void blendRows(const uint8_t* first, const uint8_t* second, uint16_t weight, uint16_t* blended, size_t samples) {
+  weight = static_cast<uint16_t>((weight + (1 << (RESIZE_WEIGHT_BITS - RESIZE_BYTE_ROW_BITS - 1))) >> (RESIZE_WEIGHT_BITS - RESIZE_BYTE_ROW_BITS));
+  uint16_t firstWeight = (1 << RESIZE_BYTE_ROW_BITS) - weight;
+  size_t sample = 0;
+#if defined(__AVX2__)
+  const __m256i firstWeights = _mm256_set1_epi16(static_cast<short>(firstWeight));
+  const __m256i secondWeights = _mm256_set1_epi16(static_cast<short>(weight));
+  for (; sample + 16 <= samples; sample += 16) {
+    __m256i firstSamples = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first + sample)));
+    __m256i secondSamples = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(second + sample)));
+    __m256i sums = _mm256_add_epi16(_mm256_mullo_epi16(firstSamples, firstWeights), _mm256_mullo_epi16(secondSamples, secondWeights));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(blended + sample), sums);
+  }
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i firstWeights = _mm_set1_epi16(static_cast<short>(firstWeight));
+  const __m128i secondWeights = _mm_set1_epi16(static_cast<short>(weight));
+  for (; sample + 16 <= samples; sample += 16) {
+    __m128i firstSamples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + sample));
+    __m128i secondSamples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second + sample));
+    __m128i lowSums = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(firstSamples, zero), firstWeights), _mm_mullo_epi16(_mm_unpacklo_epi8(secondSamples, zero), secondWeights));
+    __m128i highSums = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(firstSamples, zero), firstWeights), _mm_mullo_epi16(_mm_unpackhi_epi8(secondSamples, zero), secondWeights));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(blended + sample), lowSums);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(blended + sample + 8), highSums);
+  }
+#endif
+  for (; sample < samples; sample++) {
+    blended[sample] = static_cast<uint16_t>((first[sample] * firstWeight) + (second[sample] * weight));
+  }
+}
+
+/**
+ * @function blendRows
+ * @description blend two rows of samples: blended = first * (1 - weight) + second * weight
+ * @param const uint16_t* first row
+ * @param const uint16_t* second row
+ * @param uint16_t weight of the second row
+ * @param uint32_t* blended
+ * @param size_t samples
+**/
+
+static void blendRows(const uint16_t* first, const uint16_t* second, uint16_t weight, uint32_t* blended, size_t samples) {
+  uint32_t firstWeight = RESIZE_WEIGHT_ONE - weight;
+  for (size_t sample = 0; sample < samples; sample++) {
+    blended[sample] = (first[sample] * firstWeight) + (second[sample] * static_cast<uint32_t>(weight));
+  }
+}
+
+/**
+ * @function blendColumns
+ * @description blend the pixels of a blended row into a resized row: column n is the pixel at offsets[n] and the next one,
+ * weighted by the low and the high half of weights[n]. Pixels of 3 and 4 channels are blended with SSE2 when enabled at build time
+ * @param const uint16_t* blended row, with a pixel of padding
+ * @param const uint32_t* offsets
+ * @param const uint32_t* weights
+ * @param size_t channels
+ * @param uint8_t* resized row
+ * @param size_t width
+**/
+
+static void blendColumns(const uint16_t* blended, const uint32_t* offsets, const uint32_t* weights, size_t channels, uint8_t* resized, size_t width) {
+  size_t column = 0;
+#if defined(__SSE2__)
+  if (channels >= 3) {
+    const __m128i round = _mm_set1_epi32(1 << (RESIZE_BYTE_SHIFT - 1));
+    //4 bytes are stored for each pixel: with 3 bytes pixels, the last one is left to the scalar loop
+    size_t vectorWidth = (channels == 4 || width == 0) ? width : width - 1;
+    for (; column < vectorWidth; column++) {
+      const uint16_t* left = blended + offsets[column];
+      __m128i pairs = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(left)), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(left + channels)));
+      __m128i sums = _mm_madd_epi16(pairs, _mm_set1_epi32(static_cast<int>(weights[column])));
+      sums = _mm_srli_epi32(_mm_add_epi32(sums, round), RESIZE_BYTE_SHIFT);
+      sums = _mm_packs_epi32(sums, sums);
+      int pixel = _mm_cvtsi128_si32(_mm_packus_epi16(sums, sums));
+      memcpy(resized + (column * channels), &pixel, 4);
+    }
+  }
+#endif
+  for (; column < width; column++) {
+    const uint16_t* left = blended + offsets[column];
+    uint32_t leftWeight = weights[column] & 0xFFFF;
+    uint32_t rightWeight = weights[column] >> 16;
+    for (size_t channel = 0; channel < channels; channel++) {
+      resized[(column * channels) + channel] = static_cast<uint8_t>(((left[channel] * leftWeight) + (left[channel + channels] * rightWeight) + (1 << (RESIZE_BYTE_SHIFT - 1))) >> RESIZE_BYTE_SHIFT);
+    }
+  }
+}
+
+/**
+ * @function blendColumns
+ * @description blend the pixels of a blended row into a resized row: column n is the pixel at offsets[n] and the next one,
+ * weighted by the low and the high half of weights[n]
+ * @param const uint32_t* blended row, with a pixel of padding
+ * @param const uint32_t* offsets
+ * @param const uint32_t* weights
+ * @param size_t channels
+ * @param uint16_t* resized row
+ * @param size_t width
+**/
+
+static void blendColumns(const uint32_t* blended, const uint32_t* offsets, const uint32_t* weights, size_t channels, uint16_t* resized, size_t width) {
+  for (size_t column = 0; column < width; column++) {
+    const uint32_t* left = blended + offsets[column];
+    uint64_t leftWeight = weights[column] & 0xFFFF;
+    uint64_t rightWeight = weights[column] >> 16;
+    for (size_t channel = 0; channel < channels; channel++) {
+      resized[(column * channels) + channel] = static_cast<uint16_t>(((left[channel] * leftWeight) + (left[channel + channels] * rightWeight) + (1ULL << (RESIZE_WORD_SHIFT - 1))) >> RESIZE_WORD_SHIFT);
+    }
+  }
+}
+
+/**
+ * @function averageBlocks
+ * @description average the 2x2 blocks of two rows into a row of half width, rounding to nearest: column n averages the pixel at 2n
+ * and the one step samples after it (0 when the source row is one pixel wide)
+ * @param const ChannelType* first row
+ * @param const ChannelType* second row
+ * @param size_t channels
+ * @param size_t step
+ * @param ChannelType* averaged row
+ * @param size_t first column
+ * @param size_t width
+**/
+
+template <typename ChannelType>
+static inline void averageBlocks(const ChannelType* first, const ChannelType* second, size_t channels, size_t step, ChannelType* averaged, size_t column, size_t width) {
+  for (; column < width; column++) {
+    size_t left = column * 2 * channels;
+    for (size_t channel = left; channel < left + channels; channel++) {
+      uint32_t sum = static_cast<uint32_t>(first[channel]) + first[channel + step] + second[channel] + second[channel + step];
+      averaged[(column * channels) + channel - left] = static_cast<ChannelType>((sum + 2) >> 2);
+    }
+  }
+}
+
+/**
+ * @function averageBlocks
+ * @description average the 2x2 blocks of two rows of bytes into a row of half width; pixels of 1, 3 and 4 channels are averaged
+ * with SSE2 when enabled at build time
+ * @param const uint8_t* first row
+ * @param const uint8_t* second row
+ * @param size_t channels
+ * @param size_t source width
+ * @param uint8_t* averaged row
+ * @param size_t width
+**/
+
+static void averageBlocks(const uint8_t* first, const uint8_t* second, size_t channels, size_t prevWidth, uint8_t* averaged, size_t width) {
+  size_t column = 0;
+  size_t step = prevWidth > 1 ? channels : 0;
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i round = _mm_set1_epi16(2);
+  size_t samples = prevWidth * channels;
+  if (channels == 1 && step > 0) {
+    //16 samples are averaged into 8
+    const __m128i evenMask = _mm_set1_epi16(0x00FF);
+    for (; (column * 2) + 16 <= samples; column += 8) {
+      __m128i firstSamples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + (column * 2)));
+      __m128i secondSamples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second + (column * 2)));
+      __m128i sums = _mm_add_epi16(_mm_and_si128(firstSamples, evenMask), _mm_and_si128(secondSamples, evenMask));
+      sums = _mm_add_epi16(sums, _mm_add_epi16(_mm_srli_epi16(firstSamples, 8), _mm_srli_epi16(secondSamples, 8)));
+      sums = _mm_srli_epi16(_mm_add_epi16(sums, round), 2);
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(averaged + column), _mm_packus_epi16(sums, sums));
+    }
+  } else if (channels == 4 && step > 0) {
+    //4 pixels are averaged into 2
+    for (; (column * 8) + 16 <= samples; column += 2) {
+      __m128i firstSamples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + (column * 8)));
+      __m128i secondSamples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second + (column * 8)));
+      __m128i lowSums = _mm_add_epi16(_mm_unpacklo_epi8(firstSamples, zero), _mm_unpacklo_epi8(secondSamples, zero));
+      __m128i highSums = _mm_add_epi16(_mm_unpackhi_epi8(firstSamples, zero), _mm_unpackhi_epi8(secondSamples, zero));
+      lowSums = _mm_add_epi16(lowSums, _mm_srli_si128(lowSums, 8));
+      highSums = _mm_add_epi16(highSums, _mm_srli_si128(highSums, 8));
+      __m128i sums = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lowSums, highSums), round), 2);
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(averaged + (column * 4)), _mm_packus_epi16(sums, sums));
+    }
+  } else if (channels == 3 && step > 0) {
+    //4 pixels (12 of the 16 loaded bytes) are averaged into 2; 8 bytes are stored, so the last pixels are left to the scalar loop
+    const __m128i lowMask = _mm_set_epi16(0, 0, 0, 0, 0, -1, -1, -1);
+    for (; (column * 6) + 16 <= samples && (column * 3) + 8 <= width * 3; column += 2) {
+      __m128i firstSamples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + (column * 6)));
+      __m128i secondSamples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second + (column * 6)));
+      __m128i lowSums = _mm_add_epi16(_mm_unpacklo_epi8(firstSamples, zero), _mm_unpacklo_epi8(secondSamples, zero));
+      __m128i highSums = _mm_add_epi16(_mm_unpackhi_epi8(firstSamples, zero), _mm_unpackhi_epi8(secondSamples, zero));
+      //Samples 6 to 11 of the vertical sums
+      __m128i nextSums = _mm_or_si128(_mm_srli_si128(lowSums, 12), _mm_slli_si128(highSums, 4));
+      lowSums = _mm_add_epi16(lowSums, _mm_srli_si128(lowSums, 6));
+      nextSums = _mm_add_epi16(nextSums, _mm_srli_si128(nextSums, 6));
+      __m128i sums = _mm_or_si128(_mm_and_si128(lowSums, lowMask), _mm_slli_si128(nextSums, 6));
+      sums = _mm_srli_epi16(_mm_add_epi16(sums, round), 2);
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(averaged + (column * 3)), _mm_packus_epi16(sums, sums));
+    }
+  }
+#endif
+  averageBlocks(first, second, channels, step, averaged, column, width);
+}
+
+/**
+ * @function spreadChannels
+ * @description move the three 5 bits channels of a RGB555 word 10 bits apart, so that four of them can be summed at once
+ * @param uint16_t
+ * @returns uint32_t
+**/
+
+static inline uint32_t spreadChannels(uint16_t pixel) {
+  return (pixel & 0x001F) | ((pixel & 0x03E0) << 5) | (static_cast<uint32_t>(pixel & 0x7C00) << 10);
+}
+
+/**
+ * @function averageBlocks
+ * @description average the 2x2 blocks of two rows of RGB555 words into a row of half width; each channel is averaged apart,
+ * rounding to nearest (the unused top bit is cleared)
+ * @param const uint16_t* first row
+ * @param const uint16_t* second row
+ * @param size_t channels (1)
+ * @param size_t source width
+ * @param uint16_t* averaged row
+ * @param size_t width
+**/
+
+static void averageBlocks(const uint16_t* first, const uint16_t* second, size_t /* channels */, size_t prevWidth, uint16_t* averaged, size_t width) {
+  size_t step = prevWidth > 1 ? 1 : 0;
+  for (size_t column = 0; column < width; column++) {
+    size_t left = column * 2;
+    uint32_t sums = spreadChannels(first[left]) + spreadChannels(first[left + step]) + spreadChannels(second[left]) + spreadChannels(second[left + step]);
+    sums = ((sums + 0x00200802) >> 2) & 0x01F07C1F;
+    averaged[column] = static_cast<uint16_t>((sums & 0x001F) | ((sums >> 5) & 0x03E0) | ((sums >> 10) & 0x7C00));
+  }
+}
+
+/**
+ * @function sampleBlocks
+ * @description keep the first pixel of each 2x2 block of two rows in a row of half width; used when samples can't be averaged
+ * @param const ChannelType* first row
+ * @param size_t channels
+ * @param ChannelType* sampled row
+ * @param size_t width
+**/
+
+template <typename ChannelType>
+static void sampleBlocks(const ChannelType* first, size_t channels, ChannelType* sampled, size_t width) {
+  for (size_t column = 0; column < width; column++) {
+    memcpy(sampled + (column * channels), first + (column * 2 * channels), channels * sizeof(ChannelType));
+  }
+}
+
+/**
+ * @function BmpImage
+ * @description BmpImage class constructor
+**/
+
+template <typename Format>
+BmpImage<Format>::BmpImage() : Bmp() {
+
+}
+
+/**
+ * @function BmpImage
+ * @description BmpImage class constructor; creates an image filled with defaultPixel
+ * @param size_t width
+ * @param size_t height
+ * @param const PixelType& default pixel
+**/
+
+template <typename Format>
+BmpImage<Format>::BmpImage(size_t width, size_t height, const PixelType& defaultPixel) : Bmp(width, height) {
+  //Set bits per pixel
+  header->bitsPerPixel = Format::bitsPerPixel;
+  //FileSize must be set by child class
+  size_t rowSize = PixelBuffer::strideFor(width, header->bitsPerPixel);
+  size_t dataSize = rowSize * height;
+  header->fileSize = 54 + dataSize;
+  //DataSize must be set by child class
+  header->dataSize = dataSize;
+  //Create empty image
+  pixelBuffer.allocate(header->width, header->height, Format::storageBitsPerPixel);
+  pixelBuffer.fill(reinterpret_cast<const uint8_t*>(&defaultPixel));
+}
+
+/**
+ * @function BmpImage
+ * @description BmpImage class copy constructor
+ * @param const BmpImage& bmp
+ */
+
+template <typename Format>
+BmpImage<Format>::BmpImage(const BmpImage& bmp) : Bmp(bmp) {
+  //Pixels are copied by Bmp
+}
+
+/**
+ * @function BmpImage
+ * @description BmpImage class copy constructor
+ * @param BmpImage* bmp
+ */
+
+template <typename Format>
+BmpImage<Format>::BmpImage(BmpImage* bmp) : Bmp(bmp) {
+  //Pixels are copied by Bmp
+}
+
+/**
+ * @function operator=
+ * @description BmpImage class copy assignment
+ * @param const BmpImage& bmp
+ * @returns BmpImage&
+**/
+
+template <typename Format>
+BmpImage<Format>& BmpImage<Format>::operator=(const BmpImage& bmp) {
+  Bmp::operator=(bmp);
+  return *this;
+}
+
+/**
+ * @function ~BmpImage
+ * @description BmpImage class destructor
+**/
+
+template <typename Format>
+BmpImage<Format>::~BmpImage() {
+
+}
+
+/**
+ * @function decodeBmp
+ * @description decode Bmp data buffer converting it to header struct and pixel buffer
+ * @param uint8_t*
+ * @param size_t
+ * @returns bool
+**/
+
+template <typename Format>
+bool BmpImage<Format>::decodeBmp(uint8_t* bmpData, size_t dataSize) {
+
+  //Call superclass decodeBmp to decode header
+  if (!Bmp::decodeBmp(bmpData, dataSize)) {
+    return false;
+  }
+  if (header->bitsPerPixel != Format::bitsPerPixel) {
+    return false;
+  }
+  //Get data
+  size_t rowSize = PixelBuffer::strideFor(header->width, header->bitsPerPixel);
+  size_t realRowSize = (static_cast<size_t>(header->width) * header->bitsPerPixel + 7) / 8;
+  //Check that the whole raster is in the buffer
+  if (!hasRaster(dataSize)) {
+    return false;
+  }
+  //Every byte is written below, no need to clear the raster
+  if (!pixelBuffer.allocate(header->width, header->height, Format::storageBitsPerPixel, false)) {
+    return false;
+  }
+  const uint8_t* raster = bmpData + header->dataOffset;
+  size_t width = header->width;
+  size_t lastRow = header->height - 1;
+  bool topDown = header->topDown;
+  forEachBand(header->height, rowSize, [this, raster, width, rowSize, realRowSize, lastRow, topDown](size_t firstRow, size_t endRow) {
+    for (size_t row = firstRow; row < endRow; row++) {
+      uint8_t* dstRow = pixelBuffer.getRow(row);
+      //Top-down rows are read in reverse order, no need to flip the image later
+      size_t fileRow = topDown ? lastRow - row : row;
+      Format::decodeRow(raster + (fileRow * rowSize), dstRow, width);
+      //Padding is handled once per row
+      memset(dstRow + realRowSize, 0, rowSize - realRowSize);
+    }
+  });
+  return true;
+}
+
+/**
+ * @function decodeRegion
+ * @description decode only an area of Bmp data buffer; just the rows and the columns of the area are read
+ * @param uint8_t*
+ * @param size_t
+ * @param size_t xOffset (from the left)
+ * @param size_t yOffset (from the top)
+ * @param size_t width
+ * @param size_t height
+ * @returns bool
+**/
+
+template <typename Format>
+bool BmpImage<Format>::decodeRegion(uint8_t* bmpData, size_t dataSize, size_t xOffset, size_t yOffset, size_t width, size_t height) {
+
+  //Call superclass decodeRegion to decode header and check the area
+  if (!Bmp::decodeRegion(bmpData, dataSize, xOffset, yOffset, width, height)) {
+    return false;
+  }
+  if (header->bitsPerPixel != Format::bitsPerPixel) {
+    return false;
+  }
+  //Row offsets are computed from the header
+  size_t rowSize = PixelBuffer::strideFor(header->width, header->bitsPerPixel);
+  if (!hasRaster(dataSize)) {
+    return false;
+  }
+  if (!pixelBuffer.allocate(width, height, Format::storageBitsPerPixel, false)) {
+    return false;
+  }
+  size_t areaRowSize = PixelBuffer::strideFor(width, header->bitsPerPixel);
+  size_t areaRealRowSize = ((width * header->bitsPerPixel) + 7) / 8;
+  const uint8_t* raster = bmpData + header->dataOffset + (xOffset * (Format::bitsPerPixel / 8));
+  size_t lastRow = height - 1;
+  //First and last file rows of the area; offsets are from the top left corner
+  size_t topRow = header->topDown ? yOffset : header->height - 1 - yOffset;
+  bool topDown = header->topDown;
+  forEachBand(height, areaRowSize, [this, raster, width, rowSize, areaRowSize, areaRealRowSize, lastRow, topRow, topDown](size_t firstRow, size_t endRow) {
+    for (size_t row = firstRow; row < endRow; row++) {
+      uint8_t* dstRow = pixelBuffer.getRow(row);
+      size_t areaRow = lastRow - row;
+      size_t fileRow = topDown ? topRow + areaRow : topRow - areaRow;
+      Format::decodeRow(raster + (fileRow * rowSize), dstRow, width);
+      memset(dstRow + areaRealRowSize, 0, areaRowSize - areaRealRowSize);
+    }
+  });
+  header->width = width;
+  header->height = height;
+  return true;
+}
+
+/**
+ * @function decodeDownscaled
+ * @description decode Bmp data buffer downscaling it to width x height; rows are averaged while they are read from the buffer
+ * @param uint8_t*
+ * @param size_t
+ * @param size_t width
+ * @param size_t height
+ * @returns bool
+**/
+
+template <typename Format>
+bool BmpImage<Format>::decodeDownscaled(uint8_t* bmpData, size_t dataSize, size_t width, size_t height) {
+
+  //Call superclass decodeDownscaled to decode header and check the size
+  if (!Bmp::decodeDownscaled(bmpData, dataSize, width, height)) {
+    return false;
+  }
+  if (header->bitsPerPixel != Format::bitsPerPixel) {
+    return false;
+  }
+  //Nothing to average
+  if (width == header->width && height == header->height) {
+    return BmpImage<Format>::decodeBmp(bmpData, dataSize);
+  }
+  size_t rowSize = PixelBuffer::strideFor(header->width, header->bitsPerPixel);
+  if (!hasRaster(dataSize)) {
+    return false;
+  }
+  return downscaleRaster(bmpData + header->dataOffset, rowSize, header->topDown, width, height);
+}
+
+/**
+ * @function downscaleBuffer
+ * @description downscale the decoded image to width x height (see downscaleRaster)
+ * @param size_t width
+ * @param size_t height
+ * @param bool average
+ * @returns bool
+**/
+
+template <typename Format>
+bool BmpImage<Format>::downscaleBuffer(size_t width, size_t height, bool average /* = true */) {
+
+  if (width == 0 || height == 0 || width > header->width || height > header->height) {
+    return false;
+  }
+  //PixelBuffer rows are bottom-up raster rows
+  PixelBuffer srcBuffer;
+  pixelBuffer.swap(srcBuffer);
+  return downscaleRaster(srcBuffer.getRow(0), srcBuffer.getStride(), false, width, height, average);
+}
+
+/**
+ * @function downscaleRaster
+ * @description replace the pixel buffer with the raster (whose size is in the header) downscaled to width x height.
+ * Each pixel is the average of a box of pixels (or the pixel in its center if average is false); only one raster row at a time is decoded
+ * @param const uint8_t* raster
+ * @param size_t raster row size
+ * @param bool topDown: whether the raster rows are top-down
+ * @param size_t width
+ * @param size_t height
+ * @param bool average
+ * @returns bool
+**/
+
+template <typename Format>
+bool BmpImage<Format>::downscaleRaster(const uint8_t* raster, size_t rowSize, bool topDown, size_t width, size_t height, bool average /* = true */) {
+
+  const size_t channels = Format::channels;
+  size_t srcWidth = header->width;
+  size_t srcHeight = header->height;
+  if (!pixelBuffer.allocate(width, height, Format::storageBitsPerPixel, false)) {
+    return false;
+  }
+  //Column n is the box of source columns [columns[n], columns[n + 1])
+  std::vector<size_t> columns(width + 1);
+  for (size_t column = 0; column <= width; column++) {
+    columns[column] = (column * srcWidth) / width;
+  }
+  //Sums are divided by the box area multiplying by its inverse
+  std::vector<double> inverses(width);
+  for (size_t column = 0; column < width; column++) {
+    inverses[column] = 1.0 / static_cast<double>(columns[column + 1] - columns[column]);
+  }
+  size_t stride = pixelBuffer.getStride();
+  size_t realRowSize = width * sizeof(PixelType);
+  forEachBand(height, rowSize * (srcHeight / height), [this, raster, rowSize, topDown, width, height, srcWidth, srcHeight, &columns, &inverses, stride, realRowSize, average](size_t firstRow, size_t endRow) {
+    size_t samples = srcWidth * channels;
+    typedef typename ColumnSum<ChannelType>::Type SumType;
+    size_t maxChunkRows = std::numeric_limits<SumType>::max() / std::numeric_limits<ChannelType>::max();
+    std::vector<ChannelType> srcRow(samples);
+    std::vector<SumType> columnSums(samples);
+    std::vector<uint64_t> sums(width * channels);
+    uint8_t* srcRowData = reinterpret_cast<uint8_t*>(srcRow.data());
+    for (size_t row = firstRow; row < endRow; row++) {
+      //Row is the box of source rows [firstSrcRow, endSrcRow)
+      size_t firstSrcRow = (row * srcHeight) / height;
+      size_t endSrcRow = ((row + 1) * srcHeight) / height;
+      uint8_t* dstRow = pixelBuffer.getRow(row);
+      ChannelType* dstPixel = reinterpret_cast<ChannelType*>(dstRow);
+      if (!average) {
+        size_t srcRowIndex = (firstSrcRow + endSrcRow - 1) / 2;
+        Format::decodeRow(raster + ((topDown ? srcHeight - 1 - srcRowIndex : srcRowIndex) * rowSize), srcRowData, srcWidth);
+        for (size_t column = 0; column < width; column++, dstPixel += channels) {
+          const ChannelType* srcPixel = srcRow.data() + (((columns[column] + columns[column + 1] - 1) / 2) * channels);
+          for (size_t channel = 0; channel < channels; channel++) {
+            dstPixel[channel] = srcPixel[channel];
+          }
+        }
+      } else {
+        std::fill(sums.begin(), sums.end(), 0);
+        size_t srcRowIndex = firstSrcRow;
+        while (srcRowIndex < endSrcRow) {
+          //Rows are summed by column first (as many rows as column sums can hold), then columns are summed by box
+          size_t chunkEnd = (endSrcRow - srcRowIndex > maxChunkRows) ? srcRowIndex + maxChunkRows : endSrcRow;
+          std::fill(columnSums.begin(), columnSums.end(), 0);
+          for (; srcRowIndex < chunkEnd; srcRowIndex++) {
+            Format::decodeRow(raster + ((topDown ? srcHeight - 1 - srcRowIndex : srcRowIndex) * rowSize), srcRowData, srcWidth);
+            accumulateRow(srcRow.data(), columnSums.data(), samples);
+          }
+          const SumType* columnSum = columnSums.data();
+          uint64_t* sum = sums.data();
+          for (size_t column = 0; column < width; column++, sum += channels) {
+            uint64_t boxSum[channels] = {};
+            for (size_t srcColumn = columns[column]; srcColumn < columns[column + 1]; srcColumn++, columnSum += channels) {
+              for (size_t channel = 0; channel < channels; channel++) {
+                boxSum[channel] += columnSum[channel];
+              }
+            }
+            for (size_t channel = 0; channel < channels; channel++) {
+              sum[channel] += boxSum[channel];
+            }
+          }
+        }
+        const uint64_t* sum = sums.data();
+        size_t boxHeight = endSrcRow - firstSrcRow;
+        double rowInverse = 1.0 / static_cast<double>(boxHeight);
+        for (size_t column = 0; column < width; column++, dstPixel += channels, sum += channels) {
+          uint64_t area = boxHeight * (columns[column + 1] - columns[column]);
+          double inverse = rowInverse * inverses[column];
+          for (size_t channel = 0; channel < channels; channel++) {
+            dstPixel[channel] = static_cast<ChannelType>(divide(sum[channel] + (area / 2), area, inverse));
+          }
+        }
+      }
+      memset(dstRow + realRowSize, 0, stride - realRowSize);
+    }
+  });
+  header->width = width;
+  header->height = height;
+  return true;
+}
+
+/**
+ * @function encodeBmp
+ * @description: encodes bitmap to buffer
+ * @param size_t*
+ * @returns uint8_t*
+**/
+
+template <typename Format>
+uint8_t* BmpImage<Format>::encodeBmp(size_t& dataSize) {
+
+  //Get our fundamental parameters
+  size_t rowSize = PixelBuffer::strideFor(header->width, header->bitsPerPixel);
+  size_t realRowSize = (static_cast<size_t>(header->width) * header->bitsPerPixel + 7) / 8;
+  //Fill header and get bmpData with fixed size
+  uint8_t* bmpData = Bmp::encodeBmp(dataSize);
+  //Return nullptr if needed
+  if (bmpData == nullptr) {
+    return nullptr;
+  }
+  //Fill data
+  uint8_t* raster = bmpData + header->dataOffset;
+  size_t width = header->width;
+  size_t lastRow = header->height - 1;
+  bool topDown = header->topDown;
+  forEachBand(header->height, rowSize, [this, raster, width, rowSize, realRowSize, lastRow, topDown](size_t firstRow, size_t endRow) {
+    for (size_t row = firstRow; row < endRow; row++) {
+      uint8_t* dstRow = raster + ((topDown ? lastRow - row : row) * rowSize);
+      Format::encodeRow(pixelBuffer.getRow(row), dstRow, width);
+      //Fill row with padding
+      memset(dstRow + realRowSize, 0, rowSize - realRowSize);
+    }
+  });
+  return bmpData;
+}
+
+/**
+ * @function resizeCanvas
+ * @description resize the canvas to width x height; new pixel (x, y) from the top left corner is pixel (x + xOffset, y + yOffset) of the current image.
+ * Offsets can be negative and the area can exceed the image on any side: pixels outside of the image are set to white
+ * @param size_t width
+ * @param size_t height
+ * @param long long xOffset
+ * @param long long yOffset
+ * @returns bool
+**/
+
+template <typename Format>
+bool BmpImage<Format>::resizeCanvas(size_t width, size_t height, long long xOffset, long long yOffset) {
+  return resizeCanvas(width, height, xOffset, yOffset, Format::white());
+}
+
+/**
+ * @function resizeCanvas
+ * @description resize the canvas to width x height like resizeCanvas(width, height, xOffset, yOffset); pixels outside of the image are set to fillPixel
+ * @param size_t width
+ * @param size_t height
+ * @param long long xOffset
+ * @param long long yOffset
+ * @param const PixelType& fillPixel
+ * @returns bool
+**/
+
+template <typename Format>
+bool BmpImage<Format>::resizeCanvas(size_t width, size_t height, long long xOffset, long long yOffset, const PixelType& fillPixel) {
+  return copyArea(width, height, xOffset, yOffset, reinterpret_cast<const uint8_t*>(&fillPixel));
+}
+
+/**
+ * @function resizeImage
+ * @description resize image (not only area) applying bilinear image scaling. Source positions and weights are computed once per column
+ * and per row; each resized row blends two source rows, then their columns, with fixed point weights. Rows are split among threads
+ * @param size_t
+ * @param size_t
+ * @returns bool
+**/
+
+template <typename Format>
+bool BmpImage<Format>::resizeImage(size_t width, size_t height) {
+  typedef typename ColumnSum<ChannelType>::Type BlendType;
+  if (header == nullptr) {
+    return false;
+  }
+  size_t prevWidth = header->width;
+  size_t prevHeight = header->height;
+  const size_t channels = Format::channels;
+  //There is nothing to sample
+  if (width > 0 && height > 0 && (prevWidth == 0 || prevHeight == 0)) {
+    return false;
+  }
+  PixelBuffer resizedBuffer;
+  if (!resizedBuffer.allocate(width, height, pixelBuffer.getBitsPerPixel(), false)) {
+    return false;
+  }
+  //Offsets of the first source pixel of each column, with the weights of the two pixels (first in the low half)
+  std::vector<uint32_t> offsets(width);
+  std::vector<uint32_t> weights(width);
+  for (size_t column = 0; column < width; column++) {
+    size_t first;
+    uint16_t weight;
+    samplePosition(column, width, prevWidth, first, weight);
+    offsets[column] = static_cast<uint32_t>(first * channels);
+    weights[column] = (static_cast<uint32_t>(weight) << 16) | (RESIZE_WEIGHT_ONE - weight);
+  }
+  size_t stride = resizedBuffer.getStride();
+  size_t rowSize = resizedBuffer.getRowSize();
+  //Rows are stored bottom to top, but pixel centers are aligned the same way from both sides
+  forEachBand(height, stride, [&, this](size_t firstRow, size_t lastRow) {
+    //The last column reads the pixel after the last one with weight 0
+    std::vector<BlendType> blended((prevWidth + 2) * channels, 0);
+    for (size_t row = firstRow; row < lastRow; row++) {
+      size_t first;
+      uint16_t weight;
+      samplePosition(row, height, prevHeight, first, weight);
+      const ChannelType* firstSamples = reinterpret_cast<const ChannelType*>(pixelBuffer.getRow(first));
+      const ChannelType* secondSamples = reinterpret_cast<const ChannelType*>(pixelBuffer.getRow(weight > 0 ? first + 1 : first));
+      blendRows(firstSamples, secondSamples, weight, blended.data(), prevWidth * channels);
+      uint8_t* dstRow = resizedBuffer.getRow(row);
+      blendColumns(blended.data(), offsets.data(), weights.data(), channels, reinterpret_cast<ChannelType*>(dstRow), width);
+      memset(dstRow + rowSize, 0, stride - rowSize);
+    }
+  });
+  pixelBuffer.swap(resizedBuffer);
+  //Change header parameters
+  return Bmp::resizeImage(width, height);
+}
+
+/**
+ * @function resizeImage
+ * @description resize image (not only area) resampling it with the provided filter (box, bilinear, bicubic or Lanczos 3).
+ * The filter is stretched when downscaling, so that every source pixel contributes (see resampleBuffers)
+ * @param size_t
+ * @param size_t
+ * @param Filter
+ * @returns bool
+**/
+
+template <typename Format>
+bool BmpImage<Format>::resizeImage(size_t width, size_t height, Filter filter) {
+  if (header == nullptr) {
+    return false;
+  }
+  PixelBuffer resizedBuffer;
+  if (!resampleBuffers(pixelBuffer, Format::channels, std::vector<ImageSize>(1, ImageSize{width, height}), std::vector<PixelBuffer*>(1, &resizedBuffer), filter)) {
+    return false;
+  }
+  pixelBuffer.swap(resizedBuffer);
+  //Change header parameters
+  return Bmp::resizeImage(width, height);
+}
+
+/**
+ * @function resizeNearest
+ * @description resize image keeping, for each resized pixel, the source pixel under its center; used when samples can't be blended
+ * (e.g. palette indexes). Rows are split among threads
+ * @param size_t
+ * @param size_t
+ * @returns bool
+**/
+
+template <typename Format>
+bool BmpImage<Format>::resizeNearest(size_t width, size_t height) {
+  if (header == nullptr) {
+    return false;
+  }
+  size_t prevWidth = header->width;
+  size_t prevHeight = header->height;
+  //There is nothing to sample
+  if (width > 0 && height > 0 && (prevWidth == 0 || prevHeight == 0)) {
+    return false;
+  }
+  PixelBuffer resizedBuffer;
+  if (!resizedBuffer.allocate(width, height, pixelBuffer.getBitsPerPixel(), false)) {
+    return false;
+  }
+  const size_t pixelSize = sizeof(ChannelType) * Format::channels;
+  std::vector<size_t> offsets(width);
+  for (size_t column = 0; column < width; column++) {
+    offsets[column] = (((column * 2) + 1) * prevWidth / (width * 2)) * pixelSize;
+  }
+  size_t stride = resizedBuffer.getStride();
+  size_t rowSize = width * pixelSize;
+  forEachBand(height, stride, [&, this](size_t firstRow, size_t lastRow) {
+    for (size_t row = firstRow; row < lastRow; row++) {
+      const uint8_t* srcRow = pixelBuffer.getRow(((row * 2) + 1) * prevHeight / (height * 2));
+      uint8_t* dstRow = resizedBuffer.getRow(row);
+      for (size_t column = 0; column < width; column++) {
+        memcpy(dstRow + (column * pixelSize), srcRow + offsets[column], pixelSize);
+      }
+      memset(dstRow + rowSize, 0, stride - rowSize);
+    }
+  });
+  pixelBuffer.swap(resizedBuffer);
+  return Bmp::resizeImage(width, height);
+}
+
+/**
+ * @function resampleBuffers
+ * @description resample source (the image, or its channels unpacked into ChannelType samples) to every provided size, into buffers.
+ * Kernel weights are computed once per column and per row of each size.
+ * Each band of source rows is read once, in order: every row is resampled horizontally into the small ring of rows of each size which needs it,
+ * while it's in cache, and the resized rows are resampled vertically as soon as their source rows are in the ring
+ * @param PixelBuffer& source, with the size of the image
+ * @param size_t channels of source
+ * @param const std::vector<ImageSize>& sizes
+ * @param const std::vector<PixelBuffer*>& buffers
+ * @param Filter
+ * @returns bool
+**/
+
+template <typename Format>
+bool BmpImage<Format>::resampleBuffers(PixelBuffer& source, size_t channels, const std::vector<ImageSize>& sizes, const std::vector<PixelBuffer*>& buffers, Filter filter) {
+  size_t prevWidth = header->width;
+  size_t prevHeight = header->height;
+  std::vector<ResampleKernel> columns;
+  std::vector<ResampleKernel> rows;
+  columns.reserve(sizes.size());
+  rows.reserve(sizes.size());
+  for (size_t output = 0; output < sizes.size(); output++) {
+    //There is nothing to sample
+    if (sizes[output].width > 0 && sizes[output].height > 0 && (prevWidth == 0 || prevHeight == 0)) {
+      return false;
+    }
+    columns.emplace_back(prevWidth, sizes[output].width, filter);
+    rows.emplace_back(prevHeight, sizes[output].height, filter);
+    if (!buffers[output]->allocate(sizes[output].width, sizes[output].height, source.getBitsPerPixel(), false)) {
+      return false;
+    }
+  }
+  //Rows are stored bottom to top, but kernels are symmetric
+  forEachBand(prevHeight, source.getStride(), [&, this](size_t firstSrcRow, size_t lastSrcRow) {
+    //The band resizes the rows whose first source row is in the band
+    std::vector<RowResampler<ChannelType>> resamplers;
+    std::vector<size_t> nextRows;
+    std::vector<size_t> lastRows;
+    resamplers.reserve(sizes.size());
+    size_t endSrcRow = firstSrcRow;
+    for (size_t output = 0; output < sizes.size(); output++) {
+      resamplers.emplace_back(columns[output], rows[output], channels);
+      //Rows of an empty width have nothing to resample
+      size_t row = sizes[output].width > 0 ? 0 : sizes[output].height;
+      while (row < sizes[output].height && rows[output].getFirst(row) < firstSrcRow) {
+        row++;
+      }
+      size_t lastRow = row;
+      while (lastRow < sizes[output].height && rows[output].getFirst(lastRow) < lastSrcRow) {
+        lastRow++;
+      }
+      nextRows.push_back(row);
+      lastRows.push_back(lastRow);
+      if (lastRow > row) {
+        endSrcRow = std::max(endSrcRow, rows[output].getFirst(lastRow - 1) + rows[output].getCount(lastRow - 1));
+      }
+    }
+    for (size_t srcRow = firstSrcRow; srcRow < endSrcRow; srcRow++) {
+      const ChannelType* samples = reinterpret_cast<const ChannelType*>(source.getRow(srcRow));
+      for (size_t output = 0; output < sizes.size(); output++) {
+        const ResampleKernel& kernel = rows[output];
+        size_t row = nextRows[output];
+        if (row == lastRows[output] || srcRow < kernel.getFirst(row)) {
+          continue;
+        }
+        resamplers[output].pushRow(srcRow, samples);
+        PixelBuffer* resizedBuffer = buffers[output];
+        for (; row < lastRows[output] && kernel.getFirst(row) + kernel.getCount(row) <= srcRow + 1; row++) {
+          uint8_t* dstRow = resizedBuffer->getRow(row);
+          resamplers[output].resampleRow(row, reinterpret_cast<ChannelType*>(dstRow));
+          memset(dstRow + resizedBuffer->getRowSize(), 0, resizedBuffer->getStride() - resizedBuffer->getRowSize());
+        }
+        nextRows[output] = row;
+      }
+    }
+  });
+  return true;
+}
+
+/**
+ * @function resizeInto
+ * @description resize the image to every provided size at once (see resampleBuffers); resized images get the header of this one
+ * @param const std::vector<ImageSize>& sizes
+ * @param const std::vector<BmpImage*>& resized images, one per size
+ * @param Filter
+ * @returns bool
+**/
+
+template <typename Format>
+bool BmpImage<Format>::resizeInto(const std::vector<ImageSize>& sizes, const std::vector<BmpImage*>& resized, Filter filter) {
+  if (header == nullptr || resized.size() != sizes.size()) {
+    return false;
+  }
+  std::vector<PixelBuffer*> buffers;
+  for (BmpImage* image : resized) {
+    buffers.push_back(&image->pixelBuffer);
+  }
+  if (!resampleBuffers(pixelBuffer, Format::channels, sizes, buffers, filter)) {
+    return false;
+  }
+  size_t dibDataSize = header->dataOffset - 54;
+  for (size_t output = 0; output < sizes.size(); output++) {
+    BmpImage* image = resized[output];
+    if (image->header == nullptr) {
+      image->header = new Header();
+    }
+    *image->header = *header;
+    delete[] image->dibData;
+    image->dibData = new uint8_t[dibDataSize];
+    if (dibData != nullptr) {
+      memcpy(image->dibData, dibData, dibDataSize);
+    }
+    image->threads = threads;
+    image->Bmp::resizeImage(sizes[output].width, sizes[output].height);
+  }
+  return true;
+}
+
+/**
+ * @function buildPyramid
+ * @description build up to levels levels of an image pyramid, stopping at 1x1: level 0 is the image,
+ * every next level averages the 2x2 blocks of the previous one in a single pass (see buildLevels)
+ * @param size_t levels
+ * @param BmpPyramid& pyramid
+ * @returns bool
+**/
+
+template <typename Format>
+bool BmpImage<Format>::buildPyramid(size_t levels, BmpPyramid& pyramid) {
+  return buildLevels(levels, pyramid, true);
+}
+
+/**
+ * @function buildLevels
+ * @description build up to levels levels of an image pyramid, stopping at 1x1: level 0 is the image, every next level averages
+ * the 2x2 blocks of the previous one (or keeps the first pixel of each block if average is false) in a single pass.
+ * All the levels are stored in one allocation
+ * @param size_t levels
+ * @param BmpPyramid& pyramid
+ * @param bool average
+ * @returns bool
+**/
+
+template <typename Format>
+bool BmpImage<Format>::buildLevels(size_t levels, BmpPyramid& pyramid, bool average) {
+  if (header == nullptr || levels == 0 || header->width == 0 || header->height == 0) {
+    return false;
+  }
+  //Every level halves the previous one (odd rows and columns are dropped)
+  std::vector<size_t> widths(1, header->width);
+  std::vector<size_t> heights(1, header->height);
+  while (widths.size() < levels && (widths.back() > 1 || heights.back() > 1)) {
+    widths.push_back(std::max<size_t>(widths.back() / 2, 1));
+    heights.push_back(std::max<size_t>(heights.back() / 2, 1));
+  }
+  std::vector<size_t> levelSizes;
+  for (size_t level = 0; level < widths.size(); level++) {
+    levelSizes.push_back(header->dataOffset + (PixelBuffer::strideFor(widths[level], header->bitsPerPixel) * heights[level]));
+  }
+  uint8_t* levelData = pyramid.allocate(levelSizes);
+  const uint8_t* prevRaster = nullptr;
+  size_t prevStride = 0;
+  for (size_t level = 0; level < widths.size(); level++) {
+    size_t width = widths[level];
+    size_t height = heights[level];
+    size_t stride = PixelBuffer::strideFor(width, header->bitsPerPixel);
+    size_t rowSize = ((width * header->bitsPerPixel) + 7) / 8;
+    //Every level is encoded as a bottom to top bitmap
+    bmp::Header levelHeader = *header;
+    levelHeader.width = width;
+    levelHeader.height = height;
+    levelHeader.topDown = false;
+    levelHeader.dataSize = stride * height;
+    levelHeader.fileSize = levelSizes[level];
+    encodeHeader(levelHeader, levelData);
+    if (dibData != nullptr) {
+      memcpy(levelData + 54, dibData, (header->dataOffset - 54));
+    }
+    uint8_t* raster = levelData + header->dataOffset;
+    size_t prevWidth = level > 0 ? widths[level - 1] : 0;
+    size_t prevHeight = level > 0 ? heights[level - 1] : 0;
+    forEachBand(height, stride, [&, this](size_t firstRow, size_t lastRow) {
+      for (size_t row = firstRow; row < lastRow; row++) {
+        uint8_t* dstRow = raster + (row * stride);
+        if (level == 0) {
+          Format::encodeRow(pixelBuffer.getRow(row), dstRow, width);
+        } else {
+          //Rows are stored bottom to top: with an odd height, the bottom row of the previous level is dropped
+          const uint8_t* first = prevRaster + ((prevHeight > 1 ? prevHeight - (height * 2) + (row * 2) : 0) * prevStride);
+          const uint8_t* second = prevHeight > 1 ? first + prevStride : first;
+          if (average) {
+            averageBlocks(reinterpret_cast<const ChannelType*>(first), reinterpret_cast<const ChannelType*>(second), Format::channels, prevWidth, reinterpret_cast<ChannelType*>(dstRow), width);
+          } else {
+            sampleBlocks(reinterpret_cast<const ChannelType*>(first), Format::channels, reinterpret_cast<ChannelType*>(dstRow), width);
+          }
+        }
+        memset(dstRow + rowSize, 0, stride - rowSize);
+      }
+    });
+    prevRaster = raster;
+    prevStride = stride;
+    levelData += levelSizes[level];
+  }
+  return true;
+}
+
+/**
+ * @function getPixelAt
+ * @description return pointer to pixel in the provided position
+ * @param size_t
+ * @param size_t
+ * @returns PixelType*
+**/
+
+template <typename Format>
+typename BmpImage<Format>::PixelType* BmpImage<Format>::getPixelAt(size_t row, size_t column) {
+
+  //Get index, considering that pixels are stored bottom to top
+  size_t reversedRow = (header->height - 1 - row); // h - 1 - r
+  size_t index = (header->width * reversedRow) + column;
+  return getPixelAt(index);
+}
+
+/**
+ * @function getPixelAt
+ * @description return pointer to pixel in the provided position
+ * @param size_t
+ * @returns PixelType*
+**/
+
+template <typename Format>
+typename BmpImage<Format>::PixelType* BmpImage<Format>::getPixelAt(size_t index) {
+
+  if (index >= pixelBuffer.getPixelCount()) {
+    return nullptr;
+  }
+  return reinterpret_cast<PixelType*>(pixelBuffer.getPixel(index));
+}
+
+//Supported formats
+template class BmpImage<ByteFormat>;
+template class BmpImage<WordFormat>;
+template class BmpImage<RGBFormat>;
+template class BmpImage<RGBAFormat>;
+
+}
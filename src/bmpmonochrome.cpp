@@ -22,8 +22,11 @@
 **/
 
 #include <bmpmonochrome.hpp>
+#include <pixels/resampler.hpp>
 
-#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 #ifdef BMP_DEBUG
 #include <iostream>
@@ -32,13 +35,177 @@
 
 namespace bmp {
 
+/**
+ * Packed row kernels. A row is a string of bits, most significant bit first;
+ * they work on 64 bits at a time, loaded big endian so that bit order is kept
+**/
+
+/**
+ * @function loadWord
+ * @description returns the 64 bits of a packed row starting at the provided bit; bits out of the row are 0
+ * @param const uint8_t* row
+ * @param size_t row size in bytes
+ * @param long long first bit (may be negative)
+ * @returns uint64_t
+**/
+
+static uint64_t loadWord(const uint8_t* row, size_t rowSize, long long bit) {
+  if (bit <= -64 || bit >= static_cast<long long>(rowSize * 8)) {
+    return 0;
+  }
+  if (bit < 0) {
+    return loadWord(row, rowSize, 0) >> (-bit);
+  }
+  size_t byte = static_cast<size_t>(bit) / 8;
+  unsigned int shift = static_cast<unsigned int>(bit % 8);
+  uint64_t word = 0;
+  uint8_t next = 0;
+  if (byte + 9 <= rowSize) {
+    for (size_t i = 0; i < 8; i++) {
+      word = (word << 8) | row[byte + i];
+    }
+    next = row[byte + 8];
+  } else {
+    for (size_t i = 0; i < 8; i++) {
+      word = (word << 8) | ((byte + i < rowSize) ? row[byte + i] : 0);
+    }
+    next = (byte + 8 < rowSize) ? row[byte + 8] : 0;
+  }
+  if (shift > 0) {
+    word = (word << shift) | (next >> (8 - shift));
+  }
+  return word;
+}
+
+/**
+ * @function storeWord
+ * @description store the bits of word selected by mask at the provided byte of a packed row; bytes out of the row are skipped
+ * @param uint8_t* row
+ * @param size_t row size in bytes
+ * @param size_t first byte
+ * @param uint64_t word
+ * @param uint64_t mask
+**/
+
+static void storeWord(uint8_t* row, size_t rowSize, size_t byte, uint64_t word, uint64_t mask) {
+  if (mask == ~0ULL && byte + 8 <= rowSize) {
+    for (size_t i = 0; i < 8; i++) {
+      row[byte + i] = static_cast<uint8_t>(word >> (56 - (i * 8)));
+    }
+    return;
+  }
+  for (size_t i = 0; i < 8 && byte + i < rowSize; i++) {
+    uint8_t byteMask = static_cast<uint8_t>(mask >> (56 - (i * 8)));
+    uint8_t byteValue = static_cast<uint8_t>(word >> (56 - (i * 8)));
+    row[byte + i] = (row[byte + i] & ~byteMask) | (byteValue & byteMask);
+  }
+}
+
+/**
+ * @function rangeMask
+ * @description returns a mask with bits [begin, end) set, counting from the most significant bit
+ * @param size_t begin
+ * @param size_t end
+ * @returns uint64_t
+**/
+
+static inline uint64_t rangeMask(size_t begin, size_t end) {
+  size_t count = end - begin;
+  if (count >= 64) {
+    return ~0ULL;
+  }
+  return ((1ULL << count) - 1) << (64 - end);
+}
+
+/**
+ * @function copyBits
+ * @description copy bits [begin, end) of dst from src, where dst bit n is src bit n + shift
+ * @param const uint8_t* src row
+ * @param size_t src row size in bytes
+ * @param uint8_t* dst row
+ * @param size_t dst row size in bytes
+ * @param long long shift
+ * @param size_t begin
+ * @param size_t end
+**/
+
+static void copyBits(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize, long long shift, size_t begin, size_t end) {
+  for (size_t wordBit = begin - (begin % 64); wordBit < end; wordBit += 64) {
+    size_t maskBegin = (begin > wordBit) ? begin - wordBit : 0;
+    size_t maskEnd = (end < wordBit + 64) ? end - wordBit : 64;
+    uint64_t word = loadWord(src, srcSize, static_cast<long long>(wordBit) + shift);
+    storeWord(dst, dstSize, wordBit / 8, word, rangeMask(maskBegin, maskEnd));
+  }
+}
+
+/**
+ * @function spreadBits
+ * @description spread the bits of a byte to the bytes of a word: byte n of the word (from the least significant one) is pixel n of the byte
+ * @param uint8_t
+ * @returns uint64_t
+**/
+
+static inline uint64_t spreadBits(uint8_t bits) {
+  return ((bits * 0x8040201008040201ULL) & 0x8080808080808080ULL) >> 7;
+}
+
+/**
+ * @function reverseBits
+ * @description reverse the bit order of a 64 bits word
+ * @param uint64_t
+ * @returns uint64_t
+**/
+
+static inline uint64_t reverseBits(uint64_t word) {
+  word = ((word >> 1) & 0x5555555555555555ULL) | ((word & 0x5555555555555555ULL) << 1);
+  word = ((word >> 2) & 0x3333333333333333ULL) | ((word & 0x3333333333333333ULL) << 2);
+  word = ((word >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((word & 0x0F0F0F0F0F0F0F0FULL) << 4);
+  word = ((word >> 8) & 0x00FF00FF00FF00FFULL) | ((word & 0x00FF00FF00FF00FFULL) << 8);
+  word = ((word >> 16) & 0x0000FFFF0000FFFFULL) | ((word & 0x0000FFFF0000FFFFULL) << 16);
+  return (word >> 32) | (word << 32);
+}
+
+/**
+ * @function transpose8x8
+ * @description transpose an 8x8 bit matrix, whose rows are the bytes of the word (first row in the most significant byte)
+ * @param uint64_t
+ * @returns uint64_t
+**/
+
+static inline uint64_t transpose8x8(uint64_t word) {
+  uint64_t t;
+  t = (word ^ (word >> 7)) & 0x00AA00AA00AA00AAULL;
+  word = word ^ t ^ (t << 7);
+  t = (word ^ (word >> 14)) & 0x0000CCCC0000CCCCULL;
+  word = word ^ t ^ (t << 14);
+  t = (word ^ (word >> 28)) & 0x00000000F0F0F0F0ULL;
+  word = word ^ t ^ (t << 28);
+  return word;
+}
+
+/**
+ * @function clearPadding
+ * @description set to 0 the bits of a packed row after its last pixel
+ * @param uint8_t* row
+ * @param size_t width in pixels
+ * @param size_t stride in bytes
+**/
+
+static void clearPadding(uint8_t* row, size_t width, size_t stride) {
+  size_t rowSize = (width + 7) / 8;
+  if (width % 8 != 0) {
+    row[rowSize - 1] &= static_cast<uint8_t>(0xFF << (8 - (width % 8)));
+  }
+  memset(row + rowSize, 0, stride - rowSize);
+}
+
 /**
  * @function Bmpmonochrome
  * @description Bmpmonochrome class constructor
 **/
 
 Bmpmonochrome::Bmpmonochrome() : Bmp() {
-  pixelArray.clear();
+
 }
 
 /**
@@ -50,19 +217,14 @@ Bmpmonochrome::Bmpmonochrome(size_t width, size_t height, uint8_t defaultColor)
   //Set bits per pixel
   header->bitsPerPixel = 1;
   //FileSize must be set by child class
-  size_t nextMultipleOf4 = roundToMultiple(width, 4);
-  size_t paddingSize = nextMultipleOf4 - (header->width);
-  size_t rowSize = paddingSize + (width);
+  size_t rowSize = PixelBuffer::strideFor(width, header->bitsPerPixel);
   size_t dataSize = rowSize * height;
   header->fileSize = 54 + dataSize;
   //DataSize must be set by child class
   header->dataSize = dataSize;
   //Create empty image
-  size_t arraySize = header->width * header->height;
-  pixelArray.reserve(arraySize);
-  for (size_t i = 0; i < arraySize; i++) {
-    pixelArray.push_back(new BWPixel(defaultColor));
-  }
+  pixelBuffer.allocate(header->width, header->height, header->bitsPerPixel);
+  pixelBuffer.fill(&defaultColor);
 }
 
 /**
@@ -72,12 +234,7 @@ Bmpmonochrome::Bmpmonochrome(size_t width, size_t height, uint8_t defaultColor)
  */
 
 Bmpmonochrome::Bmpmonochrome(const Bmpmonochrome& bmp) : Bmp(bmp) {
-  //Copy pixel array to new bmp
-  size_t arraySize = bmp.pixelArray.size();
-  for (size_t i = 0; i < arraySize; i++) {
-    BWPixel* copyPixel = reinterpret_cast<BWPixel*>(bmp.pixelArray.at(i));
-    pixelArray.push_back(new BWPixel(copyPixel->getValue()));
-  }
+  //Pixels are copied by Bmp
 }
 
 /**
@@ -87,12 +244,19 @@ Bmpmonochrome::Bmpmonochrome(const Bmpmonochrome& bmp) : Bmp(bmp) {
  */
 
 Bmpmonochrome::Bmpmonochrome(Bmpmonochrome* bmp) : Bmp(bmp) {
-  //Copy pixel array to new bmp
-  size_t arraySize = bmp->pixelArray.size();
-  for (size_t i = 0; i < arraySize; i++) {
-    BWPixel* copyPixel = reinterpret_cast<BWPixel*>(bmp->pixelArray.at(i));
-    pixelArray.push_back(new BWPixel(copyPixel->getValue()));
-  }
+  //Pixels are copied by Bmp
+}
+
+/**
+ * @function operator=
+ * @description Bmpmonochrome class copy assignment
+ * @param const Bmpmonochrome& bmp
+ * @returns Bmpmonochrome&
+**/
+
+Bmpmonochrome& Bmpmonochrome::operator=(const Bmpmonochrome& bmp) {
+  Bmp::operator=(bmp);
+  return *this;
 }
 
 /**
@@ -101,18 +265,12 @@ Bmpmonochrome::Bmpmonochrome(Bmpmonochrome* bmp) : Bmp(bmp) {
 **/
 
 Bmpmonochrome::~Bmpmonochrome() {
-  //Delete pixels
-  for (auto& pixel : pixelArray) {
-    BWPixel* bwPixel = reinterpret_cast<BWPixel*>(pixel);
-    delete bwPixel;
-    pixel = nullptr;
-  }
-  pixelArray.clear();
+  
 }
 
 /**
  * @function decodeBmp
- * @description decode Bmp data buffer converting it to header struct and RGBPixel array
+ * @description decode Bmp data buffer converting it to header struct and packed pixel buffer
  * @param uint8_t*
  * @param size_t
  * @returns bool
@@ -124,29 +282,162 @@ bool Bmpmonochrome::decodeBmp(uint8_t* bmpData, size_t dataSize) {
   if (!Bmp::decodeBmp(bmpData, dataSize)) {
     return false;
   }
+  if (header->bitsPerPixel != 1) {
+    return false;
+  }
   //Get data
-  size_t totalArea = header->width * header->height;
-  size_t nextMultipleOf4 = roundToMultiple(header->width, 4);
-  size_t paddingSize = nextMultipleOf4 - (header->width);
-  size_t realRowSize = (header->width);
-  size_t rowPositionCounter = 0;
-  for (size_t dataPtr = header->dataOffset - 1; dataPtr < header->fileSize - 1; dataPtr++) {
-    uint8_t currentByte = bmpData[dataPtr];
-    for (size_t i = 0; pixelArray.size() <= totalArea && i < 8; i++) {
-      //Iterate over bits in byte to get color
-      uint8_t shiftValue = 8 - i;
-      uint8_t colorValue = (currentByte >> shiftValue) & 1;
-      pixelArray.push_back(new BWPixel(colorValue));
-    }
-    rowPositionCounter++;
-    //If row has been parsed, go to next line
-    if (rowPositionCounter >= realRowSize) {
-      rowPositionCounter = 0;
-      dataPtr += paddingSize;
+  size_t rowSize = PixelBuffer::strideFor(header->width, header->bitsPerPixel);
+  size_t realRowSize = (static_cast<size_t>(header->width) + 7) / 8;
+  //Check that the whole raster is in the buffer
+  if (!hasRaster(dataSize)) {
+    return false;
+  }
+  //Every byte is written below, no need to clear the raster
+  if (!pixelBuffer.allocate(header->width, header->height, header->bitsPerPixel, false)) {
+    return false;
+  }
+  //Rows are stored as in the file; only bits after the last pixel must be cleared
+  const uint8_t* raster = bmpData + header->dataOffset;
+  size_t width = header->width;
+  size_t lastRow = header->height - 1;
+  bool topDown = header->topDown;
+  forEachBand(header->height, rowSize, [this, raster, width, rowSize, realRowSize, lastRow, topDown](size_t firstRow, size_t endRow) {
+    for (size_t row = firstRow; row < endRow; row++) {
+      uint8_t* dstRow = pixelBuffer.getRow(row);
+      //Top-down rows are read in reverse order
+      size_t fileRow = topDown ? lastRow - row : row;
+      memcpy(dstRow, raster + (fileRow * rowSize), realRowSize);
+      clearPadding(dstRow, width, rowSize);
     }
+  });
+  return true;
+}
+
+/**
+ * @function decodeRegion
+ * @description decode only an area of Bmp data buffer; just the rows of the area are read and their bits are shifted by xOffset
+ * @param uint8_t*
+ * @param size_t
+ * @param size_t xOffset (from the left)
+ * @param size_t yOffset (from the top)
+ * @param size_t width
+ * @param size_t height
+ * @returns bool
+**/
+
+bool Bmpmonochrome::decodeRegion(uint8_t* bmpData, size_t dataSize, size_t xOffset, size_t yOffset, size_t width, size_t height) {
+
+  //Call superclass decodeRegion to decode header and check the area
+  if (!Bmp::decodeRegion(bmpData, dataSize, xOffset, yOffset, width, height)) {
+    return false;
+  }
+  if (header->bitsPerPixel != 1) {
+    return false;
+  }
+  //Row offsets are computed from the header
+  size_t rowSize = PixelBuffer::strideFor(header->width, header->bitsPerPixel);
+  size_t realRowSize = (static_cast<size_t>(header->width) + 7) / 8;
+  if (!hasRaster(dataSize)) {
+    return false;
+  }
+  //Bits after the area are left cleared
+  if (!pixelBuffer.allocate(width, height, 1)) {
+    return false;
   }
+  const uint8_t* raster = bmpData + header->dataOffset;
+  size_t areaRowSize = pixelBuffer.getRowSize();
+  size_t lastRow = height - 1;
+  //First file row of the area; offsets are from the top left corner
+  size_t topRow = header->topDown ? yOffset : header->height - 1 - yOffset;
+  bool topDown = header->topDown;
+  long long shift = static_cast<long long>(xOffset);
+  forEachBand(height, areaRowSize, [this, raster, width, rowSize, realRowSize, areaRowSize, lastRow, topRow, topDown, shift](size_t firstRow, size_t endRow) {
+    for (size_t row = firstRow; row < endRow; row++) {
+      size_t areaRow = lastRow - row;
+      size_t fileRow = topDown ? topRow + areaRow : topRow - areaRow;
+      copyBits(raster + (fileRow * rowSize), realRowSize, pixelBuffer.getRow(row), areaRowSize, shift, 0, width);
+    }
+  });
+  header->width = width;
+  header->height = height;
   return true;
+}
 
+/**
+ * @function decodeDownscaled
+ * @description decode Bmp data buffer downscaling it to width x height: each pixel is set if at least half of the pixels of its box are set.
+ * Bits are counted while the rows are read from the buffer
+ * @param uint8_t*
+ * @param size_t
+ * @param size_t width
+ * @param size_t height
+ * @returns bool
+**/
+
+bool Bmpmonochrome::decodeDownscaled(uint8_t* bmpData, size_t dataSize, size_t width, size_t height) {
+
+  //Call superclass decodeDownscaled to decode header and check the size
+  if (!Bmp::decodeDownscaled(bmpData, dataSize, width, height)) {
+    return false;
+  }
+  if (header->bitsPerPixel != 1) {
+    return false;
+  }
+  size_t rowSize = PixelBuffer::strideFor(header->width, header->bitsPerPixel);
+  if (!hasRaster(dataSize)) {
+    return false;
+  }
+  //Pixels are set one by one on a cleared raster
+  if (!pixelBuffer.allocate(width, height, 1)) {
+    return false;
+  }
+  size_t srcWidth = header->width;
+  size_t srcHeight = header->height;
+  //Column n is the box of source columns [columns[n], columns[n + 1])
+  std::vector<size_t> columns(width + 1);
+  for (size_t column = 0; column <= width; column++) {
+    columns[column] = (column * srcWidth) / width;
+  }
+  const uint8_t* raster = bmpData + header->dataOffset;
+  bool topDown = header->topDown;
+  forEachBand(height, rowSize * (srcHeight / height), [this, raster, rowSize, topDown, width, height, srcWidth, srcHeight, &columns](size_t firstRow, size_t endRow) {
+    size_t words = (srcWidth + 7) / 8;
+    std::vector<uint64_t> laneCounts(words);
+    std::vector<size_t> counts(width);
+    for (size_t row = firstRow; row < endRow; row++) {
+      //Row is the box of source rows [firstSrcRow, endSrcRow)
+      size_t firstSrcRow = (row * srcHeight) / height;
+      size_t endSrcRow = ((row + 1) * srcHeight) / height;
+      std::fill(counts.begin(), counts.end(), 0);
+      size_t srcRowIndex = firstSrcRow;
+      while (srcRowIndex < endSrcRow) {
+        //Bits are counted by column in 8 bits lanes (up to 255 rows), then columns are summed by box
+        size_t chunkEnd = (endSrcRow - srcRowIndex > 255) ? srcRowIndex + 255 : endSrcRow;
+        std::fill(laneCounts.begin(), laneCounts.end(), 0);
+        for (; srcRowIndex < chunkEnd; srcRowIndex++) {
+          const uint8_t* srcRow = raster + ((topDown ? srcHeight - 1 - srcRowIndex : srcRowIndex) * rowSize);
+          for (size_t word = 0; word < words; word++) {
+            laneCounts[word] += spreadBits(srcRow[word]);
+          }
+        }
+        for (size_t column = 0; column < width; column++) {
+          for (size_t srcColumn = columns[column]; srcColumn < columns[column + 1]; srcColumn++) {
+            counts[column] += (laneCounts[srcColumn / 8] >> ((srcColumn % 8) * 8)) & 0xFF;
+          }
+        }
+      }
+      uint8_t* dstRow = pixelBuffer.getRow(row);
+      for (size_t column = 0; column < width; column++) {
+        size_t area = (endSrcRow - firstSrcRow) * (columns[column + 1] - columns[column]);
+        if (counts[column] * 2 >= area) {
+          dstRow[column / 8] |= static_cast<uint8_t>(0x80 >> (column % 8));
+        }
+      }
+    }
+  });
+  header->width = width;
+  header->height = height;
+  return true;
 }
 
 /**
@@ -157,143 +448,122 @@ bool Bmpmonochrome::decodeBmp(uint8_t* bmpData, size_t dataSize) {
 **/
 
 uint8_t* Bmpmonochrome::encodeBmp(size_t& dataSize) {
-  size_t nextMultipleOf4 = roundToMultiple(header->width, 4);
-  size_t paddingSize = nextMultipleOf4 - header->width;
-  size_t realRowSize = (header->width);
+
   //Fill header and get bmpData with fixed size
   uint8_t* bmpData = Bmp::encodeBmp(dataSize);
   //Return nullptr if needed
   if (bmpData == nullptr) {
     return nullptr;
   }
-  size_t byteCounter = 0;
-  size_t rowPositionCounter = 0;
-  for (size_t dataPtr = header->dataOffset - 1; dataPtr < dataSize - 1;) {
-    //Get byte to write
-    uint8_t colorValue = 0;
-    for (size_t i = 0; i < 8; i++, byteCounter++) {
-      BWPixel* currPixel = reinterpret_cast<BWPixel*>(pixelArray.at(byteCounter));
-      if (currPixel == nullptr) {
-        break;
-      }
-      colorValue = colorValue << (8 - i);
-    }
-    bmpData[dataPtr] = colorValue;
-    //Check if row has to be closed
-    rowPositionCounter++;
-    if (rowPositionCounter >= realRowSize) {
-      //Fill row with padding and go on new line
-      rowPositionCounter = 0;
-      for (size_t i = 0; i < paddingSize; i++) {
-        bmpData[++dataPtr] = 0;
+  //Pixel buffer has the same layout of the raster (padding is always 0)
+  uint8_t* raster = bmpData + header->dataOffset;
+  size_t rowSize = pixelBuffer.getStride();
+  size_t lastRow = header->height - 1;
+  bool topDown = header->topDown;
+  forEachBand(header->height, rowSize, [this, raster, rowSize, lastRow, topDown](size_t firstRow, size_t endRow) {
+    if (topDown) {
+      //Rows are written in reverse order
+      for (size_t row = firstRow; row < endRow; row++) {
+        memcpy(raster + ((lastRow - row) * rowSize), pixelBuffer.getRow(row), rowSize);
       }
+    } else if (endRow > firstRow) {
+      memcpy(raster + (firstRow * rowSize), pixelBuffer.getRow(firstRow), (endRow - firstRow) * rowSize);
     }
-  }
+  });
   return bmpData;
 }
 
 /**
- * @function readBmp
- * @description read a BMP file and decodes it. The decoded Bmp becomes the object
- * @param const std::string& bmpFile
+ * @function rotate
+ * @description: rotates the image by a multiple of 90 (clockwise; negative degrees rotate counterclockwise); 90 and 270 degrees rotations transpose 8x8 pixels blocks
+ * @param int
  * @returns bool
- */
+**/
 
-bool Bmpmonochrome::readBmp(const std::string& bmpFile) {
-  std::ifstream iFile;
-  iFile.open(bmpFile, std::ios::binary | std::ios::ate);
-  if (!iFile.is_open()) {
+bool Bmpmonochrome::rotate(int degrees) {
+
+  if (degrees % 90 != 0) {
     return false;
   }
-  std::streamsize size = iFile.tellg();
-  iFile.seekg(0, std::ios::beg);
-  char* dataBuffer = new char[size];
-  if (!iFile.read(dataBuffer, size)) {
-    delete[] dataBuffer;
+
+  if (header == nullptr) {
     return false;
   }
-  iFile.close();
-  //Decode
-  bool rc = decodeBmp(reinterpret_cast<uint8_t*>(dataBuffer), size);
-  delete[] dataBuffer;
-  return rc;
-}
 
-/**
- * @function writeBmp
- * @description encode BMP write the buffer to a file.
- * @param const std::string& bmpFile
- * @returns bool
- */
-
-bool Bmpmonochrome::writeBmp(const std::string& bmpFile) {
-  size_t outDataSize;
-  uint8_t* outBuf = encodeBmp(outDataSize);
-  if (outBuf == nullptr) {
-    return false;
+  degrees = ((degrees % 360) + 360) % 360;
+  if (degrees == 180) {
+    return flip(FlipType::VERTICAL) && flip(FlipType::HORIZONTAL);
   }
-  //Write file
-  std::ofstream outFile;
-  outFile.open(bmpFile);
-  if (!outFile.is_open()) {
-    delete[] outBuf;
-    return false;
+  if (degrees != 90 && degrees != 270) {
+    return true;
   }
-  for (size_t i = 0; i < outDataSize; i++) {
-    outFile << outBuf[i];
+
+  size_t previousWidth = header->width;
+  size_t previousHeight = header->height;
+  //Exchange header attributes
+  //Update width and height
+  header->height = previousWidth;
+  header->width = previousHeight;
+  //Rotate also printH/W
+  uint32_t transitionAttr = header->printSizeH;
+  header->printSizeH = header->printSizeW;
+  header->printSizeW = transitionAttr;
+
+  //Rows of the rotated image are the columns of the previous one
+  PixelBuffer rotatedBuffer(previousHeight, previousWidth, 1);
+  size_t srcBlocks = (previousWidth + 7) / 8;
+  size_t dstBlocks = (previousHeight + 7) / 8;
+  for (size_t dstBlock = 0; dstBlock < dstBlocks; dstBlock++) {
+    //Source rows of this block; a 270 degrees rotation reads them from the last one
+    const uint8_t* srcRows[8];
+    for (size_t i = 0; i < 8; i++) {
+      size_t dstColumn = (dstBlock * 8) + i;
+      if (dstColumn >= previousHeight) {
+        srcRows[i] = nullptr;
+      } else {
+        srcRows[i] = pixelBuffer.getRow((degrees == 90) ? dstColumn : previousHeight - 1 - dstColumn);
+      }
+    }
+    for (size_t srcBlock = 0; srcBlock < srcBlocks; srcBlock++) {
+      //Gather 8x8 pixels, transpose them and scatter them to 8 rows
+      uint64_t block = 0;
+      for (size_t i = 0; i < 8; i++) {
+        block = (block << 8) | ((srcRows[i] != nullptr) ? srcRows[i][srcBlock] : 0);
+      }
+      block = transpose8x8(block);
+      for (size_t j = 0; j < 8; j++) {
+        size_t srcColumn = (srcBlock * 8) + j;
+        if (srcColumn >= previousWidth) {
+          break;
+        }
+        size_t dstRow = (degrees == 90) ? previousWidth - 1 - srcColumn : srcColumn;
+        rotatedBuffer.getRow(dstRow)[dstBlock] = static_cast<uint8_t>(block >> (56 - (j * 8)));
+      }
+    }
   }
-  outFile.close();
-  delete[] outBuf;
+  pixelBuffer.swap(rotatedBuffer);
   return true;
 }
 
-
 /**
- * @function resizeArea
- * @description resize area (does not scale image), both enlarging or scaling it
+ * @function resizeCanvas
+ * @description resize the canvas to width x height; new pixel (x, y) from the top left corner is pixel (x + xOffset, y + yOffset) of the current image.
+ * Offsets can be negative and the area can exceed the image on any side: pixels outside of the image are set to white
  * @param size_t width
  * @param size_t height
- * @param size_t xOffset (optional)
- * @param size_t yOffset (optional)
+ * @param long long xOffset
+ * @param long long yOffset
  * @returns bool
 **/
 
-bool Bmpmonochrome::resizeArea(size_t width, size_t height, size_t xOffset /* = 0*/, size_t yOffset /* = 0*/) {
-
-  while (header->width != width || header->height != height) {
-    size_t currWidth = header->width;
-    size_t currHeight = header->height;
-    //Resize image in order to match user requests; start with enlarging if necessary
-    if (width > currWidth || height > currHeight) {
-      //Pass higher size or current one to enlarge
-      size_t enlargedWidth = (width > currWidth) ? width : currWidth;
-      size_t enlargedHeight = (height > currHeight) ? height : currHeight;
-      //Initialize Pixel lambda
-      std::function<void(Pixel*&)> initializePixel = [](Pixel*& px) { px = new BWPixel(1); };
-      if (!enlargeArea(enlargedWidth, enlargedHeight, initializePixel, xOffset, yOffset)) {
-        return false;
-      }
-      continue;
-    }
-    //Also, scale area if necessary
-    if (width < currWidth || height << currHeight) {
-      //Pass lower size or current one to scale
-      size_t scaledWidth = (width < currWidth) ? width : currWidth;
-      size_t scaledHeight = (height < currHeight) ? height : currHeight;
-      //Scale image
-      if (!scaleArea(scaledWidth, scaledHeight, xOffset, yOffset)) {
-        return false;
-      }
-      continue;
-    }
-  }
-  //Return OK
-  return true;
+bool Bmpmonochrome::resizeCanvas(size_t width, size_t height, long long xOffset, long long yOffset) {
+  uint8_t fillPixel = 1;
+  return copyArea(width, height, xOffset, yOffset, &fillPixel);
 }
 
 /**
  * @function resizeImage
- * @description resize image (not only area) applying bilinear image scaling
+ * @description resize image (not only area); pixels are sampled with nearest neighbour, which is what a 1 bit image allows
  * @param size_t
  * @param size_t
  * @returns bool
@@ -303,39 +573,88 @@ bool Bmpmonochrome::resizeImage(size_t width, size_t height) {
   //Apply resizing
   size_t prevWidth = header->width;
   size_t prevHeight = header->height;
-  std::vector<Pixel*> resizedArray; //New pixel vector
-  float xRatio = static_cast<float>(prevWidth - 1) / width;
-  float yRatio = static_cast<float>(prevHeight - 1) / height;
-  //Working variables
-  BWPixel *px1, *px2, *px3, *px4;
-  int x, y, index;
-  float xDiff, yDiff;
-  uint8_t value;
-  for (size_t row = 0; row < height; row++) {
+  PixelBuffer resizedBuffer(width, height, 1); //New pixel buffer
+  if (prevWidth > 0 && prevHeight > 0) {
+    //Source column of each destination column
+    std::vector<size_t> srcColumns(width);
     for (size_t column = 0; column < width; column++) {
-      x = static_cast<int>(xRatio * column);
-      y = static_cast<int>(yRatio * row);
-      xDiff = (xRatio * column) - x;
-      yDiff = (yRatio * row) - y;
-      index = ((y * prevWidth) + x);
-      px1 = reinterpret_cast<BWPixel*>(pixelArray.at(index));
-      px2 = reinterpret_cast<BWPixel*>(pixelArray.at(index + 1));
-      px3 = reinterpret_cast<BWPixel*>(pixelArray.at(index + prevWidth));
-      px4 = reinterpret_cast<BWPixel*>(pixelArray.at(index + prevWidth + 1));
-      //Yb = Ab(1-w)(1-h) + Bb(w)(1-h) + Cb(h)(1-w) + Db(wh)
-      value = (px1->getValue() * (1 - xDiff) * (1 - yDiff)) + (px2->getValue() * (xDiff) * (1 - yDiff)) + (px3->getValue() * (yDiff) * (1 - xDiff)) + (px4->getValue() * (xDiff * yDiff));
-      //Instance new pixel
-      Pixel* resizedPixel = new BWPixel(value);
-      //Push pixel into array
-      resizedArray.push_back(resizedPixel);
+      srcColumns[column] = (column * prevWidth) / width;
     }
+    size_t dstRowSize = resizedBuffer.getRowSize();
+    for (size_t row = 0; row < height; row++) {
+      const uint8_t* srcRow = pixelBuffer.getRow((row * prevHeight) / height);
+      uint8_t* dstRow = resizedBuffer.getRow(row);
+      //Build 64 pixels at a time
+      for (size_t wordBit = 0; wordBit < width; wordBit += 64) {
+        size_t wordEnd = (wordBit + 64 < width) ? wordBit + 64 : width;
+        uint64_t word = 0;
+        for (size_t column = wordBit; column < wordEnd; column++) {
+          size_t srcColumn = srcColumns[column];
+          uint64_t bit = (srcRow[srcColumn / 8] >> (7 - (srcColumn % 8))) & 1;
+          word |= bit << (63 - (column - wordBit));
+        }
+        storeWord(dstRow, dstRowSize, wordBit / 8, word, ~0ULL);
+      }
+    }
+  }
+  pixelBuffer.swap(resizedBuffer);
+  //Change header parameters
+  return Bmp::resizeImage(width, height);
+}
+
+/**
+ * @function resizeImage
+ * @description resize image (not only area) resampling it with the provided filter: rows are expanded to 8 bits samples,
+ * resampled, and resized pixels are set where the result is at least half way to white
+ * @param size_t
+ * @param size_t
+ * @param Filter
+ * @returns bool
+**/
+
+bool Bmpmonochrome::resizeImage(size_t width, size_t height, Filter filter) {
+  if (header == nullptr) {
+    return false;
   }
-  //Delete all pixels in previous pixel array
-  for (auto& pixel : pixelArray) {
-    BWPixel* px = reinterpret_cast<BWPixel*>(pixel);
-    delete px;
+  size_t prevWidth = header->width;
+  size_t prevHeight = header->height;
+  //There is nothing to sample
+  if (width > 0 && height > 0 && (prevWidth == 0 || prevHeight == 0)) {
+    return false;
   }
-  pixelArray = resizedArray;
+  ResampleKernel columns(prevWidth, width, filter);
+  ResampleKernel rows(prevHeight, height, filter);
+  PixelBuffer resizedBuffer(width, height, 1);
+  size_t dstRowSize = resizedBuffer.getRowSize();
+  forEachBand(height, resizedBuffer.getStride(), [&, this](size_t firstRow, size_t lastRow) {
+    RowResampler<uint8_t> resampler(columns, rows, 1);
+    std::vector<uint8_t> expandedRow(prevWidth);
+    std::vector<uint8_t> resizedRow(width);
+    size_t nextRow = 0;
+    for (size_t row = firstRow; row < lastRow; row++) {
+      size_t srcRow = std::max(nextRow, rows.getFirst(row));
+      nextRow = rows.getFirst(row) + rows.getCount(row);
+      for (; srcRow < nextRow; srcRow++) {
+        const uint8_t* srcData = pixelBuffer.getRow(srcRow);
+        for (size_t column = 0; column < prevWidth; column++) {
+          expandedRow[column] = ((srcData[column / 8] >> (7 - (column % 8))) & 1) ? 0xFF : 0x00;
+        }
+        resampler.pushRow(srcRow, expandedRow.data());
+      }
+      resampler.resampleRow(row, resizedRow.data());
+      //Build 64 pixels at a time
+      uint8_t* dstRow = resizedBuffer.getRow(row);
+      for (size_t wordBit = 0; wordBit < width; wordBit += 64) {
+        size_t wordEnd = (wordBit + 64 < width) ? wordBit + 64 : width;
+        uint64_t word = 0;
+        for (size_t column = wordBit; column < wordEnd; column++) {
+          word |= static_cast<uint64_t>(resizedRow[column] >> 7) << (63 - (column - wordBit));
+        }
+        storeWord(dstRow, dstRowSize, wordBit / 8, word, ~0ULL);
+      }
+    }
+  });
+  pixelBuffer.swap(resizedBuffer);
   //Change header parameters
   return Bmp::resizeImage(width, height);
 }
@@ -346,8 +665,6 @@ bool Bmpmonochrome::resizeImage(size_t width, size_t height) {
  * @param size_t
  * @param size_t
  * @param uint8_t
- * @param uint8_t
- * @param uint8_t
  * @returns bool
 **/
 
@@ -363,49 +680,144 @@ bool Bmpmonochrome::setPixelAt(size_t row, size_t column, uint8_t value) {
  * @description: replace pixel in a certain position with the provided one
  * @param size_t
  * @param uint8_t
- * @param uint8_t
- * @param uint8_t
  * @returns bool
 **/
 
 bool Bmpmonochrome::setPixelAt(size_t index, uint8_t value) {
-  if (index >= pixelArray.size()) {
+  if (index >= pixelBuffer.getPixelCount()) {
     return false;
   }
-  BWPixel* reqPixel = reinterpret_cast<BWPixel*>(pixelArray.at(index));
-  reqPixel->setPixel(value);
+  size_t column = index % header->width;
+  uint8_t* reqByte = pixelBuffer.getPixel(index);
+  uint8_t mask = static_cast<uint8_t>(0x80 >> (column % 8));
+  if (value > 0) {
+    *reqByte |= mask;
+  } else {
+    *reqByte &= ~mask;
+  }
   return true;
 }
 
 /**
  * @function getPixelAt
- * @description return pointer to pixel in the provided position
+ * @description: get the pixel in the provided position
  * @param size_t
  * @param size_t
- * @returns BWPixel*
+ * @param BWPixel& pixel
+ * @returns bool
 **/
 
-BWPixel* Bmpmonochrome::getPixelAt(size_t row, size_t column) {
-
+bool Bmpmonochrome::getPixelAt(size_t row, size_t column, BWPixel& pixel) {
   //Get index, considering that pixels are stored bottom to top
   size_t reversedRow = (header->height - 1 - row); // h - 1 - r
   size_t index = (header->width * reversedRow) + column;
-  return getPixelAt(index);
+  return getPixelAt(index, pixel);
 }
 
 /**
  * @function getPixelAt
- * @description return pointer to pixel in the provided position
+ * @description: get the pixel in the provided position
  * @param size_t
- * @returns BWPixel*
+ * @param BWPixel& pixel
+ * @returns bool
 **/
 
-BWPixel* Bmpmonochrome::getPixelAt(size_t index) {
+bool Bmpmonochrome::getPixelAt(size_t index, BWPixel& pixel) {
+  if (index >= pixelBuffer.getPixelCount()) {
+    return false;
+  }
+  size_t column = index % header->width;
+  pixel.setPixel((*pixelBuffer.getPixel(index) >> (7 - (column % 8))) & 1);
+  return true;
+}
 
-  if (index >= pixelArray.size()) {
-    return nullptr;
+/**
+ * @function flip
+ * @description: flip image horizontally or vertically based on argument; rows are reversed 64 bits at a time
+ * @param FlipType
+ * @returns bool
+**/
+
+bool Bmpmonochrome::flip(FlipType flipType) {
+
+  if (flipType != FlipType::HORIZONTAL) {
+    //Vertical flip just swaps rows
+    return Bmp::flip(flipType);
   }
-  return reinterpret_cast<BWPixel*>(pixelArray.at(index));
+  //Check if header exists
+  if (header == nullptr) {
+    return false;
+  }
+
+  size_t width = header->width;
+  size_t rowSize = pixelBuffer.getRowSize();
+  std::vector<uint8_t> srcRow(rowSize);
+  for (size_t row = 0; row < header->height; row++) {
+    uint8_t* rowData = pixelBuffer.getRow(row);
+    memcpy(srcRow.data(), rowData, rowSize);
+    //Destination bits [n, n + 64) are source bits [width - n - 64, width - n) reversed
+    for (size_t wordBit = 0; wordBit < width; wordBit += 64) {
+      long long srcBit = static_cast<long long>(width) - static_cast<long long>(wordBit) - 64;
+      uint64_t word = reverseBits(loadWord(srcRow.data(), rowSize, srcBit));
+      storeWord(rowData, rowSize, wordBit / 8, word, ~0ULL);
+    }
+  }
+  return true;
+}
+
+/**
+ * @function copyArea
+ * @description replace the image with a width x height area, whose pixel (x, y) from the top left corner is pixel (x + xOffset, y + yOffset)
+ * of the current image, or fillPixel (0 if nullptr) when outside of it. Rows are filled with a memset, then the image bits are copied a word at a time
+ * @param size_t width
+ * @param size_t height
+ * @param long long xOffset
+ * @param long long yOffset
+ * @param const uint8_t* pixel value to set outside of the image
+ * @returns bool
+**/
+
+bool Bmpmonochrome::copyArea(size_t width, size_t height, long long xOffset, long long yOffset, const uint8_t* fillPixel) {
+
+  if (header == nullptr) {
+    return false;
+  }
+  size_t prevWidth = header->width;
+  size_t prevHeight = header->height;
+  PixelBuffer areaBuffer;
+  if (!areaBuffer.allocate(width, height, 1, false)) {
+    return false;
+  }
+  size_t srcRowSize = pixelBuffer.getRowSize();
+  size_t dstRowSize = areaBuffer.getRowSize();
+  //Columns [firstColumn, lastColumn) of the new area come from the image
+  long long firstColumn = xOffset < 0 ? -xOffset : 0;
+  long long lastColumn = static_cast<long long>(prevWidth) - xOffset;
+  if (lastColumn > static_cast<long long>(width)) {
+    lastColumn = static_cast<long long>(width);
+  }
+  if (lastColumn < firstColumn) {
+    lastColumn = firstColumn = 0;
+  }
+  uint8_t fillByte = (fillPixel != nullptr && *fillPixel != 0) ? 0xFF : 0x00;
+  size_t stride = areaBuffer.getStride();
+  forEachBand(height, stride, [&, this](size_t firstRow, size_t lastRow) {
+    for (size_t row = firstRow; row < lastRow; row++) {
+      uint8_t* dstRow = areaBuffer.getRow(height - 1 - row);
+      long long srcRow = static_cast<long long>(row) + yOffset;
+      memset(dstRow, fillByte, dstRowSize);
+      if (srcRow >= 0 && srcRow < static_cast<long long>(prevHeight) && firstColumn < lastColumn) {
+        const uint8_t* srcData = pixelBuffer.getRow(prevHeight - 1 - static_cast<size_t>(srcRow));
+        copyBits(srcData, srcRowSize, dstRow, dstRowSize, xOffset, static_cast<size_t>(firstColumn), static_cast<size_t>(lastColumn));
+      }
+      clearPadding(dstRow, width, stride);
+    }
+  });
+  pixelBuffer.swap(areaBuffer);
+  //Update header
+  header->width = width;
+  header->height = height;
+  return true;
 }
 
 }
@@ -0,0 +1,130 @@
+/**
+ *   libBMpp - bmppyramid.cpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#include <bmppyramid.hpp>
+
+#include <fstream>
+
+namespace bmp {
+
+/**
+ * @function BmpPyramid
+ * @description BmpPyramid class constructor; the pyramid is empty
+**/
+
+BmpPyramid::BmpPyramid() {
+  data = nullptr;
+}
+
+/**
+ * @function ~BmpPyramid
+ * @description BmpPyramid class destructor
+**/
+
+BmpPyramid::~BmpPyramid() {
+  delete[] data;
+}
+
+/**
+ * @function getLevels
+ * @description returns the amount of levels in the pyramid
+ * @returns size_t
+**/
+
+size_t BmpPyramid::getLevels() {
+  return offsets.empty() ? 0 : offsets.size() - 1;
+}
+
+/**
+ * @function getLevel
+ * @description returns the encoded bitmap of the provided level and sets its size; nullptr if level is out of range
+ * @param size_t level
+ * @param size_t& dataSize
+ * @returns const uint8_t*
+**/
+
+const uint8_t* BmpPyramid::getLevel(size_t level, size_t& dataSize) {
+  if (level >= getLevels()) {
+    dataSize = 0;
+    return nullptr;
+  }
+  dataSize = offsets[level + 1] - offsets[level];
+  return data + offsets[level];
+}
+
+/**
+ * @function getView
+ * @description returns a view over the provided level; the view is invalid if level is out of range
+ * @param size_t level
+ * @returns BmpView
+**/
+
+BmpView BmpPyramid::getView(size_t level) {
+  size_t dataSize;
+  const uint8_t* levelData = getLevel(level, dataSize);
+  if (levelData == nullptr) {
+    return BmpView();
+  }
+  return BmpView(levelData, dataSize);
+}
+
+/**
+ * @function writeLevel
+ * @description write the provided level to a bitmap file
+ * @param size_t level
+ * @param const std::string& bmpFile
+ * @returns bool
+**/
+
+bool BmpPyramid::writeLevel(size_t level, const std::string& bmpFile) {
+  size_t dataSize;
+  const uint8_t* levelData = getLevel(level, dataSize);
+  if (levelData == nullptr) {
+    return false;
+  }
+  std::ofstream outFile(bmpFile, std::ios::binary);
+  if (!outFile.is_open()) {
+    return false;
+  }
+  outFile.write(reinterpret_cast<const char*>(levelData), dataSize);
+  return outFile.good();
+}
+
+/**
+ * @function allocate
+ * @description replace the levels with levels of the provided sizes in bytes, in a single allocation which is returned
+ * @param const std::vector<size_t>& levelSizes
+ * @returns uint8_t*
+**/
+
+uint8_t* BmpPyramid::allocate(const std::vector<size_t>& levelSizes) {
+  delete[] data;
+  offsets.assign(1, 0);
+  for (size_t levelSize : levelSizes) {
+    offsets.push_back(offsets.back() + levelSize);
+  }
+  data = new uint8_t[offsets.back()];
+  return data;
+}
+
+} // namespace bmp
@@ -0,0 +1,435 @@
+/**
+ *   libBMpp - bmprowreader.cpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <bmprowreader.hpp>
+#include <pixels/pixelbuffer.hpp>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#define NO_POSITION static_cast<size_t>(-1)
+#define MAX_PADDING 3
+
+namespace bmp {
+
+/**
+ * @function seekFile
+ * @description move file position to provided offset from the beginning of the file
+ * @param FILE*
+ * @param size_t
+ * @returns bool
+**/
+
+static bool seekFile(FILE* file, size_t position) {
+#ifdef HAVE_FSEEKO
+  return fseeko(file, static_cast<off_t>(position), SEEK_SET) == 0;
+#else
+  return fseek(file, static_cast<long>(position), SEEK_SET) == 0;
+#endif
+}
+
+/**
+ * @function getFileSize
+ * @description get the size of the file
+ * @param FILE*
+ * @param size_t&
+ * @returns bool
+**/
+
+static bool getFileSize(FILE* file, size_t& fileSize) {
+#ifdef HAVE_FSEEKO
+  if (fseeko(file, 0, SEEK_END) != 0) {
+    return false;
+  }
+  off_t endPosition = ftello(file);
+#else
+  if (fseek(file, 0, SEEK_END) != 0) {
+    return false;
+  }
+  long endPosition = ftell(file);
+#endif
+  if (endPosition < 0) {
+    return false;
+  }
+  fileSize = static_cast<size_t>(endPosition);
+  return true;
+}
+
+/**
+ * @function BmpRowReader
+ * @description BmpRowReader class constructor
+**/
+
+BmpRowReader::BmpRowReader() {
+  file = nullptr;
+  order = RowOrder::TOP_DOWN;
+  rowSize = 0;
+  stride = 0;
+  currentRow = 0;
+  filePosition = NO_POSITION;
+  header.width = 0;
+  header.height = 0;
+  header.bitsPerPixel = 0;
+}
+
+/**
+ * @function ~BmpRowReader
+ * @description BmpRowReader class destructor; closes the file
+**/
+
+BmpRowReader::~BmpRowReader() {
+  close();
+}
+
+/**
+ * @function open
+ * @description open a bitmap file and decode its header
+ * @param const std::string&
+ * @param RowOrder
+ * @returns bool
+**/
+
+bool BmpRowReader::open(const std::string& bmpFile, RowOrder rowOrder) {
+  FILE* inFile = fopen(bmpFile.c_str(), "rb");
+  if (inFile == nullptr) {
+    return false;
+  }
+  return openFile(inFile, rowOrder);
+}
+
+/**
+ * @function open
+ * @description decode the header of the bitmap in the provided file descriptor, which must be seekable.
+ * The file descriptor is duplicated: the caller still owns fd
+ * @param int
+ * @param RowOrder
+ * @returns bool
+**/
+
+bool BmpRowReader::open(int fd, RowOrder rowOrder) {
+#ifdef HAVE_UNISTD_H
+  int fdCopy = dup(fd);
+  if (fdCopy < 0) {
+    return false;
+  }
+  FILE* inFile = fdopen(fdCopy, "rb");
+  if (inFile == nullptr) {
+    ::close(fdCopy);
+    return false;
+  }
+  return openFile(inFile, rowOrder);
+#else
+  return false;
+#endif
+}
+
+/**
+ * @function close
+ * @description close the file
+**/
+
+void BmpRowReader::close() {
+  if (file != nullptr) {
+    fclose(file);
+    file = nullptr;
+  }
+  rowSize = 0;
+  stride = 0;
+  currentRow = 0;
+  filePosition = NO_POSITION;
+  palette.clear();
+}
+
+/**
+ * @function openFile
+ * @description decode and validate the header of the bitmap in bmpFile; bmpFile is closed if it is not supported
+ * @param FILE*
+ * @param RowOrder
+ * @returns bool
+**/
+
+bool BmpRowReader::openFile(FILE* bmpFile, RowOrder rowOrder) {
+
+  close();
+  file = bmpFile;
+  order = rowOrder;
+  size_t fileSize;
+  uint8_t headerData[54];
+  if (!getFileSize(file, fileSize) || fileSize < 54 || !readAt(0, headerData, 54) || !Bmp::decodeHeader(headerData, fileSize, header)) {
+    close();
+    return false;
+  }
+  //Only uncompressed bitmaps can be read by rows
+  uint16_t bpp = header.bitsPerPixel;
+  if (header.biRgb != 0 || header.width == 0 || header.height == 0 || (bpp != 1 && bpp != 8 && bpp != 16 && bpp != 24 && bpp != 32)) {
+    close();
+    return false;
+  }
+  //The whole raster must be inside the file
+  size_t rasterStride = PixelBuffer::strideFor(header.width, bpp);
+  if (header.dataOffset > fileSize || header.height > (fileSize - header.dataOffset) / rasterStride) {
+    close();
+    return false;
+  }
+  if (!readPalette()) {
+    close();
+    return false;
+  }
+  stride = rasterStride;
+  rowSize = (static_cast<size_t>(header.width) * bpp + 7) / 8;
+  return true;
+
+}
+
+/**
+ * @function readPalette
+ * @description read the color table of 1 and 8 bits bitmaps, which follows the info header
+ * @returns bool
+**/
+
+bool BmpRowReader::readPalette() {
+
+  palette.clear();
+  if (header.bitsPerPixel > 8) {
+    return true;
+  }
+  size_t tableOffset = 14 + static_cast<size_t>(header.dibSize);
+  if (header.dataOffset <= tableOffset) {
+    return true;
+  }
+  //A palette size of 0 means all the colors which fit in the color table
+  size_t colors = (header.dataOffset - tableOffset) / 4;
+  if (header.paletteSize > 0 && header.paletteSize < colors) {
+    colors = header.paletteSize;
+  }
+  size_t maxColors = static_cast<size_t>(1) << header.bitsPerPixel;
+  if (colors > maxColors) {
+    colors = maxColors;
+  }
+  std::vector<uint8_t> table(colors * 4);
+  if (colors > 0 && !readAt(tableOffset, table.data(), table.size())) {
+    return false;
+  }
+  palette.reserve(colors);
+  for (size_t index = 0; index < colors; index++) {
+    const uint8_t* entry = table.data() + index * 4;
+    palette.push_back(RGBAPixel(entry[2], entry[1], entry[0], entry[3]));
+  }
+  return true;
+
+}
+
+/**
+ * @function readAt
+ * @description read size bytes at provided position; small gaps (row padding) are read instead of seeking
+ * @param size_t
+ * @param uint8_t*
+ * @param size_t
+ * @returns bool
+**/
+
+bool BmpRowReader::readAt(size_t position, uint8_t* buffer, size_t size) {
+
+  if (position != filePosition) {
+    if (filePosition != NO_POSITION && position > filePosition && position - filePosition <= MAX_PADDING) {
+      uint8_t padding[MAX_PADDING];
+      if (fread(padding, 1, position - filePosition, file) != position - filePosition) {
+        filePosition = NO_POSITION;
+        return false;
+      }
+    } else if (!seekFile(file, position)) {
+      filePosition = NO_POSITION;
+      return false;
+    }
+  }
+  if (fread(buffer, 1, size, file) != size) {
+    filePosition = NO_POSITION;
+    return false;
+  }
+  filePosition = position + size;
+  return true;
+
+}
+
+/**
+ * @function getFileRow
+ * @description returns the index in the file of the provided row (in reading order)
+ * @param size_t
+ * @returns size_t
+**/
+
+size_t BmpRowReader::getFileRow(size_t row) {
+  size_t bottomUpRow = order == RowOrder::BOTTOM_UP ? row : header.height - 1 - row;
+  //Rows are stored bottom to top, unless the bitmap is top-down
+  return header.topDown ? header.height - 1 - bottomUpRow : bottomUpRow;
+}
+
+/**
+ * @function readRow
+ * @description read the next row into row, which must be at least getRowSize() bytes long
+ * @param uint8_t*
+ * @returns bool
+**/
+
+bool BmpRowReader::readRow(uint8_t* row) {
+
+  if (file == nullptr || currentRow >= header.height) {
+    return false;
+  }
+  if (!readAt(header.dataOffset + getFileRow(currentRow) * stride, row, rowSize)) {
+    return false;
+  }
+  //Clear bits beyond width
+  size_t lastBits = (static_cast<size_t>(header.width) * header.bitsPerPixel) % 8;
+  if (lastBits != 0) {
+    row[rowSize - 1] &= static_cast<uint8_t>(0xFF << (8 - lastBits));
+  }
+  currentRow++;
+  return true;
+
+}
+
+/**
+ * @function readRows
+ * @description read up to rowCount rows into rows; rows are getRowSize() bytes each. Returns the amount of rows read
+ * @param uint8_t*
+ * @param size_t
+ * @returns size_t
+**/
+
+size_t BmpRowReader::readRows(uint8_t* rows, size_t rowCount) {
+
+  if (file == nullptr) {
+    return 0;
+  }
+  if (rowCount > header.height - currentRow) {
+    rowCount = header.height - currentRow;
+  }
+  //Without padding, a band in file order is a single read
+  bool fileOrder = (order == RowOrder::TOP_DOWN) == header.topDown;
+  if (fileOrder && rowSize == stride && rowCount > 0) {
+    if (!readAt(header.dataOffset + getFileRow(currentRow) * stride, rows, rowCount * stride)) {
+      return 0;
+    }
+    currentRow += rowCount;
+    return rowCount;
+  }
+  size_t rowsRead = 0;
+  while (rowsRead < rowCount && readRow(rows + rowsRead * rowSize)) {
+    rowsRead++;
+  }
+  return rowsRead;
+
+}
+
+/**
+ * @function seekRow
+ * @description set the next row to read (in reading order)
+ * @param size_t
+ * @returns bool
+**/
+
+bool BmpRowReader::seekRow(size_t row) {
+  if (file == nullptr || row >= header.height) {
+    return false;
+  }
+  currentRow = row;
+  return true;
+}
+
+/**
+ * @function getWidth
+ * @description returns bitmap width
+ * @returns size_t
+**/
+
+size_t BmpRowReader::getWidth() {
+  return header.width;
+}
+
+/**
+ * @function getHeight
+ * @description returns bitmap height
+ * @returns size_t
+**/
+
+size_t BmpRowReader::getHeight() {
+  return header.height;
+}
+
+/**
+ * @function getBitsPerPixel
+ * @description returns bitmap bits per pixel
+ * @returns uint16_t
+**/
+
+uint16_t BmpRowReader::getBitsPerPixel() {
+  return header.bitsPerPixel;
+}
+
+/**
+ * @function getRowSize
+ * @description returns the size in bytes of a row, without padding
+ * @returns size_t
+**/
+
+size_t BmpRowReader::getRowSize() {
+  return rowSize;
+}
+
+/**
+ * @function getCurrentRow
+ * @description returns the index of the next row to read (in reading order)
+ * @returns size_t
+**/
+
+size_t BmpRowReader::getCurrentRow() {
+  return currentRow;
+}
+
+/**
+ * @function getHeader
+ * @description returns the decoded header
+ * @returns const bmp::Header&
+**/
+
+const bmp::Header& BmpRowReader::getHeader() {
+  return header;
+}
+
+/**
+ * @function getPalette
+ * @description returns the color table of 1 and 8 bits bitmaps (empty for the other bitmaps)
+ * @returns const std::vector<RGBAPixel>&
+**/
+
+const std::vector<RGBAPixel>& BmpRowReader::getPalette() {
+  return palette;
+}
+
+} // namespace bmp
@@ -0,0 +1,323 @@
+/**
+ *   libBMpp - bmprowwriter.cpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <bmprowwriter.hpp>
+#include <pixels/pixelbuffer.hpp>
+
+#include <cstdint>
+
+#define NO_POSITION static_cast<size_t>(-1)
+#define MAX_PADDING 3
+
+namespace bmp {
+
+/**
+ * @function seekFile
+ * @description move file position to provided offset from the beginning of the file
+ * @param FILE*
+ * @param size_t
+ * @returns bool
+**/
+
+static bool seekFile(FILE* file, size_t position) {
+#ifdef HAVE_FSEEKO
+  return fseeko(file, static_cast<off_t>(position), SEEK_SET) == 0;
+#else
+  return fseek(file, static_cast<long>(position), SEEK_SET) == 0;
+#endif
+}
+
+/**
+ * @function BmpRowWriter
+ * @description BmpRowWriter class constructor
+**/
+
+BmpRowWriter::BmpRowWriter() {
+  file = nullptr;
+  order = RowOrder::TOP_DOWN;
+  rowSize = 0;
+  stride = 0;
+  currentRow = 0;
+  filePosition = NO_POSITION;
+  failed = false;
+  header.width = 0;
+  header.height = 0;
+  header.bitsPerPixel = 0;
+}
+
+/**
+ * @function ~BmpRowWriter
+ * @description BmpRowWriter class destructor; closes the file
+**/
+
+BmpRowWriter::~BmpRowWriter() {
+  close();
+}
+
+/**
+ * @function open
+ * @description create a bitmap file and write its header. 1 and 8 bits bitmaps get the provided color table
+ * (2^bitsPerPixel colors at most) or, if it is empty, a grey scale one
+ * @param const std::string&
+ * @param size_t
+ * @param size_t
+ * @param uint16_t
+ * @param RowOrder
+ * @param const std::vector<RGBAPixel>&
+ * @returns bool
+**/
+
+bool BmpRowWriter::open(const std::string& bmpFile, size_t width, size_t height, uint16_t bitsPerPixel, RowOrder rowOrder, const std::vector<RGBAPixel>& palette) {
+
+  close();
+  if (width == 0 || height == 0 || width > INT32_MAX || height > INT32_MAX) {
+    return false;
+  }
+  if (bitsPerPixel != 1 && bitsPerPixel != 8 && bitsPerPixel != 16 && bitsPerPixel != 24 && bitsPerPixel != 32) {
+    return false;
+  }
+  //Only 1 and 8 bits bitmaps have a color table
+  size_t maxColors = (bitsPerPixel <= 8) ? static_cast<size_t>(1) << bitsPerPixel : 0;
+  if (palette.size() > maxColors) {
+    return false;
+  }
+  std::vector<uint8_t> colorTable;
+  colorTable.reserve(maxColors * 4);
+  if (!palette.empty()) {
+    for (const RGBAPixel& color : palette) {
+      colorTable.push_back(color.getBlue());
+      colorTable.push_back(color.getGreen());
+      colorTable.push_back(color.getRed());
+      colorTable.push_back(color.getAlpha());
+    }
+  } else {
+    for (size_t index = 0; index < maxColors; index++) {
+      uint8_t grey = static_cast<uint8_t>(index * 255 / (maxColors - 1));
+      colorTable.push_back(grey);
+      colorTable.push_back(grey);
+      colorTable.push_back(grey);
+      colorTable.push_back(0);
+    }
+  }
+  //Sizes are stored in 32 bits
+  size_t rasterStride = PixelBuffer::strideFor(width, bitsPerPixel);
+  if (height > (UINT32_MAX - 54 - colorTable.size()) / rasterStride) {
+    return false;
+  }
+  header.dataOffset = 54 + colorTable.size();
+  header.width = width;
+  header.height = height;
+  header.bitsPerPixel = bitsPerPixel;
+  header.dataSize = rasterStride * height;
+  header.fileSize = header.dataOffset + header.dataSize;
+  header.printSizeW = 0;
+  header.printSizeH = 0;
+  header.paletteSize = colorTable.size() / 4;
+  header.importantColors = 0;
+  file = fopen(bmpFile.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  order = rowOrder;
+  stride = rasterStride;
+  rowSize = (width * bitsPerPixel + 7) / 8;
+  uint8_t headerData[54];
+  Bmp::encodeHeader(header, headerData);
+  if (!writeAt(0, headerData, 54) || (!colorTable.empty() && !writeAt(54, colorTable.data(), colorTable.size()))) {
+    close();
+    return false;
+  }
+  return true;
+
+}
+
+/**
+ * @function close
+ * @description close the file. Returns false if not all the rows have been written or if the file couldn't be written
+ * @returns bool
+**/
+
+bool BmpRowWriter::close() {
+  if (file == nullptr) {
+    return false;
+  }
+  bool rc = !failed && currentRow == header.height;
+  if (fclose(file) != 0) {
+    rc = false;
+  }
+  file = nullptr;
+  rowSize = 0;
+  stride = 0;
+  currentRow = 0;
+  filePosition = NO_POSITION;
+  failed = false;
+  return rc;
+}
+
+/**
+ * @function writeAt
+ * @description write size bytes at provided position
+ * @param size_t
+ * @param const uint8_t*
+ * @param size_t
+ * @returns bool
+**/
+
+bool BmpRowWriter::writeAt(size_t position, const uint8_t* buffer, size_t size) {
+
+  if (position != filePosition && !seekFile(file, position)) {
+    failed = true;
+    return false;
+  }
+  if (fwrite(buffer, 1, size, file) != size) {
+    failed = true;
+    return false;
+  }
+  filePosition = position + size;
+  return true;
+
+}
+
+/**
+ * @function writeRow
+ * @description write the next row, which is getRowSize() bytes long; padding is added
+ * @param const uint8_t*
+ * @returns bool
+**/
+
+bool BmpRowWriter::writeRow(const uint8_t* row) {
+
+  if (file == nullptr || failed || currentRow >= header.height) {
+    return false;
+  }
+  //Rows are stored bottom to top
+  size_t storageRow = order == RowOrder::BOTTOM_UP ? currentRow : header.height - 1 - currentRow;
+  size_t position = header.dataOffset + storageRow * stride;
+  //Bits beyond width and padding must be 0
+  size_t lastBits = (static_cast<size_t>(header.width) * header.bitsPerPixel) % 8;
+  uint8_t tail[1 + MAX_PADDING] = {0, 0, 0, 0};
+  size_t tailSize = stride - rowSize;
+  size_t dataSize = rowSize;
+  if (lastBits != 0) {
+    dataSize--;
+    tail[0] = row[dataSize] & static_cast<uint8_t>(0xFF << (8 - lastBits));
+    tailSize++;
+  }
+  if (!writeAt(position, row, dataSize)) {
+    return false;
+  }
+  if (tailSize > 0 && !writeAt(position + dataSize, tail, tailSize)) {
+    return false;
+  }
+  currentRow++;
+  return true;
+
+}
+
+/**
+ * @function writeRows
+ * @description write up to rowCount rows; rows are getRowSize() bytes each. Returns the amount of rows written
+ * @param const uint8_t*
+ * @param size_t
+ * @returns size_t
+**/
+
+size_t BmpRowWriter::writeRows(const uint8_t* rows, size_t rowCount) {
+
+  if (file == nullptr || failed) {
+    return 0;
+  }
+  if (rowCount > header.height - currentRow) {
+    rowCount = header.height - currentRow;
+  }
+  //Without padding, a band in file order is a single write
+  if (order == RowOrder::BOTTOM_UP && rowSize == stride && rowCount > 0) {
+    if (!writeAt(header.dataOffset + currentRow * stride, rows, rowCount * stride)) {
+      return 0;
+    }
+    currentRow += rowCount;
+    return rowCount;
+  }
+  size_t rowsWritten = 0;
+  while (rowsWritten < rowCount && writeRow(rows + rowsWritten * rowSize)) {
+    rowsWritten++;
+  }
+  return rowsWritten;
+
+}
+
+/**
+ * @function getWidth
+ * @description returns bitmap width
+ * @returns size_t
+**/
+
+size_t BmpRowWriter::getWidth() {
+  return header.width;
+}
+
+/**
+ * @function getHeight
+ * @description returns bitmap height
+ * @returns size_t
+**/
+
+size_t BmpRowWriter::getHeight() {
+  return header.height;
+}
+
+/**
+ * @function getBitsPerPixel
+ * @description returns bitmap bits per pixel
+ * @returns uint16_t
+**/
+
+uint16_t BmpRowWriter::getBitsPerPixel() {
+  return header.bitsPerPixel;
+}
+
+/**
+ * @function getRowSize
+ * @description returns the size in bytes of a row, without padding
+ * @returns size_t
+**/
+
+size_t BmpRowWriter::getRowSize() {
+  return rowSize;
+}
+
+/**
+ * @function getCurrentRow
+ * @description returns the index of the next row to write (in writing order)
+ * @returns size_t
+**/
+
+size_t BmpRowWriter::getCurrentRow() {
+  return currentRow;
+}
+
+} // namespace bmp
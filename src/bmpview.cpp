@@ -0,0 +1,124 @@
+/**
+ *   libBMpp - bmpview.cpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#include <bmpview.hpp>
+
+namespace bmp {
+
+/**
+ * @function BmpView
+ * @description BmpView class constructor; the view is empty
+**/
+
+BmpView::BmpView() {
+  raster = nullptr;
+  stride = 0;
+  header.width = 0;
+  header.height = 0;
+  header.bitsPerPixel = 0;
+}
+
+/**
+ * @function BmpView
+ * @description BmpView class constructor; the view is invalid if bmpData is not supported
+ * @param const uint8_t*
+ * @param size_t
+**/
+
+BmpView::BmpView(const uint8_t* bmpData, size_t dataSize) : BmpView() {
+  setData(bmpData, dataSize);
+}
+
+/**
+ * @function setData
+ * @description point the view to an encoded bitmap. Only BI_RGB 8, 16, 24 and 32 bits bitmaps are supported
+ * @param const uint8_t*
+ * @param size_t
+ * @returns bool
+**/
+
+bool BmpView::setData(const uint8_t* bmpData, size_t dataSize) {
+
+  raster = nullptr;
+  stride = 0;
+  if (bmpData == nullptr || !Bmp::decodeHeader(bmpData, dataSize, header)) {
+    return false;
+  }
+  if (header.biRgb != 0 || header.width == 0 || header.height == 0) {
+    return false;
+  }
+  if (header.bitsPerPixel != 8 && header.bitsPerPixel != 16 && header.bitsPerPixel != 24 && header.bitsPerPixel != 32) {
+    return false;
+  }
+  //The whole raster must be inside the buffer
+  size_t rowSize = PixelBuffer::strideFor(header.width, header.bitsPerPixel);
+  if (header.dataOffset > dataSize || header.height > (dataSize - header.dataOffset) / rowSize) {
+    return false;
+  }
+  stride = rowSize;
+  raster = bmpData + header.dataOffset;
+  return true;
+
+}
+
+/**
+ * @function getWidth
+ * @description returns bitmap width
+ * @returns size_t
+**/
+
+size_t BmpView::getWidth() {
+  return header.width;
+}
+
+/**
+ * @function getHeight
+ * @description returns bitmap height
+ * @returns size_t
+**/
+
+size_t BmpView::getHeight() {
+  return header.height;
+}
+
+/**
+ * @function getBitsPerPixel
+ * @description returns bitmap bits per pixel
+ * @returns uint16_t
+**/
+
+uint16_t BmpView::getBitsPerPixel() {
+  return header.bitsPerPixel;
+}
+
+/**
+ * @function getStride
+ * @description returns the size in bytes of a row, padding included
+ * @returns size_t
+**/
+
+size_t BmpView::getStride() {
+  return stride;
+}
+
+} // namespace bmp
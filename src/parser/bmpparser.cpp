@@ -29,6 +29,7 @@
 #include <bmp24.hpp>
 #include <bmp32.hpp>
 
+#include <fstream>
 #include <functional>
 
 using namespace bmp;
@@ -52,45 +53,203 @@ BmpParser::BmpParser() {
 **/
 
 Bmp* BmpParser::getBmp(uint8_t* bmpData, size_t dataSize, size_t& bitsPerPixel) {
-  Bmp* decBmp = new Bmp();
-  if (!decBmp->decodeBmp(bmpData, dataSize)) {
+  //Only the header is needed to choose the class
+  Header header;
+  if (!probe(bmpData, dataSize, header)) {
     return nullptr;
   }
   //Get bits per pixel
-  bitsPerPixel = decBmp->getBitsPerPixel();
-  delete decBmp;
+  bitsPerPixel = header.bitsPerPixel;
+  Bmp* outBmp = newBmp(bitsPerPixel);
+  if (outBmp == nullptr) {
+    return nullptr;
+  }
+  if (!outBmp->decodeBmp(bmpData, dataSize)) {
+    delete outBmp;
+    return nullptr;
+  }
+  bitsPerPixel = outBmp->getBitsPerPixel();
+  return outBmp;
+}
+
+/**
+ * @function getRegion
+ * @description decodes only an area of a bitmap (offsets are from the top left corner) and returns a pointer to the instance of its specialized type class
+ * @param uint8_t*
+ * @param size_t dataSize
+ * @param size_t xOffset
+ * @param size_t yOffset
+ * @param size_t width
+ * @param size_t height
+ * @param size_t& bitsPerPixel
+ * @returns Bmp*
+**/
+
+Bmp* BmpParser::getRegion(uint8_t* bmpData, size_t dataSize, size_t xOffset, size_t yOffset, size_t width, size_t height, size_t& bitsPerPixel) {
+  Header header;
+  if (!probe(bmpData, dataSize, header)) {
+    return nullptr;
+  }
+  bitsPerPixel = header.bitsPerPixel;
+  Bmp* outBmp = newBmp(bitsPerPixel);
+  if (outBmp == nullptr) {
+    return nullptr;
+  }
+  if (!outBmp->decodeRegion(bmpData, dataSize, xOffset, yOffset, width, height)) {
+    delete outBmp;
+    return nullptr;
+  }
+  bitsPerPixel = outBmp->getBitsPerPixel();
+  return outBmp;
+}
+
+/**
+ * @function getRegion
+ * @description reads only an area of a bitmap file: the file is memory mapped, so just the rows of the area are read
+ * @param const std::string& bmpFile
+ * @param size_t xOffset
+ * @param size_t yOffset
+ * @param size_t width
+ * @param size_t height
+ * @param size_t& bitsPerPixel
+ * @returns Bmp*
+**/
+
+Bmp* BmpParser::getRegion(const std::string& bmpFile, size_t xOffset, size_t yOffset, size_t width, size_t height, size_t& bitsPerPixel) {
+  Header header;
+  if (!probe(bmpFile, header)) {
+    return nullptr;
+  }
+  bitsPerPixel = header.bitsPerPixel;
+  Bmp* outBmp = newBmp(bitsPerPixel);
+  if (outBmp == nullptr) {
+    return nullptr;
+  }
+  if (!outBmp->readRegion(bmpFile, xOffset, yOffset, width, height)) {
+    delete outBmp;
+    return nullptr;
+  }
+  bitsPerPixel = outBmp->getBitsPerPixel();
+  return outBmp;
+}
+
+/**
+ * @function getScaled
+ * @description decodes a bitmap downscaled to width x height (see Bmp::decodeScaled) and returns a pointer to the instance of its specialized type class
+ * @param uint8_t*
+ * @param size_t dataSize
+ * @param size_t width
+ * @param size_t height
+ * @param size_t& bitsPerPixel
+ * @returns Bmp*
+**/
+
+Bmp* BmpParser::getScaled(uint8_t* bmpData, size_t dataSize, size_t width, size_t height, size_t& bitsPerPixel) {
+  Header header;
+  if (!probe(bmpData, dataSize, header)) {
+    return nullptr;
+  }
+  bitsPerPixel = header.bitsPerPixel;
+  Bmp* outBmp = newBmp(bitsPerPixel);
+  if (outBmp == nullptr) {
+    return nullptr;
+  }
+  if (!outBmp->decodeScaled(bmpData, dataSize, width, height)) {
+    delete outBmp;
+    return nullptr;
+  }
+  bitsPerPixel = outBmp->getBitsPerPixel();
+  return outBmp;
+}
+
+/**
+ * @function getScaled
+ * @description reads a bitmap file downscaled to width x height (see Bmp::readScaled)
+ * @param const std::string& bmpFile
+ * @param size_t width
+ * @param size_t height
+ * @param size_t& bitsPerPixel
+ * @returns Bmp*
+**/
+
+Bmp* BmpParser::getScaled(const std::string& bmpFile, size_t width, size_t height, size_t& bitsPerPixel) {
+  Header header;
+  if (!probe(bmpFile, header)) {
+    return nullptr;
+  }
+  bitsPerPixel = header.bitsPerPixel;
+  Bmp* outBmp = newBmp(bitsPerPixel);
+  if (outBmp == nullptr) {
+    return nullptr;
+  }
+  if (!outBmp->readScaled(bmpFile, width, height)) {
+    delete outBmp;
+    return nullptr;
+  }
+  bitsPerPixel = outBmp->getBitsPerPixel();
+  return outBmp;
+}
+
+/**
+ * @function newBmp
+ * @description instance the class which decodes bitmaps with the provided bits per pixel
+ * @param size_t bitsPerPixel
+ * @returns Bmp*: nullptr if bits per pixel are not supported
+**/
+
+Bmp* BmpParser::newBmp(size_t bitsPerPixel) {
   switch (bitsPerPixel) {
-    case 1: {
-      Bmpmonochrome* outBmp = new Bmpmonochrome();
-      outBmp->decodeBmp(bmpData, dataSize);
-      return outBmp;
-      break;
-    }
-    case 8: {
-      Bmp8* outBmp = new Bmp8();
-      outBmp->decodeBmp(bmpData, dataSize);
-      return outBmp;
-      break;
-    }
-    case 16: {
-      Bmp16* outBmp = new Bmp16();
-      outBmp->decodeBmp(bmpData, dataSize);
-      return outBmp;
-      break;
-    }
-    case 24: {
-      Bmp24* outBmp = new Bmp24();
-      outBmp->decodeBmp(bmpData, dataSize);
-      return outBmp;
-      break;
-    }
-    case 32: {
-      Bmp32* outBmp = new Bmp32();
-      outBmp->decodeBmp(bmpData, dataSize);
-      return outBmp;
-      break;
-    }
+    case 1:
+      return new Bmpmonochrome();
+    case 4:
+    case 8:
+      //4 bits bitmaps are decoded to 8 bits
+      return new Bmp8();
+    case 16:
+      return new Bmp16();
+    case 24:
+      return new Bmp24();
+    case 32:
+      return new Bmp32();
     default:
       return nullptr;
   }
 }
+
+/**
+ * @function probe
+ * @description decodes the header of a bitmap (size, bits per pixel, compression, offsets...) without decoding the pixels;
+ * the first 54 bytes are enough, so a prefix of the file can be probed
+ * @param const uint8_t*
+ * @param size_t dataSize
+ * @param Header& header
+ * @returns bool
+**/
+
+bool BmpParser::probe(const uint8_t* bmpData, size_t dataSize, Header& header) {
+  if (bmpData == nullptr) {
+    return false;
+  }
+  return Bmp::decodeHeader(bmpData, dataSize, header);
+}
+
+/**
+ * @function probe
+ * @description decodes the header of a bitmap file reading its first 54 bytes only
+ * @param const std::string& bmpFile
+ * @param Header& header
+ * @returns bool
+**/
+
+bool BmpParser::probe(const std::string& bmpFile, Header& header) {
+  std::ifstream iFile;
+  iFile.open(bmpFile, std::ios::binary);
+  if (!iFile.is_open()) {
+    return false;
+  }
+  char headerData[54];
+  if (!iFile.read(headerData, 54)) {
+    return false;
+  }
+  return Bmp::decodeHeader(reinterpret_cast<uint8_t*>(headerData), 54, header);
+}
@@ -25,6 +25,8 @@
 
 namespace bmp {
 
+static_assert(sizeof(BWPixel) == 1, "BWPixel must have the size of a raster pixel");
+
 /**
  * @function BWPixel
  * @description: BWPixel class constructor
@@ -37,26 +39,4 @@ BWPixel::BWPixel(uint8_t value) {
   this->value = value > 0 ? 1 : 0;
 }
 
-/**
- * @function setPixel
- * @description: Set pixel RGB value
- * @param uint8_t
- * @param uint8_t
- * @param uint8_t
-**/
-
-void BWPixel::setPixel(uint8_t value) {
-  this->value = value > 0 ? 1 : 0;
-}
-
-/**
- * @function getValue
- * @description returns color (1:0) value
- * @returns uint8_t
-**/
-
-uint8_t BWPixel::getValue() {
-  return value;
-}
-
 }
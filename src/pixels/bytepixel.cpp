@@ -25,6 +25,8 @@
 
 namespace bmp {
 
+static_assert(sizeof(BytePixel) == 1, "BytePixel must have the size of a raster pixel");
+
 /**
  * @function BytePixel
  * @description: BytePixel class constructor
@@ -32,27 +34,7 @@ namespace bmp {
 **/
 
 BytePixel::BytePixel(uint8_t value) {
-  this->value = value > 0 ? 1 : 0;
-}
-
-/**
- * @function setPixel
- * @description: Set pixel RGB value
- * @param uint8_t
-**/
-
-void BytePixel::setPixel(uint8_t value) {
-  this->value = value > 0 ? 1 : 0;
-}
-
-/**
- * @function getValue
- * @description returns color (1:0) value
- * @returns uint8_t
-**/
-
-uint8_t BytePixel::getValue() {
-  return value;
+  this->value = value;
 }
 
 }
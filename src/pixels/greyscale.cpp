@@ -0,0 +1,240 @@
+/**
+ *   libBMpp - greyscale.cpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#include <pixels/greyscale.hpp>
+#include <pixels/swizzle.hpp>
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define GREY_WEIGHT_BITS 15
+//Pixels converted at a time when rows are converted in place
+#define GREY_CHUNK_PIXELS 256
+
+namespace bmp {
+
+/**
+ * @function GreyScale
+ * @description GreyScale class constructor. Weights have 15 fractional bits: luma weights sum to 1 and grey is rounded;
+ * average weights are a bit more than 1/3 and grey is truncated, so that it's exactly (red + green + blue) / 3.
+ * Grey g is then reduced to g - (g % (255 / greyLevels)) when greyLevels is less than 255
+ * @param GreyWeights
+ * @param int greyLevels
+**/
+
+GreyScale::GreyScale(GreyWeights weights /* = GreyWeights::AVERAGE */, int greyLevels /* = 255 */) {
+  switch (weights) {
+  case GreyWeights::BT601:
+    //0.114, 0.587, 0.299
+    blueWeight = 3735;
+    greenWeight = 19235;
+    redWeight = 9798;
+    bias = 1 << (GREY_WEIGHT_BITS - 1);
+    break;
+  case GreyWeights::BT709:
+    //0.0722, 0.7152, 0.2126
+    blueWeight = 2366;
+    greenWeight = 23436;
+    redWeight = 6966;
+    bias = 1 << (GREY_WEIGHT_BITS - 1);
+    break;
+  case GreyWeights::AVERAGE:
+  default:
+    blueWeight = 10923;
+    greenWeight = 10923;
+    redWeight = 10923;
+    bias = 0;
+    break;
+  }
+  quantized = greyLevels > 0 && greyLevels < 128;
+  int step = quantized ? 255 / greyLevels : 1;
+  for (int grey = 0; grey < 256; grey++) {
+    levels[grey] = static_cast<uint8_t>(grey - (grey % step));
+    memset(palette + (grey * 4), levels[grey], 3);
+    palette[(grey * 4) + 3] = 0;
+  }
+}
+
+/**
+ * @function getGrey
+ * @description returns the grey of a color
+ * @param uint8_t red
+ * @param uint8_t green
+ * @param uint8_t blue
+ * @returns uint8_t
+**/
+
+uint8_t GreyScale::getGrey(uint8_t red, uint8_t green, uint8_t blue) const {
+  return levels[((blue * blueWeight) + (green * greenWeight) + (red * redWeight) + bias) >> GREY_WEIGHT_BITS];
+}
+
+#if defined(__SSE2__)
+
+/**
+ * @function weighPixels
+ * @description returns the weighted sums of 4 pixels of 4 bytes, one per 32 bits lane
+ * @param __m128i pixels
+ * @param __m128i weights (blue, green, red, 0 repeated)
+ * @param __m128i bias
+ * @returns __m128i
+**/
+
+static inline __m128i weighPixels(__m128i pixels, __m128i weights, __m128i bias) {
+  const __m128i zero = _mm_setzero_si128();
+  //Blue and green, red and alpha sums of pixels 0 and 1, then 2 and 3
+  __m128i lowSums = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), weights);
+  __m128i highSums = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), weights);
+  lowSums = _mm_shuffle_epi32(lowSums, _MM_SHUFFLE(3, 1, 2, 0));
+  highSums = _mm_shuffle_epi32(highSums, _MM_SHUFFLE(3, 1, 2, 0));
+  __m128i sums = _mm_add_epi32(_mm_unpacklo_epi64(lowSums, highSums), _mm_unpackhi_epi64(lowSums, highSums));
+  return _mm_srli_epi32(_mm_add_epi32(sums, bias), GREY_WEIGHT_BITS);
+}
+
+/**
+ * @function loadPixels24
+ * @description load 4 pixels of 3 bytes as pixels of 4 bytes (the 4th one is 0), reading 14 bytes
+ * @param const uint8_t*
+ * @returns __m128i
+**/
+
+static inline __m128i loadPixels24(const uint8_t* pixels) {
+  //Pixels 0 and 1 in the low half, 2 and 3 in the high half; the second pixel of each half is moved up by a byte
+  __m128i halves = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels)), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels + 6)));
+  const __m128i firstMask = _mm_set_epi32(0, 0x00FFFFFF, 0, 0x00FFFFFF);
+  const __m128i secondMask = _mm_set_epi32(0x00FFFFFF, 0, 0x00FFFFFF, 0);
+  return _mm_or_si128(_mm_and_si128(halves, firstMask), _mm_and_si128(_mm_slli_epi64(halves, 8), secondMask));
+}
+
+#endif
+
+/**
+ * @function weighRow
+ * @description write the weighted sum of each pixel of a row of 3 or 4 bytes pixels to grey (8 pixels at a time with SSE2)
+ * @param const uint8_t* src
+ * @param uint8_t* grey
+ * @param size_t width
+ * @param size_t channels
+**/
+
+void GreyScale::weighRow(const uint8_t* src, uint8_t* grey, size_t width, size_t channels) const {
+  size_t column = 0;
+#if defined(__SSE2__)
+  const __m128i weights = _mm_set_epi16(0, redWeight, greenWeight, blueWeight, 0, redWeight, greenWeight, blueWeight);
+  const __m128i sumBias = _mm_set1_epi32(bias);
+  if (channels == 4) {
+    for (; column + 8 <= width; column += 8) {
+      const uint8_t* pixels = src + (column * 4);
+      __m128i firstGreys = weighPixels(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels)), weights, sumBias);
+      __m128i secondGreys = weighPixels(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + 16)), weights, sumBias);
+      __m128i greys = _mm_packs_epi32(firstGreys, secondGreys);
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(grey + column), _mm_packus_epi16(greys, greys));
+    }
+  } else if (channels == 3) {
+    //The last group reads 2 bytes past its pixels
+    for (; ((column + 8) * 3) + 2 <= width * 3; column += 8) {
+      const uint8_t* pixels = src + (column * 3);
+      __m128i firstGreys = weighPixels(loadPixels24(pixels), weights, sumBias);
+      __m128i secondGreys = weighPixels(loadPixels24(pixels + 12), weights, sumBias);
+      __m128i greys = _mm_packs_epi32(firstGreys, secondGreys);
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(grey + column), _mm_packus_epi16(greys, greys));
+    }
+  }
+#endif
+  for (; column < width; column++) {
+    const uint8_t* pixel = src + (column * channels);
+    grey[column] = static_cast<uint8_t>(((pixel[0] * blueWeight) + (pixel[1] * greenWeight) + (pixel[2] * redWeight) + bias) >> GREY_WEIGHT_BITS);
+  }
+}
+
+/**
+ * @function toGrey
+ * @description write the grey of each pixel of a row of 3 or 4 bytes pixels to grey (one byte per pixel)
+ * @param const uint8_t* src
+ * @param uint8_t* grey
+ * @param size_t width
+ * @param size_t channels
+**/
+
+void GreyScale::toGrey(const uint8_t* src, uint8_t* grey, size_t width, size_t channels) const {
+  weighRow(src, grey, width, channels);
+  if (quantized) {
+    for (size_t column = 0; column < width; column++) {
+      grey[column] = levels[grey[column]];
+    }
+  }
+}
+
+/**
+ * @function toGreyRow24
+ * @description convert a row of 3 bytes pixels to grey in place
+ * @param uint8_t* row
+ * @param size_t width
+**/
+
+void GreyScale::toGreyRow24(uint8_t* row, size_t width) const {
+  uint8_t greys[GREY_CHUNK_PIXELS];
+  for (size_t column = 0; column < width; column += GREY_CHUNK_PIXELS) {
+    size_t pixels = (width - column < GREY_CHUNK_PIXELS) ? width - column : GREY_CHUNK_PIXELS;
+    uint8_t* chunk = row + (column * 3);
+    weighRow(chunk, greys, pixels, 3);
+    //Grey levels are applied by the palette
+    Swizzle::expandPalette24(greys, chunk, pixels, palette);
+  }
+}
+
+/**
+ * @function toGreyRow32
+ * @description convert a row of 4 bytes pixels to grey in place; alpha is kept
+ * @param uint8_t* row
+ * @param size_t width
+**/
+
+void GreyScale::toGreyRow32(uint8_t* row, size_t width) const {
+  uint8_t greys[GREY_CHUNK_PIXELS];
+  for (size_t column = 0; column < width; column += GREY_CHUNK_PIXELS) {
+    size_t pixels = (width - column < GREY_CHUNK_PIXELS) ? width - column : GREY_CHUNK_PIXELS;
+    uint8_t* chunk = row + (column * 4);
+    toGrey(chunk, greys, pixels, 4);
+    size_t pixel = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    for (; pixel + 4 <= pixels; pixel += 4) {
+      int fourGreys;
+      memcpy(&fourGreys, greys + pixel, 4);
+      __m128i grey = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(fourGreys), zero), zero);
+      grey = _mm_or_si128(grey, _mm_or_si128(_mm_slli_epi32(grey, 8), _mm_slli_epi32(grey, 16)));
+      __m128i* dstPixels = reinterpret_cast<__m128i*>(chunk + (pixel * 4));
+      _mm_storeu_si128(dstPixels, _mm_or_si128(grey, _mm_and_si128(_mm_loadu_si128(dstPixels), alphaMask)));
+    }
+#endif
+    for (; pixel < pixels; pixel++) {
+      memset(chunk + (pixel * 4), greys[pixel], 3);
+    }
+  }
+}
+
+} // namespace bmp
@@ -0,0 +1,335 @@
+/**
+ *   libBMpp - pixelbuffer.cpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#include <pixels/pixelbuffer.hpp>
+
+#include <cstring>
+#include <utility>
+
+namespace bmp {
+
+/**
+ * @function PixelBuffer
+ * @description PixelBuffer class constructor; creates an empty buffer
+**/
+
+PixelBuffer::PixelBuffer() {
+  data = nullptr;
+  width = 0;
+  height = 0;
+  stride = 0;
+  bitsPerPixel = 0;
+}
+
+/**
+ * @function PixelBuffer
+ * @description PixelBuffer class constructor; allocates a zeroed raster
+ * @param size_t width
+ * @param size_t height
+ * @param uint16_t bitsPerPixel
+**/
+
+PixelBuffer::PixelBuffer(size_t width, size_t height, uint16_t bitsPerPixel) : PixelBuffer() {
+  allocate(width, height, bitsPerPixel);
+}
+
+/**
+ * @function PixelBuffer
+ * @description PixelBuffer class copy constructor
+ * @param const PixelBuffer& buffer
+**/
+
+PixelBuffer::PixelBuffer(const PixelBuffer& buffer) : PixelBuffer() {
+  *this = buffer;
+}
+
+/**
+ * @function ~PixelBuffer
+ * @description PixelBuffer class destructor
+**/
+
+PixelBuffer::~PixelBuffer() {
+  release();
+}
+
+/**
+ * @function operator=
+ * @description copy the raster of another buffer into this one
+ * @param const PixelBuffer& buffer
+ * @returns PixelBuffer&
+**/
+
+PixelBuffer& PixelBuffer::operator=(const PixelBuffer& buffer) {
+  if (this == &buffer) {
+    return *this;
+  }
+  release();
+  width = buffer.width;
+  height = buffer.height;
+  stride = buffer.stride;
+  bitsPerPixel = buffer.bitsPerPixel;
+  if (buffer.data != nullptr) {
+    data = new uint8_t[stride * height];
+    memcpy(data, buffer.data, stride * height);
+  }
+  return *this;
+}
+
+/**
+ * @function allocate
+ * @description allocate a new raster, discarding the previous one; the allocation is reused if it has the same size
+ * @param size_t width
+ * @param size_t height
+ * @param uint16_t bitsPerPixel
+ * @param bool clear: set the raster to 0 (optional); may be false if every byte, padding included, is going to be written
+ * @returns bool
+**/
+
+bool PixelBuffer::allocate(size_t width, size_t height, uint16_t bitsPerPixel, bool clear /* = true */) {
+  if (bitsPerPixel == 0) {
+    release();
+    return false;
+  }
+  size_t newStride = strideFor(width, bitsPerPixel);
+  if (data == nullptr || newStride * height != stride * this->height) {
+    release();
+    if (newStride * height > 0) {
+      data = new uint8_t[newStride * height];
+    }
+  }
+  this->width = width;
+  this->height = height;
+  this->bitsPerPixel = bitsPerPixel;
+  stride = newStride;
+  if (clear && data != nullptr) {
+    memset(data, 0, stride * height);
+  }
+  return true;
+}
+
+/**
+ * @function release
+ * @description free the raster and reset the buffer to empty
+**/
+
+void PixelBuffer::release() {
+  delete[] data;
+  data = nullptr;
+  width = 0;
+  height = 0;
+  stride = 0;
+  bitsPerPixel = 0;
+}
+
+/**
+ * @function swap
+ * @description exchange raster and geometry with another buffer
+ * @param PixelBuffer& buffer
+**/
+
+void PixelBuffer::swap(PixelBuffer& buffer) {
+  std::swap(data, buffer.data);
+  std::swap(width, buffer.width);
+  std::swap(height, buffer.height);
+  std::swap(stride, buffer.stride);
+  std::swap(bitsPerPixel, buffer.bitsPerPixel);
+}
+
+/**
+ * @function fill
+ * @description set every pixel to the provided pixel bytes (bytes per pixel long); padding is left to 0.
+ * For 1 bit buffers every pixel is set to 1 if the first byte is not 0
+ * @param const uint8_t* pixel
+**/
+
+void PixelBuffer::fill(const uint8_t* pixel) {
+  size_t bytesPerPixel = getBytesPerPixel();
+  if (data == nullptr) {
+    return;
+  }
+  if (bitsPerPixel == 1) {
+    //Packed pixels: set whole bytes, then clear the bits after the last pixel
+    size_t rowSize = getRowSize();
+    memset(data, 0, stride * height);
+    for (size_t row = 0; row < height && *pixel > 0; row++) {
+      uint8_t* rowData = data + (row * stride);
+      memset(rowData, 0xFF, rowSize);
+      if (width % 8 != 0) {
+        rowData[rowSize - 1] = static_cast<uint8_t>(0xFF << (8 - (width % 8)));
+      }
+    }
+    return;
+  }
+  if (bytesPerPixel == 0) {
+    return;
+  }
+  //Build first row, then replicate it
+  uint8_t* firstRow = data;
+  for (size_t column = 0; column < width; column++) {
+    memcpy(firstRow + (column * bytesPerPixel), pixel, bytesPerPixel);
+  }
+  for (size_t row = 1; row < height; row++) {
+    memcpy(data + (row * stride), firstRow, stride);
+  }
+}
+
+/**
+ * @function getData
+ * @description returns pointer to the beginning of the raster
+ * @returns uint8_t*
+**/
+
+uint8_t* PixelBuffer::getData() {
+  return data;
+}
+
+/**
+ * @function getRow
+ * @description returns pointer to the first byte of a row (rows are stored bottom to top)
+ * @param size_t
+ * @returns uint8_t*
+**/
+
+uint8_t* PixelBuffer::getRow(size_t row) {
+  return data + (row * stride);
+}
+
+/**
+ * @function getPixel
+ * @description returns pointer to the first byte of the pixel in the provided storage position (the byte containing it for 1 bit pixels)
+ * @param size_t
+ * @param size_t
+ * @returns uint8_t*
+**/
+
+uint8_t* PixelBuffer::getPixel(size_t row, size_t column) {
+  return data + (row * stride) + ((column * bitsPerPixel) / 8);
+}
+
+/**
+ * @function getPixel
+ * @description returns pointer to the first byte of the pixel with the provided index (row * width + column)
+ * @param size_t
+ * @returns uint8_t*
+**/
+
+uint8_t* PixelBuffer::getPixel(size_t index) {
+  if (width == 0) {
+    return nullptr;
+  }
+  return getPixel(index / width, index % width);
+}
+
+/**
+ * @function getWidth
+ * @description returns the raster width in pixels
+ * @returns size_t
+**/
+
+size_t PixelBuffer::getWidth() {
+  return width;
+}
+
+/**
+ * @function getHeight
+ * @description returns the raster height in pixels
+ * @returns size_t
+**/
+
+size_t PixelBuffer::getHeight() {
+  return height;
+}
+
+/**
+ * @function getStride
+ * @description returns the size of a row in bytes, padding included
+ * @returns size_t
+**/
+
+size_t PixelBuffer::getStride() {
+  return stride;
+}
+
+/**
+ * @function getRowSize
+ * @description returns the size of a row in bytes, padding excluded
+ * @returns size_t
+**/
+
+size_t PixelBuffer::getRowSize() {
+  return ((width * bitsPerPixel) + 7) / 8;
+}
+
+/**
+ * @function getDataSize
+ * @description returns the size of the raster in bytes
+ * @returns size_t
+**/
+
+size_t PixelBuffer::getDataSize() {
+  return stride * height;
+}
+
+/**
+ * @function getPixelCount
+ * @description returns the amount of pixels in the raster
+ * @returns size_t
+**/
+
+size_t PixelBuffer::getPixelCount() {
+  return width * height;
+}
+
+/**
+ * @function getBytesPerPixel
+ * @description returns the amount of bytes used by a pixel (0 if a pixel is smaller than a byte)
+ * @returns size_t
+**/
+
+size_t PixelBuffer::getBytesPerPixel() {
+  return bitsPerPixel / 8;
+}
+
+/**
+ * @function getBitsPerPixel
+ * @description returns the amount of bits used by a pixel
+ * @returns uint16_t
+**/
+
+uint16_t PixelBuffer::getBitsPerPixel() {
+  return bitsPerPixel;
+}
+
+/**
+ * @function strideFor
+ * @description returns the size in bytes of a BMP row (padded to 4 bytes) with the provided geometry
+ * @param size_t width
+ * @param uint16_t bitsPerPixel
+ * @returns size_t
+**/
+
+size_t PixelBuffer::strideFor(size_t width, uint16_t bitsPerPixel) {
+  return (((width * bitsPerPixel) + 31) / 32) * 4;
+}
+
+}
@@ -0,0 +1,473 @@
+/**
+ *   libBMpp - resampler.cpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#include <pixels/resampler.hpp>
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define RESAMPLE_WEIGHT_BITS 14
+#define RESAMPLE_WEIGHT_ONE (1 << RESAMPLE_WEIGHT_BITS)
+#define RESAMPLE_ROUND (1 << (RESAMPLE_WEIGHT_BITS - 1))
+
+namespace bmp {
+
+/**
+ * @function getSupport
+ * @description returns the radius of a filter, in source samples when not downscaling
+ * @param Filter
+ * @returns double
+**/
+
+static double getSupport(Filter filter) {
+  switch (filter) {
+  case Filter::BOX:
+    return 0.5;
+  case Filter::BILINEAR:
+    return 1.0;
+  case Filter::BICUBIC:
+    return 2.0;
+  case Filter::LANCZOS3:
+  default:
+    return 3.0;
+  }
+}
+
+/**
+ * @function sinc
+ * @description returns the normalized sinc of x
+ * @param double
+ * @returns double
+**/
+
+static inline double sinc(double x) {
+  if (x == 0.0) {
+    return 1.0;
+  }
+  x *= 3.14159265358979323846;
+  return std::sin(x) / x;
+}
+
+/**
+ * @function getWeight
+ * @description returns the value of a filter at distance x from its center
+ * @param Filter
+ * @param double
+ * @returns double
+**/
+
+static double getWeight(Filter filter, double x) {
+  switch (filter) {
+  case Filter::BOX:
+    return (x > -0.5 && x <= 0.5) ? 1.0 : 0.0;
+  case Filter::BILINEAR:
+    x = std::fabs(x);
+    return x < 1.0 ? 1.0 - x : 0.0;
+  case Filter::BICUBIC: {
+    //Cubic convolution with a = -0.5 (Catmull-Rom)
+    const double a = -0.5;
+    x = std::fabs(x);
+    if (x < 1.0) {
+      return (((a + 2.0) * x - (a + 3.0)) * x * x) + 1.0;
+    } else if (x < 2.0) {
+      return (((x - 5.0) * x + 8.0) * x - 4.0) * a;
+    }
+    return 0.0;
+  }
+  case Filter::LANCZOS3:
+  default:
+    return (x > -3.0 && x < 3.0) ? sinc(x) * sinc(x / 3.0) : 0.0;
+  }
+}
+
+/**
+ * @function clampSample
+ * @description returns a fixed point sum rounded to a sample, clamped to the range of the channel type
+ * @param int64_t
+ * @returns ChannelType
+**/
+
+template <typename ChannelType>
+static inline ChannelType clampSample(int64_t sum) {
+  const int64_t maxValue = static_cast<ChannelType>(~0);
+  sum = (sum + RESAMPLE_ROUND) >> RESAMPLE_WEIGHT_BITS;
+  return static_cast<ChannelType>(sum < 0 ? 0 : (sum > maxValue ? maxValue : sum));
+}
+
+/**
+ * @function ResampleKernel
+ * @description ResampleKernel class constructor; computes the weights of each sample of the resized axis
+ * @param size_t source size
+ * @param size_t resized size
+ * @param Filter
+**/
+
+ResampleKernel::ResampleKernel(size_t srcSize, size_t size, Filter filter) : srcSize(srcSize), size(size), taps(0), stride(0) {
+  if (size == 0 || srcSize == 0) {
+    return;
+  }
+  double scale = static_cast<double>(srcSize) / size;
+  double stretch = scale > 1.0 ? scale : 1.0;
+  double support = getSupport(filter) * stretch;
+  stride = (static_cast<size_t>(std::ceil(support)) * 2) + 1;
+  first.resize(size);
+  count.resize(size);
+  weights.assign(size * stride, 0);
+  std::vector<double> values(stride);
+  for (size_t position = 0; position < size; position++) {
+    //Pixel centers are aligned
+    double center = (position + 0.5) * scale;
+    long long begin = static_cast<long long>(center - support + 0.5);
+    long long end = static_cast<long long>(center + support + 0.5);
+    begin = begin < 0 ? 0 : begin;
+    end = end > static_cast<long long>(srcSize) ? static_cast<long long>(srcSize) : end;
+    end = (end - begin) > static_cast<long long>(stride) ? begin + static_cast<long long>(stride) : end;
+    double total = 0.0;
+    for (long long sample = begin; sample < end; sample++) {
+      values[sample - begin] = getWeight(filter, (sample + 0.5 - center) / stretch);
+      total += values[sample - begin];
+    }
+    //Drop samples with no weight at both ends
+    while (end > begin && values[end - 1 - begin] == 0.0) {
+      end--;
+    }
+    long long skipped = 0;
+    while (begin + skipped < end && values[skipped] == 0.0) {
+      skipped++;
+    }
+    if (begin + skipped == end) {
+      //No sample in reach: take the nearest one
+      long long nearest = static_cast<long long>(center);
+      begin = nearest < static_cast<long long>(srcSize) ? nearest : static_cast<long long>(srcSize) - 1;
+      end = begin + 1;
+      skipped = 0;
+      values[0] = 1.0;
+      total = 1.0;
+    }
+    //Convert to fixed point; the rounding error is added to the largest weight, so that weights sum to 1
+    int16_t* positionWeights = &weights[position * stride];
+    int sum = 0;
+    size_t largest = 0;
+    for (long long sample = begin + skipped; sample < end; sample++) {
+      size_t tap = static_cast<size_t>(sample - begin - skipped);
+      positionWeights[tap] = static_cast<int16_t>(std::lround((values[sample - begin] / total) * RESAMPLE_WEIGHT_ONE));
+      sum += positionWeights[tap];
+      if (positionWeights[tap] > positionWeights[largest]) {
+        largest = tap;
+      }
+    }
+    positionWeights[largest] = static_cast<int16_t>(positionWeights[largest] + (RESAMPLE_WEIGHT_ONE - sum));
+    first[position] = static_cast<uint32_t>(begin + skipped);
+    count[position] = static_cast<uint32_t>(end - begin - skipped);
+    if (count[position] > taps) {
+      taps = count[position];
+    }
+  }
+}
+
+#if defined(__SSE2__)
+
+/**
+ * @function loadPixel
+ * @description load a pixel of 3 or 4 bytes into the low 4 16 bits lanes of a vector
+ * @param const uint8_t*
+ * @returns __m128i
+**/
+
+template <size_t channels>
+static inline __m128i loadPixel(const uint8_t* pixel) {
+  int bytes;
+  if (channels == 4) {
+    memcpy(&bytes, pixel, 4);
+  } else {
+    //Bytes are combined in a register: a partial copy to memory would stall the load
+    bytes = pixel[0] | (pixel[1] << 8) | (pixel[2] << 16);
+  }
+  return _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), _mm_setzero_si128());
+}
+
+/**
+ * @function loadPair
+ * @description load two adjacent pixels of 3 or 4 bytes, reading 8 bytes, with their channels interleaved in 16 bits lanes
+ * @param const uint8_t*
+ * @returns __m128i
+**/
+
+template <size_t channels>
+static inline __m128i loadPair(const uint8_t* pixel) {
+  __m128i pixels = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixel)), _mm_setzero_si128());
+  return _mm_unpacklo_epi16(pixels, _mm_srli_si128(pixels, channels * 2));
+}
+
+/**
+ * @function pairWeights
+ * @description broadcast two weights to every pair of 16 bits lanes, as multiplied by _mm_madd_epi16
+ * @param int16_t weight of the first sample
+ * @param int16_t weight of the second sample
+ * @returns __m128i
+**/
+
+static inline __m128i pairWeights(int16_t first, int16_t second) {
+  return _mm_set1_epi32(static_cast<int>((static_cast<uint32_t>(static_cast<uint16_t>(second)) << 16) | static_cast<uint16_t>(first)));
+}
+
+/**
+ * @function resampleColumns
+ * @description resample a row of pixels of 3 or 4 bytes horizontally, blending two source pixels per multiply-add
+ * @param const uint8_t* source row
+ * @param uint8_t* resized row
+ * @param const ResampleKernel& columns
+**/
+
+template <size_t channels>
+static void resampleColumns(const uint8_t* src, uint8_t* dst, const ResampleKernel& columns) {
+  const __m128i round = _mm_set1_epi32(RESAMPLE_ROUND);
+  size_t srcSize = columns.getSourceSize();
+  size_t size = columns.getSize();
+  for (size_t column = 0; column < size; column++) {
+    size_t first = columns.getFirst(column);
+    size_t count = columns.getCount(column);
+    const uint8_t* pixel = src + (first * channels);
+    const int16_t* weights = columns.getWeights(column);
+    //Pairs are loaded 8 bytes at a time unless they would read past the end of the row
+    bool wide = (first + count + (channels == 3 ? 1 : 0)) <= srcSize;
+    __m128i sums = round;
+    size_t tap = 0;
+    for (; tap + 2 <= count; tap += 2) {
+      __m128i pairs;
+      if (wide) {
+        pairs = loadPair<channels>(pixel + (tap * channels));
+      } else {
+        pairs = _mm_unpacklo_epi16(loadPixel<channels>(pixel + (tap * channels)), loadPixel<channels>(pixel + ((tap + 1) * channels)));
+      }
+      sums = _mm_add_epi32(sums, _mm_madd_epi16(pairs, pairWeights(weights[tap], weights[tap + 1])));
+    }
+    if (tap < count) {
+      __m128i pairs = _mm_unpacklo_epi16(loadPixel<channels>(pixel + (tap * channels)), _mm_setzero_si128());
+      sums = _mm_add_epi32(sums, _mm_madd_epi16(pairs, _mm_set1_epi32(static_cast<uint16_t>(weights[tap]))));
+    }
+    sums = _mm_srai_epi32(sums, RESAMPLE_WEIGHT_BITS);
+    sums = _mm_packs_epi32(sums, sums);
+    int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(sums, sums));
+    //The fourth byte of a 3 bytes pixel is overwritten by the next one
+    memcpy(dst + (column * channels), &bytes, (column + 1 < size) ? 4 : channels);
+  }
+}
+
+/**
+ * @function resampleColumns
+ * @description resample a row of 1 byte pixels horizontally, blending 8 source pixels per two multiply-adds
+ * @param const uint8_t* source row
+ * @param uint8_t* resized row
+ * @param const ResampleKernel& columns
+**/
+
+static void resampleColumns(const uint8_t* src, uint8_t* dst, const ResampleKernel& columns) {
+  const __m128i zero = _mm_setzero_si128();
+  for (size_t column = 0; column < columns.getSize(); column++) {
+    const uint8_t* pixel = src + columns.getFirst(column);
+    const int16_t* weights = columns.getWeights(column);
+    size_t count = columns.getCount(column);
+    __m128i sums = zero;
+    size_t tap = 0;
+    for (; tap + 8 <= count; tap += 8) {
+      __m128i samples = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixel + tap)), zero);
+      sums = _mm_add_epi32(sums, _mm_madd_epi16(samples, _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + tap))));
+    }
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(2, 3, 0, 1)));
+    int64_t sum = _mm_cvtsi128_si32(sums);
+    for (; tap < count; tap++) {
+      sum += pixel[tap] * weights[tap];
+    }
+    dst[column] = clampSample<uint8_t>(sum);
+  }
+}
+
+#endif
+
+/**
+ * @function resampleColumns
+ * @description resample a row horizontally
+ * @param const ChannelType* source row
+ * @param ChannelType* resized row
+ * @param const ResampleKernel& columns
+ * @param size_t channels
+**/
+
+template <typename ChannelType>
+static void resampleColumns(const ChannelType* src, ChannelType* dst, const ResampleKernel& columns, size_t channels) {
+  for (size_t column = 0; column < columns.getSize(); column++) {
+    const ChannelType* pixel = src + (columns.getFirst(column) * channels);
+    const int16_t* weights = columns.getWeights(column);
+    size_t count = columns.getCount(column);
+    for (size_t channel = 0; channel < channels; channel++) {
+      int64_t sum = 0;
+      for (size_t tap = 0; tap < count; tap++) {
+        sum += static_cast<int64_t>(pixel[(tap * channels) + channel]) * weights[tap];
+      }
+      dst[(column * channels) + channel] = clampSample<ChannelType>(sum);
+    }
+  }
+}
+
+/**
+ * @function resampleColumns
+ * @description resample a row of 8 bits channels horizontally (SSE2 for pixels of 1, 3 and 4 bytes)
+ * @param const uint8_t* source row
+ * @param uint8_t* resized row
+ * @param const ResampleKernel& columns
+ * @param size_t channels
+**/
+
+static void resampleColumns(const uint8_t* src, uint8_t* dst, const ResampleKernel& columns, size_t channels) {
+#if defined(__SSE2__)
+  if (channels == 4) {
+    resampleColumns<4>(src, dst, columns);
+    return;
+  } else if (channels == 3) {
+    resampleColumns<3>(src, dst, columns);
+    return;
+  } else if (channels == 1) {
+    resampleColumns(src, dst, columns);
+    return;
+  }
+#endif
+  resampleColumns<uint8_t>(src, dst, columns, channels);
+}
+
+/**
+ * @function resampleRows
+ * @description resample samples vertically: resized is the weighted sum of the same sample of count rows
+ * @param const ChannelType* const* rows
+ * @param const int16_t* weights
+ * @param size_t count
+ * @param ChannelType* resized
+ * @param size_t first sample
+ * @param size_t samples
+**/
+
+template <typename ChannelType>
+static void resampleRows(const ChannelType* const* rows, const int16_t* weights, size_t count, ChannelType* resized, size_t first, size_t samples) {
+  for (size_t sample = first; sample < samples; sample++) {
+    int64_t sum = 0;
+    for (size_t tap = 0; tap < count; tap++) {
+      sum += static_cast<int64_t>(rows[tap][sample]) * weights[tap];
+    }
+    resized[sample] = clampSample<ChannelType>(sum);
+  }
+}
+
+/**
+ * @function resampleRows
+ * @description resample 8 bits samples vertically, 8 samples and two rows per multiply-add with SSE2
+ * @param const uint8_t* const* rows
+ * @param const int16_t* weights
+ * @param size_t count
+ * @param uint8_t* resized
+ * @param size_t first sample
+ * @param size_t samples
+**/
+
+static void resampleRows(const uint8_t* const* rows, const int16_t* weights, size_t count, uint8_t* resized, size_t first, size_t samples) {
+  size_t sample = first;
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i round = _mm_set1_epi32(RESAMPLE_ROUND);
+  for (; sample + 8 <= samples; sample += 8) {
+    __m128i lowSums = round;
+    __m128i highSums = round;
+    size_t tap = 0;
+    for (; tap + 2 <= count; tap += 2) {
+      __m128i firstSamples = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(rows[tap] + sample)), zero);
+      __m128i secondSamples = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(rows[tap + 1] + sample)), zero);
+      __m128i tapWeights = pairWeights(weights[tap], weights[tap + 1]);
+      lowSums = _mm_add_epi32(lowSums, _mm_madd_epi16(_mm_unpacklo_epi16(firstSamples, secondSamples), tapWeights));
+      highSums = _mm_add_epi32(highSums, _mm_madd_epi16(_mm_unpackhi_epi16(firstSamples, secondSamples), tapWeights));
+    }
+    if (tap < count) {
+      __m128i firstSamples = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(rows[tap] + sample)), zero);
+      __m128i tapWeights = _mm_set1_epi32(static_cast<uint16_t>(weights[tap]));
+      lowSums = _mm_add_epi32(lowSums, _mm_madd_epi16(_mm_unpacklo_epi16(firstSamples, zero), tapWeights));
+      highSums = _mm_add_epi32(highSums, _mm_madd_epi16(_mm_unpackhi_epi16(firstSamples, zero), tapWeights));
+    }
+    __m128i packed = _mm_packs_epi32(_mm_srai_epi32(lowSums, RESAMPLE_WEIGHT_BITS), _mm_srai_epi32(highSums, RESAMPLE_WEIGHT_BITS));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(resized + sample), _mm_packus_epi16(packed, packed));
+  }
+#endif
+  resampleRows<uint8_t>(rows, weights, count, resized, sample, samples);
+}
+
+/**
+ * @function RowResampler
+ * @description RowResampler class constructor
+ * @param const ResampleKernel& kernel of the columns
+ * @param const ResampleKernel& kernel of the rows
+ * @param size_t channels
+**/
+
+template <typename ChannelType>
+RowResampler<ChannelType>::RowResampler(const ResampleKernel& columns, const ResampleKernel& rows, size_t channels) : columns(columns), rows(rows), channels(channels) {
+  rowSamples = columns.getSize() * channels;
+  ring.resize(rowSamples * rows.getTaps());
+  ringRows.resize(rows.getTaps());
+}
+
+/**
+ * @function pushRow
+ * @description resample a source row horizontally into the ring
+ * @param size_t source row
+ * @param const ChannelType* samples of the source row
+**/
+
+template <typename ChannelType>
+void RowResampler<ChannelType>::pushRow(size_t srcRow, const ChannelType* samples) {
+  resampleColumns(samples, &ring[(srcRow % rows.getTaps()) * rowSamples], columns, channels);
+}
+
+/**
+ * @function resampleRow
+ * @description resample a resized row vertically from the source rows in the ring
+ * @param size_t resized row
+ * @param ChannelType* resized samples
+**/
+
+template <typename ChannelType>
+void RowResampler<ChannelType>::resampleRow(size_t row, ChannelType* resized) {
+  size_t taps = rows.getTaps();
+  size_t first = rows.getFirst(row);
+  size_t count = rows.getCount(row);
+  for (size_t tap = 0; tap < count; tap++) {
+    ringRows[tap] = &ring[((first + tap) % taps) * rowSamples];
+  }
+  resampleRows(ringRows.data(), rows.getWeights(row), count, resized, 0, rowSamples);
+}
+
+template class RowResampler<uint8_t>;
+template class RowResampler<uint16_t>;
+
+} // namespace bmp
@@ -25,6 +25,8 @@
 
 namespace bmp {
 
+static_assert(sizeof(RGBAPixel) == 4, "RGBAPixel must have the size of a raster pixel");
+
 /**
  * @function RGBPixel
  * @description: RGBPixel class constructor
@@ -41,60 +43,4 @@ RGBAPixel::RGBAPixel(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha) {
   this->alpha = alpha;
 }
 
-/**
- * @function setPixel
- * @description: Set pixel RGB value
- * @param uint8_t
- * @param uint8_t
- * @param uint8_t
- * @param uint8_t
-**/
-
-void RGBAPixel::setPixel(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha) {
-  this->red = red;
-  this->green = green;
-  this->blue = blue;
-  this->alpha = alpha;
-}
-
-/**
- * @function getRed
- * @description returns red level
- * @returns uint8_t
-**/
-
-uint8_t RGBAPixel::getRed() {
-  return red;
-}
-
-/**
- * @function getGreen
- * @description returns green level
- * @returns uint8_t
-**/
-
-uint8_t RGBAPixel::getGreen() {
-  return green;
-}
-
-/**
- * @function getBlue
- * @description returns blue level
- * @returns uint8_t
-**/
-
-uint8_t RGBAPixel::getBlue() {
-  return blue;
-}
-
-/**
- * @function getAlpha
- * @description: returns alpha level
- * @returns uint8_t
-**/
-
-uint8_t RGBAPixel::getAlpha() {
-  return alpha;
-}
-
 }
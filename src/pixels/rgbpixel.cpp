@@ -25,6 +25,8 @@
 
 namespace bmp {
 
+static_assert(sizeof(RGBPixel) == 3, "RGBPixel must have the size of a raster pixel");
+
 /**
  * @function RGBPixel
  * @description: RGBPixel class constructor
@@ -39,48 +41,4 @@ RGBPixel::RGBPixel(uint8_t red, uint8_t green, uint8_t blue) {
   this->blue = blue;
 }
 
-/**
- * @function setPixel
- * @description: Set pixel RGB value
- * @param uint8_t
- * @param uint8_t
- * @param uint8_t
-**/
-
-void RGBPixel::setPixel(uint8_t red, uint8_t green, uint8_t blue) {
-  this->red = red;
-  this->green = green;
-  this->blue = blue;
-}
-
-/**
- * @function getRed
- * @description returns red level
- * @returns uint8_t
-**/
-
-uint8_t RGBPixel::getRed() {
-  return red;
-}
-
-/**
- * @function getGreen
- * @description returns green level
- * @returns uint8_t
-**/
-
-uint8_t RGBPixel::getGreen() {
-  return green;
-}
-
-/**
- * @function getBlue
- * @description returns blue level
- * @returns uint8_t
-**/
-
-uint8_t RGBPixel::getBlue() {
-  return blue;
-}
-
 }
@@ -0,0 +1,157 @@
+/**
+ *   libBMpp - swizzle.cpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#include <pixels/swizzle.hpp>
+
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+namespace bmp {
+
+/**
+ * @function shuffle32
+ * @description reorder the bytes of each 4 bytes pixel: dst byte i of a pixel is src byte order[i] of the same pixel. src and dst may be the same row
+ * @param const uint8_t* src
+ * @param uint8_t* dst
+ * @param size_t width in pixels
+ * @param const uint8_t* order (4 indexes, 0 to 3)
+**/
+
+void Swizzle::shuffle32(const uint8_t* src, uint8_t* dst, size_t width, const uint8_t* order) {
+  size_t column = 0;
+#if defined(__AVX2__)
+  //8 pixels at a time; shuffles don't cross 128 bits lanes, but pixels don't either
+  uint8_t mask[32];
+  for (size_t i = 0; i < 32; i++) {
+    mask[i] = static_cast<uint8_t>(((i % 16) & ~3) + order[i % 4]);
+  }
+  __m256i shuffleMask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask));
+  for (; column + 8 <= width; column += 8) {
+    __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + (column * 4)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + (column * 4)), _mm256_shuffle_epi8(pixels, shuffleMask));
+  }
+#elif defined(__SSSE3__)
+  //4 pixels at a time
+  uint8_t mask[16];
+  for (size_t i = 0; i < 16; i++) {
+    mask[i] = static_cast<uint8_t>((i & ~3) + order[i % 4]);
+  }
+  __m128i shuffleMask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask));
+  for (; column + 4 <= width; column += 4) {
+    __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (column * 4)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + (column * 4)), _mm_shuffle_epi8(pixels, shuffleMask));
+  }
+#endif
+  //Remaining pixels
+  for (; column < width; column++) {
+    const uint8_t* srcPixel = src + (column * 4);
+    uint8_t pixel[4] = {srcPixel[order[0]], srcPixel[order[1]], srcPixel[order[2]], srcPixel[order[3]]};
+    uint8_t* dstPixel = dst + (column * 4);
+    dstPixel[0] = pixel[0];
+    dstPixel[1] = pixel[1];
+    dstPixel[2] = pixel[2];
+    dstPixel[3] = pixel[3];
+  }
+}
+
+/**
+ * @function expandPalette32
+ * @description replace each palette index of a row with its 4 bytes palette entry. src and dst can't overlap
+ * @param const uint8_t* src (one index per byte)
+ * @param uint8_t* dst
+ * @param size_t width in pixels
+ * @param const uint8_t* palette (256 entries of 4 bytes)
+**/
+
+void Swizzle::expandPalette32(const uint8_t* src, uint8_t* dst, size_t width, const uint8_t* palette) {
+  size_t column = 0;
+#if defined(__AVX2__)
+  //8 pixels at a time: indexes are widened to 32 bits and entries gathered from the palette
+  const int* entries = reinterpret_cast<const int*>(palette);
+  for (; column + 8 <= width; column += 8) {
+    __m256i indexes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + column)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + (column * 4)), _mm256_i32gather_epi32(entries, indexes, 4));
+  }
+#endif
+  //Remaining pixels
+  for (; column < width; column++) {
+    memcpy(dst + (column * 4), palette + (src[column] * 4), 4);
+  }
+}
+
+/**
+ * @function expandPalette24
+ * @description replace each palette index of a row with the first 3 bytes of its palette entry. src and dst can't overlap
+ * @param const uint8_t* src (one index per byte)
+ * @param uint8_t* dst
+ * @param size_t width in pixels
+ * @param const uint8_t* palette (256 entries of 4 bytes)
+**/
+
+void Swizzle::expandPalette24(const uint8_t* src, uint8_t* dst, size_t width, const uint8_t* palette) {
+  size_t column = 0;
+#if defined(__AVX2__)
+  //8 pixels at a time; the 4th byte of each entry is dropped in both lanes and the 12 bytes of each lane are stored
+  //with a 16 bytes store, so the loop stops while the last store still fits in the row
+  const int* entries = reinterpret_cast<const int*>(palette);
+  const __m256i packMask = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                            0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+  for (; column + 10 <= width; column += 8) {
+    __m256i indexes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + column)));
+    __m256i pixels = _mm256_shuffle_epi8(_mm256_i32gather_epi32(entries, indexes, 4), packMask);
+    uint8_t* dstPixel = dst + (column * 3);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dstPixel), _mm256_castsi256_si128(pixels));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dstPixel + 12), _mm256_extracti128_si256(pixels, 1));
+  }
+#endif
+  //Remaining pixels; whole entries are copied, the 4th byte is overwritten by the next pixel
+  for (; column + 1 < width; column++) {
+    memcpy(dst + (column * 3), palette + (src[column] * 4), 4);
+  }
+  if (column < width) {
+    memcpy(dst + (column * 3), palette + (src[column] * 4), 3);
+  }
+}
+
+/**
+ * @function getInstructionSet
+ * @description returns the name of the instruction set used by the kernels
+ * @returns const char*
+**/
+
+const char* Swizzle::getInstructionSet() {
+#if defined(__AVX2__)
+  return "AVX2";
+#elif defined(__SSSE3__)
+  return "SSSE3";
+#else
+  return "scalar";
+#endif
+}
+
+}
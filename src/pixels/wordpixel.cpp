@@ -25,6 +25,8 @@
 
 namespace bmp {
 
+static_assert(sizeof(WordPixel) == 2, "WordPixel must have the size of a raster pixel");
+
 /**
  * @function WordPixel
  * @description: WordPixel class constructor
@@ -32,27 +34,7 @@ namespace bmp {
 **/
 
 WordPixel::WordPixel(uint16_t value) {
-  this->value = value > 0 ? 1 : 0;
-}
-
-/**
- * @function setPixel
- * @description: Set pixel RGB value
- * @param uint16_t
-**/
-
-void WordPixel::setPixel(uint16_t value) {
-  this->value = value > 0 ? 1 : 0;
-}
-
-/**
- * @function getValue
- * @description returns color (1:0) value
- * @returns uint16_t
-**/
-
-uint16_t WordPixel::getValue() {
-  return value;
+  this->value = value;
 }
 
 }
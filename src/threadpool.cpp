@@ -0,0 +1,155 @@
+/**
+ *   libBMpp - threadpool.cpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+#include <threadpool.hpp>
+
+namespace bmp {
+
+/**
+ * @function ThreadPool
+ * @description ThreadPool class constructor; threads includes the calling thread, so threads - 1 workers are started
+ * @param size_t
+**/
+
+ThreadPool::ThreadPool(size_t threads) {
+  currentTask = nullptr;
+  taskCount = 0;
+  nextTask = 0;
+  pendingTasks = 0;
+  stopping = false;
+  for (size_t i = 1; i < threads; i++) {
+    workers.push_back(std::thread(&ThreadPool::work, this));
+  }
+}
+
+/**
+ * @function ~ThreadPool
+ * @description ThreadPool class destructor; stops and joins workers
+**/
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  taskCondition.notify_all();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+/**
+ * @function run
+ * @description run task(0) ... task(taskCount - 1) and wait for them to terminate
+ * @param size_t
+ * @param const std::function<void(size_t)>&
+**/
+
+void ThreadPool::run(size_t taskCount, const std::function<void(size_t)>& task) {
+
+  //Run on the calling thread if there's nothing to share or if the pool is busy
+  if (taskCount <= 1 || workers.empty() || !jobMutex.try_lock()) {
+    for (size_t i = 0; i < taskCount; i++) {
+      task(i);
+    }
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  currentTask = &task;
+  this->taskCount = taskCount;
+  nextTask = 0;
+  pendingTasks = taskCount;
+  taskCondition.notify_all();
+  //The calling thread works too
+  while (nextTask < this->taskCount) {
+    size_t taskIndex = nextTask++;
+    lock.unlock();
+    task(taskIndex);
+    lock.lock();
+    pendingTasks--;
+  }
+  doneCondition.wait(lock, [this] { return pendingTasks == 0; });
+  currentTask = nullptr;
+  this->taskCount = 0;
+  nextTask = 0;
+  lock.unlock();
+  jobMutex.unlock();
+
+}
+
+/**
+ * @function work
+ * @description worker thread loop
+**/
+
+void ThreadPool::work() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    taskCondition.wait(lock, [this] { return stopping || nextTask < taskCount; });
+    if (stopping) {
+      return;
+    }
+    size_t taskIndex = nextTask++;
+    const std::function<void(size_t)>* task = currentTask;
+    lock.unlock();
+    (*task)(taskIndex);
+    lock.lock();
+    if (--pendingTasks == 0) {
+      doneCondition.notify_all();
+    }
+  }
+}
+
+/**
+ * @function getThreadCount
+ * @description returns the amount of threads which run the tasks, calling thread included
+ * @returns size_t
+**/
+
+size_t ThreadPool::getThreadCount() {
+  return workers.size() + 1;
+}
+
+/**
+ * @function getDefault
+ * @description returns the pool shared by the library, with a thread for each hardware thread; it is started on first use
+ * @returns ThreadPool&
+**/
+
+ThreadPool& ThreadPool::getDefault() {
+  static ThreadPool defaultPool(getHardwareThreads());
+  return defaultPool;
+}
+
+/**
+ * @function getHardwareThreads
+ * @description returns the amount of hardware threads (at least 1)
+ * @returns size_t
+**/
+
+size_t ThreadPool::getHardwareThreads() {
+  size_t threads = std::thread::hardware_concurrency();
+  return threads > 0 ? threads : 1;
+}
+
+} // namespace bmp
@@ -0,0 +1,394 @@
+/**
+ *   libBMpp - benchmark.cpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+//This program measures decoding and encoding throughput (MB/s of raster data) for each bits per pixel
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <bmpmonochrome.hpp>
+#include <bmp8.hpp>
+#include <bmp16.hpp>
+#include <bmp24.hpp>
+#include <bmp32.hpp>
+#include <bmppyramid.hpp>
+#include <bmpview.hpp>
+#include <parser/bmpparser.hpp>
+#include <pixels/swizzle.hpp>
+
+#define PROGRAM_NAME "benchmark"
+#define USAGE PROGRAM_NAME " [width] [height] [iterations] [threads]\n\
+Creates a random image for each bits per pixel (1, 8, 16, 24, 32 and 32 with BI_BITFIELDS masks),\n\
+decodes it and encodes it 'iterations' times (24 bits images are also read through a BmpView). Default is 2048x2048, 10 iterations\n\
+Decoding and encoding use 'threads' threads (default 1, 0 for all the hardware threads)\n\
+"
+
+unsigned long long getTimeNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void printResult(const std::string& name, size_t rasterSize, size_t iterations, unsigned long long elapsed) {
+  double seconds = static_cast<double>(elapsed) / 1000000000.0;
+  double throughput = (static_cast<double>(rasterSize) * iterations) / seconds / 1000000.0;
+  std::cout << name << ": " << throughput << " MB/s (" << elapsed / iterations << "ns per image)" << std::endl;
+}
+
+template <typename B>
+bool benchmarkDecode(const std::string& name, std::vector<uint8_t>& bmpData, size_t iterations, size_t threads) {
+  B bmp;
+  bmp.setThreads(threads);
+  //Warm up
+  if (!bmp.decodeBmp(bmpData.data(), bmpData.size())) {
+    std::cout << name << ": could not decode bitmap" << std::endl;
+    return false;
+  }
+  unsigned long long tStart = getTimeNs();
+  for (size_t i = 0; i < iterations; i++) {
+    bmp.decodeBmp(bmpData.data(), bmpData.size());
+  }
+  unsigned long long tEnd = getTimeNs();
+  size_t dataOffset = bmpData[10] | (bmpData[11] << 8) | (bmpData[12] << 16) | (bmpData[13] << 24);
+  printResult(name, bmpData.size() - dataOffset, iterations, tEnd - tStart);
+  return true;
+}
+
+template <typename B>
+bool benchmarkEncode(const std::string& name, std::vector<uint8_t>& bmpData, size_t iterations, size_t threads) {
+  B bmp;
+  bmp.setThreads(threads);
+  if (!bmp.decodeBmp(bmpData.data(), bmpData.size())) {
+    std::cout << name << ": could not decode bitmap" << std::endl;
+    return false;
+  }
+  size_t dataSize;
+  unsigned long long tStart = getTimeNs();
+  for (size_t i = 0; i < iterations; i++) {
+    uint8_t* data = bmp.encodeBmp(dataSize);
+    delete[] data;
+  }
+  unsigned long long tEnd = getTimeNs();
+  size_t dataOffset = bmpData[10] | (bmpData[11] << 8) | (bmpData[12] << 16) | (bmpData[13] << 24);
+  printResult(name + " encode", bmpData.size() - dataOffset, iterations, tEnd - tStart);
+  return true;
+}
+
+//Reads every pixel through a BmpView, without decoding the bitmap
+bool benchmarkView(const std::string& name, std::vector<uint8_t>& bmpData, size_t iterations) {
+  bmp::BmpView view;
+  unsigned long long sum = 0;
+  unsigned long long tStart = getTimeNs();
+  for (size_t i = 0; i < iterations; i++) {
+    if (!view.setData(bmpData.data(), bmpData.size())) {
+      std::cout << name << ": could not view bitmap" << std::endl;
+      return false;
+    }
+    for (size_t row = 0; row < view.getHeight(); row++) {
+      for (size_t column = 0; column < view.getWidth(); column++) {
+        const bmp::RGBPixel* pixel = view.getRGBPixelAt(row, column);
+        sum += pixel->getRed() + pixel->getGreen() + pixel->getBlue();
+      }
+    }
+  }
+  unsigned long long tEnd = getTimeNs();
+  printResult(name + " (sum " + std::to_string(sum) + ")", view.getStride() * view.getHeight(), iterations, tEnd - tStart);
+  return true;
+}
+
+template <typename B>
+bool benchmarkDownscale(const std::string& name, std::vector<uint8_t>& bmpData, bmp::ScaleFactor factor, size_t iterations, size_t threads) {
+  B bmp;
+  bmp.setThreads(threads);
+  unsigned long long tStart = getTimeNs();
+  for (size_t i = 0; i < iterations; i++) {
+    if (!bmp.decodeScaled(bmpData.data(), bmpData.size(), factor)) {
+      std::cout << name << ": could not decode bitmap" << std::endl;
+      return false;
+    }
+  }
+  unsigned long long tEnd = getTimeNs();
+  printResult(name + " (" + std::to_string(bmp.getWidth()) + "x" + std::to_string(bmp.getHeight()) + ")", bmpData.size(), iterations, tEnd - tStart);
+  return true;
+}
+
+std::vector<uint8_t> encode(bmp::Bmp& bmp) {
+  size_t dataSize;
+  uint8_t* data = bmp.encodeBmp(dataSize);
+  std::vector<uint8_t> bmpData(data, data + dataSize);
+  delete[] data;
+  return bmpData;
+}
+
+//Converts a 32 bits BI_RGB bitmap to a BI_BITFIELDS one with RGBA byte order
+std::vector<uint8_t> toBitfields(const std::vector<uint8_t>& bmpData) {
+  const size_t masksSize = 16;
+  std::vector<uint8_t> outData(bmpData.size() + masksSize);
+  memcpy(outData.data(), bmpData.data(), 54);
+  const uint8_t masks[masksSize] = {0xFF, 0, 0, 0, 0, 0xFF, 0, 0, 0, 0, 0xFF, 0, 0, 0, 0, 0xFF};
+  memcpy(outData.data() + 54, masks, masksSize);
+  for (size_t i = 54; i < bmpData.size(); i += 4) {
+    uint8_t* dstPixel = outData.data() + i + masksSize;
+    dstPixel[0] = bmpData[i + 2];
+    dstPixel[1] = bmpData[i + 1];
+    dstPixel[2] = bmpData[i];
+    dstPixel[3] = bmpData[i + 3];
+  }
+  uint32_t fileSize = outData.size();
+  uint32_t dataOffset = 54 + masksSize;
+  for (size_t i = 0; i < 4; i++) {
+    outData[2 + i] = (fileSize >> (i * 8)) & 0xFF;
+    outData[10 + i] = (dataOffset >> (i * 8)) & 0xFF;
+  }
+  outData[30] = 3; //BI_BITFIELDS
+  return outData;
+}
+
+int main(int argc, char* argv[]) {
+
+  size_t width = 2048;
+  size_t height = 2048;
+  size_t iterations = 10;
+  size_t threads = 1;
+  if (argc >= 2 && std::string(argv[1]) == "-h") {
+    std::cout << USAGE << std::endl;
+    return 0;
+  }
+  if (argc >= 3) {
+    width = std::stoi(argv[1]);
+    height = std::stoi(argv[2]);
+  }
+  if (argc >= 4) {
+    iterations = std::stoi(argv[3]);
+  }
+  if (argc >= 5) {
+    threads = std::stoi(argv[4]);
+  }
+  if (width == 0 || height == 0 || iterations == 0) {
+    std::cout << USAGE << std::endl;
+    return 1;
+  }
+
+  std::cout << "Decoding and encoding " << width << "x" << height << " images, " << iterations << " iterations, " << threads << " threads; kernels: " << bmp::Swizzle::getInstructionSet() << std::endl;
+  int rc = 0;
+  std::vector<uint8_t> bmpData;
+  //1 bit
+  {
+    bmp::Bmpmonochrome bmp(width, height);
+    for (size_t i = 0; i < width * height; i++) {
+      bmp.setPixelAt(i, rand() % 2);
+    }
+    bmpData = encode(bmp);
+  }
+  rc |= !benchmarkDecode<bmp::Bmpmonochrome>("1 bit", bmpData, iterations, threads);
+  rc |= !benchmarkEncode<bmp::Bmpmonochrome>("1 bit", bmpData, iterations, threads);
+  //8 bits
+  {
+    bmp::Bmp8 bmp(width, height);
+    for (size_t i = 0; i < width * height; i++) {
+      bmp.setPixelAt(i, rand() % 256);
+    }
+    bmpData = encode(bmp);
+  }
+  rc |= !benchmarkDecode<bmp::Bmp8>("8 bits", bmpData, iterations, threads);
+  rc |= !benchmarkEncode<bmp::Bmp8>("8 bits", bmpData, iterations, threads);
+  //8 bits palette expansion
+  {
+    bmp::Bmp8 bmp;
+    bmp.decodeBmp(bmpData.data(), bmpData.size());
+    bmp.setThreads(threads);
+    unsigned long long tStart = getTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+      delete bmp.toBmp24();
+    }
+    unsigned long long tEnd = getTimeNs();
+    printResult("8 bits to 24 bits", width * height, iterations, tEnd - tStart);
+  }
+  //8 bits with runs (e.g. a screenshot), RLE8 encoded
+  {
+    bmp::Bmp8 bmp(width, height);
+    for (size_t i = 0; i < width * height; i += 1 + rand() % 64) {
+      bmp.setPixelAt(i, rand() % 256);
+    }
+    bmp.setCompression(bmp::Compression::AUTO);
+    bmpData = encode(bmp);
+    size_t dataSize;
+    unsigned long long tStart = getTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+      uint8_t* data = bmp.encodeBmp(dataSize);
+      delete[] data;
+    }
+    unsigned long long tEnd = getTimeNs();
+    printResult("8 bits RLE8 encode (" + std::to_string(dataSize) + " bytes)", width * height, iterations, tEnd - tStart);
+  }
+  rc |= !benchmarkDecode<bmp::Bmp8>("8 bits RLE8", bmpData, iterations, threads);
+  //16 bits
+  {
+    bmp::Bmp16 bmp(width, height);
+    for (size_t i = 0; i < width * height; i++) {
+      bmp.setPixelAt(i, rand() % 65536);
+    }
+    bmpData = encode(bmp);
+  }
+  rc |= !benchmarkDecode<bmp::Bmp16>("16 bits", bmpData, iterations, threads);
+  rc |= !benchmarkEncode<bmp::Bmp16>("16 bits", bmpData, iterations, threads);
+  //24 bits
+  {
+    bmp::Bmp24 bmp(width, height);
+    for (size_t i = 0; i < width * height; i++) {
+      bmp.setPixelAt(i, rand() % 256, rand() % 256, rand() % 256);
+    }
+    bmpData = encode(bmp);
+  }
+  rc |= !benchmarkDecode<bmp::Bmp24>("24 bits", bmpData, iterations, threads);
+  rc |= !benchmarkEncode<bmp::Bmp24>("24 bits", bmpData, iterations, threads);
+  rc |= !benchmarkView("24 bits view", bmpData, iterations);
+  rc |= !benchmarkDownscale<bmp::Bmp24>("24 bits decode 1/4", bmpData, bmp::ScaleFactor::QUARTER, iterations, threads);
+  //Rotation
+  {
+    bmp::Bmp24 bmp;
+    bmp.decodeBmp(bmpData.data(), bmpData.size());
+    bmp.setThreads(threads);
+    unsigned long long tStart = getTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+      bmp.rotate(90);
+    }
+    unsigned long long tEnd = getTimeNs();
+    printResult("24 bits rotate 90", bmpData.size(), iterations, tEnd - tStart);
+  }
+  //Bilinear resizing, alternating half and full size
+  {
+    bmp::Bmp24 bmp;
+    bmp.decodeBmp(bmpData.data(), bmpData.size());
+    bmp.setThreads(threads);
+    unsigned long long tStart = getTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+      if (i % 2 == 0) {
+        bmp.resizeImage(width / 2, height / 2);
+      } else {
+        bmp.resizeImage(width, height);
+      }
+    }
+    unsigned long long tEnd = getTimeNs();
+    printResult("24 bits resize 1/2 - 2x", bmpData.size(), iterations, tEnd - tStart);
+  }
+  //Thumbnail with Lanczos filter
+  {
+    bmp::Bmp24 bmp;
+    bmp.decodeBmp(bmpData.data(), bmpData.size());
+    bmp.setThreads(threads);
+    unsigned long long tStart = getTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+      bmp::Bmp24 thumbnail(bmp);
+      thumbnail.resizeImage(width / 10, height / 10, bmp::Filter::LANCZOS3);
+    }
+    unsigned long long tEnd = getTimeNs();
+    printResult("24 bits resize 1/10 Lanczos 3", bmpData.size(), iterations, tEnd - tStart);
+  }
+  //Several renditions from one pass over the source
+  {
+    bmp::Bmp24 bmp;
+    bmp.decodeBmp(bmpData.data(), bmpData.size());
+    bmp.setThreads(threads);
+    std::vector<bmp::ImageSize> sizes = {{width / 2, height / 2}, {width / 3, height / 3}, {width / 4, height / 4}, {width / 6, height / 6}, {width / 8, height / 8}, {width / 16, height / 16}};
+    unsigned long long tStart = getTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+      std::vector<bmp::Bmp24> renditions;
+      bmp.resizeMany(sizes, renditions);
+    }
+    unsigned long long tEnd = getTimeNs();
+    printResult("24 bits resize many (6 sizes)", bmpData.size(), iterations, tEnd - tStart);
+  }
+  //Grey scale
+  {
+    bmp::Bmp24 bmp;
+    bmp.decodeBmp(bmpData.data(), bmpData.size());
+    bmp.setThreads(threads);
+    unsigned long long tStart = getTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+      bmp::Bmp24 grey(bmp);
+      grey.toGreyScale(16, bmp::GreyWeights::BT709);
+    }
+    unsigned long long tEnd = getTimeNs();
+    printResult("24 bits toGreyScale BT.709", bmpData.size(), iterations, tEnd - tStart);
+    tStart = getTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+      delete bmp.toGreyBmp8(255, bmp::GreyWeights::BT709);
+    }
+    tEnd = getTimeNs();
+    printResult("24 bits toGreyBmp8 BT.709", bmpData.size(), iterations, tEnd - tStart);
+  }
+  //Pyramid down to 1x1
+  {
+    bmp::Bmp24 bmp;
+    bmp.decodeBmp(bmpData.data(), bmpData.size());
+    bmp.setThreads(threads);
+    unsigned long long tStart = getTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+      bmp::BmpPyramid pyramid;
+      bmp.buildPyramid(32, pyramid);
+    }
+    unsigned long long tEnd = getTimeNs();
+    printResult("24 bits pyramid", bmpData.size(), iterations, tEnd - tStart);
+  }
+  //32 bits
+  {
+    bmp::Bmp32 bmp(width, height);
+    for (size_t i = 0; i < width * height; i++) {
+      bmp.setPixelAt(i, rand() % 256, rand() % 256, rand() % 256, rand() % 256);
+    }
+    bmpData = encode(bmp);
+  }
+  rc |= !benchmarkDecode<bmp::Bmp32>("32 bits", bmpData, iterations, threads);
+  rc |= !benchmarkEncode<bmp::Bmp32>("32 bits", bmpData, iterations, threads);
+  bmpData = toBitfields(bmpData);
+  rc |= !benchmarkDecode<bmp::Bmp32>("32 bits (BI_BITFIELDS, RGBA)", bmpData, iterations, threads);
+  //Reference: copying the same amount of data
+  {
+    std::vector<uint8_t> dstData(bmpData.size());
+    unsigned long long tStart = getTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+      memcpy(dstData.data(), bmpData.data(), bmpData.size());
+    }
+    unsigned long long tEnd = getTimeNs();
+    printResult("memcpy (reference)", bmpData.size(), iterations, tEnd - tStart);
+  }
+  //Header only
+  {
+    bmp::BmpParser parser;
+    bmp::Header header;
+    const size_t probes = iterations * 100000;
+    unsigned long long tStart = getTimeNs();
+    for (size_t i = 0; i < probes; i++) {
+      if (!parser.probe(bmpData.data(), bmpData.size(), header)) {
+        std::cout << "probe: could not decode header" << std::endl;
+        return 1;
+      }
+    }
+    unsigned long long tEnd = getTimeNs();
+    std::cout << "probe: " << (tEnd - tStart) / probes << "ns per bitmap" << std::endl;
+  }
+  return rc;
+}
@@ -21,6 +21,7 @@
  * SOFTWARE.
 **/
 
+#include <bmp8.hpp>
 #include <bmp24.hpp>
 
 #include <fstream>
@@ -50,9 +51,10 @@ int main(int argc, char* argv[]) {
     std::cout << "3: flip('H')" << std::endl;
     std::cout << "4: resizeArea(arg1, arg2, arg3, arg4)" << std::endl;
     std::cout << "5: resizeImage(arg1, arg2)" << std::endl;
-    std::cout << "6: toGreyScale(arg1)" << std::endl;
+    std::cout << "6: toGreyScale(arg1, arg2) (arg2: 0 average, 1 BT.601, 2 BT.709)" << std::endl;
     std::cout << "7: toSepiaTone()" << std::endl;
     std::cout << "8: invert()" << std::endl;
+    std::cout << "9: toGreyBmp8(arg1, arg2) (writes an 8 bits bitmap)" << std::endl;
     return 1;
   }
 
@@ -133,8 +135,9 @@ int main(int argc, char* argv[]) {
   }
   case 6: {
     int commandArg = std::stoi(commandArgs.at(0));
-    std::cout << "Applying: toGreyScale(" << commandArg << ")\n";
-    myBmp->toGreyScale(commandArg);
+    int weights = commandArgs.size() >= 2 ? std::stoi(commandArgs.at(1)) : 0;
+    std::cout << "Applying: toGreyScale(" << commandArg << "," << weights << ")\n";
+    myBmp->toGreyScale(commandArg, static_cast<bmp::GreyWeights>(weights));
     break;
   }
   case 7: {
@@ -147,11 +150,24 @@ int main(int argc, char* argv[]) {
     myBmp->invert();
     break;
   }
+  case 9: {
+    int commandArg = std::stoi(commandArgs.at(0));
+    int weights = commandArgs.size() >= 2 ? std::stoi(commandArgs.at(1)) : 0;
+    std::cout << "Applying: toGreyBmp8(" << commandArg << "," << weights << ")\n";
+    bmp::Bmp8* greyBmp = myBmp->toGreyBmp8(commandArg, static_cast<bmp::GreyWeights>(weights));
+    if (greyBmp == nullptr || !greyBmp->writeBmp(outFilename)) {
+      std::cout << "Could not write bmp to file " << outFilename << std::endl;
+    }
+    delete greyBmp;
+    delete myBmp;
+    myBmp = nullptr;
+    break;
+  }
   default:
     break;
   }
 
-  if(!myBmp->writeBmp(outFilename)) {
+  if(myBmp != nullptr && !myBmp->writeBmp(outFilename)) {
     std::cout << "Could not write bmp to file " << outFilename << std::endl; 
   }
   delete myBmp;
@@ -165,9 +181,10 @@ int main(int argc, char* argv[]) {
   std::cout << "3: flip('H')" << std::endl;
   std::cout << "4: resizeArea(arg1, arg2)" << std::endl;
   std::cout << "5: resizeImage(arg1, arg2)" << std::endl;
-  std::cout << "6: toGreyScale(arg1)" << std::endl;
+  std::cout << "6: toGreyScale(arg1, arg2) (arg2: 0 average, 1 BT.601, 2 BT.709)" << std::endl;
   std::cout << "7: toSepiaTone()" << std::endl;
   std::cout << "8: invert()" << std::endl;
+  std::cout << "9: toGreyBmp8(arg1, arg2) (writes an 8 bits bitmap)" << std::endl;
   std::cout << "bmpFile (QUIT to exit): ";
   std::cin >> bmpFilename;
   if (bmpFilename == "QUIT") {
@@ -22,6 +22,7 @@
 **/
 
 #include <bmp8.hpp>
+#include <bmp24.hpp>
 
 #include <fstream>
 #include <iostream>
@@ -49,6 +50,13 @@ int main(int argc, char* argv[]) {
     std::cout << "2: flip('V')" << std::endl;
     std::cout << "3: flip('H')" << std::endl;
     std::cout << "4: resizeArea(arg1, arg2)" << std::endl;
+    std::cout << "5: setCompression(arg1) (0: NONE, 1: RLE8, 2: AUTO)" << std::endl;
+    std::cout << "6: toBmp24() (writes the colors as a 24 bits bitmap)" << std::endl;
+    std::cout << "7: toGreyScale(arg1)" << std::endl;
+    std::cout << "8: toSepiaTone()" << std::endl;
+    std::cout << "9: invert()" << std::endl;
+    std::cout << "10: applyGamma(arg1)" << std::endl;
+    std::cout << "11: swapPaletteEntries(arg1, arg2)" << std::endl;
     return 1;
   }
 
@@ -76,6 +84,7 @@ int main(int argc, char* argv[]) {
 
   //Print RGB for each pixel
 
+  bmp::Bmp24* convertedBmp = nullptr;
   switch (command) {
   case 0: {
     size_t width = myBmp->getWidth();
@@ -119,14 +128,58 @@ int main(int argc, char* argv[]) {
     myBmp->resizeArea(width, height, xOffset, yOffset);
     break;
   }
+  case 5: {
+    int commandArg = std::stoi(commandArgs.at(0));
+    std::cout << "Applying: setCompression(" << commandArg << ")\n";
+    myBmp->setCompression(commandArg == 1 ? bmp::Compression::RLE8 : (commandArg == 2 ? bmp::Compression::AUTO : bmp::Compression::NONE));
+    break;
+  }
+  case 6:
+    std::cout << "Applying: toBmp24()\n";
+    convertedBmp = myBmp->toBmp24();
+    break;
+  case 7: {
+    int commandArg = std::stoi(commandArgs.at(0));
+    std::cout << "Applying: toGreyScale(" << commandArg << ")\n";
+    myBmp->toGreyScale(commandArg);
+    break;
+  }
+  case 8: {
+    std::cout << "Applying: toSepiaTone()\n";
+    myBmp->toSepiaTone();
+    break;
+  }
+  case 9: {
+    std::cout << "Applying: invert()\n";
+    myBmp->invert();
+    break;
+  }
+  case 10: {
+    double commandArg = std::stod(commandArgs.at(0));
+    std::cout << "Applying: applyGamma(" << commandArg << ")\n";
+    myBmp->applyGamma(commandArg);
+    break;
+  }
+  case 11: {
+    int first = std::stoi(commandArgs.at(0));
+    int second = std::stoi(commandArgs.at(1));
+    std::cout << "Applying: swapPaletteEntries(" << first << "," << second << ")\n";
+    myBmp->swapPaletteEntries(first, second);
+    break;
+  }
   default:
     break;
   }
 
   //re-Encode BMP
-  if(!myBmp->writeBmp(outFilename)) {
+  bmp::Bmp* outBmp = myBmp;
+  if (convertedBmp != nullptr) {
+    outBmp = convertedBmp;
+  }
+  if(!outBmp->writeBmp(outFilename)) {
     std::cout << "Could not write bmp to file " << outFilename << std::endl; 
   }
+  delete convertedBmp;
   delete myBmp;
 
   //Ask for next commands
@@ -137,6 +190,13 @@ int main(int argc, char* argv[]) {
   std::cout << "2: flip('V')" << std::endl;
   std::cout << "3: flip('H')" << std::endl;
   std::cout << "4: resizeArea(arg1, arg2, [arg3], [arg4])" << std::endl;
+  std::cout << "5: setCompression(arg1) (0: NONE, 1: RLE8, 2: AUTO)" << std::endl;
+  std::cout << "6: toBmp24() (writes the colors as a 24 bits bitmap)" << std::endl;
+  std::cout << "7: toGreyScale(arg1)" << std::endl;
+  std::cout << "8: toSepiaTone()" << std::endl;
+  std::cout << "9: invert()" << std::endl;
+  std::cout << "10: applyGamma(arg1)" << std::endl;
+  std::cout << "11: swapPaletteEntries(arg1, arg2)" << std::endl;
   std::cout << "bmpFile (QUIT to exit): ";
   std::cin >> bmpFilename;
   if (bmpFilename == "QUIT") {
@@ -83,12 +83,12 @@ int main(int argc, char* argv[]) {
     size_t height = myBmp->getHeight();
     for (size_t i = 0; i < height; i++) {
       for (size_t j = 0; j < width; j++) {
-        bmp::BWPixel* currPixel = myBmp->getPixelAt(i, j);
-        if (currPixel == nullptr) {
+        bmp::BWPixel currPixel(0);
+        if (!myBmp->getPixelAt(i, j, currPixel)) {
           std::cout << "Out of range\n";
           continue;
         }
-        std::cout << "Pixel[" << i << "," << j << "]: (" << std::to_string(currPixel->getValue()) << ");" << std::endl;
+        std::cout << "Pixel[" << i << "," << j << "]: (" << std::to_string(currPixel.getValue()) << ");" << std::endl;
       }
     }
     break;
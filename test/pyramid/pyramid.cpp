@@ -0,0 +1,90 @@
+/**
+ *   libBMpp - pyramid.cpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+//This program builds the image pyramid of a bitmap file and writes every level to a file
+
+#include <iostream>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <bmppyramid.hpp>
+#include <parser/bmpparser.hpp>
+
+#define PROGRAM_NAME "pyramid"
+#define USAGE PROGRAM_NAME " <bmpFile> <outPrefix> <levels>\n\
+Builds up to levels levels of the pyramid of bmpFile and writes level n to outPrefix_n.bmp\n\
+"
+
+unsigned long long getTimeUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char* argv[]) {
+
+  if (argc < 4) {
+    std::cout << USAGE << std::endl;
+    return 1;
+  }
+  std::string bmpFile = argv[1];
+  std::string outPrefix = argv[2];
+  size_t levels = std::stoul(argv[3]);
+
+  bmp::BmpParser parser;
+  bmp::Header header;
+  if (!parser.probe(bmpFile, header)) {
+    std::cout << "Could not read the header of " << bmpFile << std::endl;
+    return 1;
+  }
+  std::cout << "Bitmap size(width: " << header.width << "; height: " << header.height << "; bpp: " << header.bitsPerPixel << ")" << std::endl;
+  std::ifstream inFile(bmpFile, std::ios::binary);
+  std::vector<uint8_t> bmpData((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+  size_t bitsPerPixel;
+  bmp::Bmp* image = parser.getBmp(bmpData.data(), bmpData.size(), bitsPerPixel);
+  if (image == nullptr) {
+    std::cout << "Could not decode " << bmpFile << std::endl;
+    return 1;
+  }
+  bmp::BmpPyramid pyramid;
+  unsigned long long tStart = getTimeUs();
+  bool rc = image->buildPyramid(levels, pyramid);
+  unsigned long long tEnd = getTimeUs();
+  delete image;
+  if (!rc) {
+    std::cout << "Could not build the pyramid of " << bmpFile << " (bpp: " << header.bitsPerPixel << ")" << std::endl;
+    return 1;
+  }
+  std::cout << "Built " << pyramid.getLevels() << " levels in " << tEnd - tStart << "us" << std::endl;
+  for (size_t level = 0; level < pyramid.getLevels(); level++) {
+    std::string outBmpFile = outPrefix + "_" + std::to_string(level) + ".bmp";
+    bmp::BmpView view = pyramid.getView(level);
+    if (!pyramid.writeLevel(level, outBmpFile)) {
+      std::cout << "Could not write " << outBmpFile << std::endl;
+      return 1;
+    }
+    std::cout << "Written " << outBmpFile << " (" << view.getWidth() << "x" << view.getHeight() << ")" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,79 @@
+/**
+ *   libBMpp - region.cpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+//This program decodes only an area of a bitmap file, reading just the rows of the area,
+//and writes it to another file
+
+#include <iostream>
+#include <chrono>
+#include <string>
+
+#include <parser/bmpparser.hpp>
+
+#define PROGRAM_NAME "region"
+#define USAGE PROGRAM_NAME " <bmpFile> <xOffset> <yOffset> <width> <height> <outBmpFile>\n\
+Decodes the area of bmpFile of size width x height starting from xOffset, yOffset (top left corner) and writes it to outBmpFile\n\
+"
+
+unsigned long long getTimeUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char* argv[]) {
+
+  if (argc < 7) {
+    std::cout << USAGE << std::endl;
+    return 1;
+  }
+  std::string bmpFile = argv[1];
+  size_t xOffset = std::stoul(argv[2]);
+  size_t yOffset = std::stoul(argv[3]);
+  size_t width = std::stoul(argv[4]);
+  size_t height = std::stoul(argv[5]);
+  std::string outBmpFile = argv[6];
+
+  bmp::BmpParser parser;
+  bmp::Header header;
+  if (!parser.probe(bmpFile, header)) {
+    std::cout << "Could not read the header of " << bmpFile << std::endl;
+    return 1;
+  }
+  std::cout << "Bitmap size(width: " << header.width << "; height: " << header.height << "; bpp: " << header.bitsPerPixel << ")" << std::endl;
+  size_t bitsPerPixel;
+  unsigned long long tStart = getTimeUs();
+  bmp::Bmp* region = parser.getRegion(bmpFile, xOffset, yOffset, width, height, bitsPerPixel);
+  unsigned long long tEnd = getTimeUs();
+  if (region == nullptr) {
+    std::cout << "Could not decode the area (is it inside the image?)" << std::endl;
+    return 1;
+  }
+  std::cout << "Decoded " << region->getWidth() << "x" << region->getHeight() << " (bpp: " << bitsPerPixel << ") in " << tEnd - tStart << "us" << std::endl;
+  bool rc = region->writeBmp(outBmpFile);
+  delete region;
+  if (!rc) {
+    std::cout << "Could not write " << outBmpFile << std::endl;
+    return 1;
+  }
+  std::cout << "Written " << outBmpFile << std::endl;
+  return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ *   libBMpp - stream.cpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+//This program reads a bitmap by rows (or bands of rows), printing a checksum of each band,
+//and optionally copies it to another file by rows. Memory usage only depends on the width of the image
+
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <bmprowreader.hpp>
+#include <bmprowwriter.hpp>
+
+#define PROGRAM_NAME "stream"
+#define USAGE PROGRAM_NAME " <bmpFile> [bandRows] [BOTTOM_UP|TOP_DOWN] [outBmpFile]\n\
+Reads bmpFile by bands of bandRows rows (default 1) top to bottom, or in file order if BOTTOM_UP is provided\n\
+If outBmpFile is provided, each band is written to outBmpFile\n\
+"
+
+unsigned long long getTimeMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char* argv[]) {
+
+  if (argc < 2) {
+    std::cout << USAGE << std::endl;
+    return 1;
+  }
+  std::string bmpFile = argv[1];
+  size_t bandRows = 1;
+  bmp::RowOrder order = bmp::RowOrder::TOP_DOWN;
+  if (argc >= 3) {
+    bandRows = std::stoi(argv[2]);
+  }
+  if (argc >= 4 && std::string(argv[3]) == "BOTTOM_UP") {
+    order = bmp::RowOrder::BOTTOM_UP;
+  }
+  std::string outBmpFile;
+  if (argc >= 5) {
+    outBmpFile = argv[4];
+  }
+  if (bandRows == 0) {
+    std::cout << USAGE << std::endl;
+    return 1;
+  }
+
+  bmp::BmpRowReader reader;
+  if (!reader.open(bmpFile, order)) {
+    std::cout << "Could not open " << bmpFile << " (only uncompressed bitmaps are supported)" << std::endl;
+    return 1;
+  }
+  std::cout << "Bitmap size(width: " << reader.getWidth() << "; height: " << reader.getHeight() << "; bpp: " << reader.getBitsPerPixel() << ")" << std::endl;
+  bmp::BmpRowWriter writer;
+  if (!outBmpFile.empty() && !writer.open(outBmpFile, reader.getWidth(), reader.getHeight(), reader.getBitsPerPixel(), order, reader.getPalette())) {
+    std::cout << "Could not open " << outBmpFile << std::endl;
+    return 1;
+  }
+  std::vector<uint8_t> band(reader.getRowSize() * bandRows);
+  unsigned long long tStart = getTimeMs();
+  unsigned long long totalChecksum = 0;
+  size_t rowsRead;
+  while ((rowsRead = reader.readRows(band.data(), bandRows)) > 0) {
+    unsigned long long checksum = 0;
+    for (size_t i = 0; i < rowsRead * reader.getRowSize(); i++) {
+      checksum += band[i];
+    }
+    std::cout << "Rows " << reader.getCurrentRow() - rowsRead << "-" << reader.getCurrentRow() - 1 << ": checksum " << checksum << std::endl;
+    totalChecksum += checksum;
+    if (!outBmpFile.empty() && writer.writeRows(band.data(), rowsRead) != rowsRead) {
+      std::cout << "Could not write rows to " << outBmpFile << std::endl;
+      return 1;
+    }
+  }
+  unsigned long long tEnd = getTimeMs();
+  if (reader.getCurrentRow() != reader.getHeight()) {
+    std::cout << "Could not read row " << reader.getCurrentRow() << std::endl;
+    return 1;
+  }
+  if (!outBmpFile.empty() && !writer.close()) {
+    std::cout << "Could not write " << outBmpFile << std::endl;
+    return 1;
+  }
+  std::cout << "Read " << reader.getHeight() << " rows in " << tEnd - tStart << "ms; checksum " << totalChecksum << "; buffer size " << band.size() << " bytes" << std::endl;
+  return 0;
+}
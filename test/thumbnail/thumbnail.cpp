@@ -0,0 +1,90 @@
+/**
+ *   libBMpp - thumbnail.cpp
+ *   Developed by Christian Visintin
+ * 
+ * MIT License
+ * Copyright (c) 2019 Christian Visintin
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+**/
+
+//This program decodes a bitmap file downscaled (without decoding it at its full size) and writes it to another file
+
+#include <iostream>
+#include <chrono>
+#include <string>
+
+#include <parser/bmpparser.hpp>
+
+#define PROGRAM_NAME "thumbnail"
+#define USAGE PROGRAM_NAME " <bmpFile> <outBmpFile> <2|4|8|WIDTHxHEIGHT>\n\
+Decodes bmpFile downscaled by 1/2, 1/4, 1/8 or to WIDTHxHEIGHT and writes it to outBmpFile\n\
+"
+
+unsigned long long getTimeUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char* argv[]) {
+
+  if (argc < 4) {
+    std::cout << USAGE << std::endl;
+    return 1;
+  }
+  std::string bmpFile = argv[1];
+  std::string outBmpFile = argv[2];
+  std::string size = argv[3];
+
+  bmp::BmpParser parser;
+  bmp::Header header;
+  if (!parser.probe(bmpFile, header)) {
+    std::cout << "Could not read the header of " << bmpFile << std::endl;
+    return 1;
+  }
+  std::cout << "Bitmap size(width: " << header.width << "; height: " << header.height << "; bpp: " << header.bitsPerPixel << ")" << std::endl;
+  size_t width;
+  size_t height;
+  size_t separator = size.find('x');
+  if (separator != std::string::npos) {
+    width = std::stoul(size.substr(0, separator));
+    height = std::stoul(size.substr(separator + 1));
+  } else {
+    size_t divisor = std::stoul(size);
+    if (divisor != 2 && divisor != 4 && divisor != 8) {
+      std::cout << USAGE << std::endl;
+      return 1;
+    }
+    width = (header.width + divisor - 1) / divisor;
+    height = (header.height + divisor - 1) / divisor;
+  }
+  size_t bitsPerPixel;
+  unsigned long long tStart = getTimeUs();
+  bmp::Bmp* thumbnail = parser.getScaled(bmpFile, width, height, bitsPerPixel);
+  unsigned long long tEnd = getTimeUs();
+  if (thumbnail == nullptr) {
+    std::cout << "Could not decode " << bmpFile << " downscaled to " << width << "x" << height << std::endl;
+    return 1;
+  }
+  std::cout << "Decoded " << thumbnail->getWidth() << "x" << thumbnail->getHeight() << " (bpp: " << bitsPerPixel << ") in " << tEnd - tStart << "us" << std::endl;
+  bool rc = thumbnail->writeBmp(outBmpFile);
+  delete thumbnail;
+  if (!rc) {
+    std::cout << "Could not write " << outBmpFile << std::endl;
+    return 1;
+  }
+  std::cout << "Written " << outBmpFile << std::endl;
+  return 0;
+}